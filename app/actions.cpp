@@ -52,6 +52,10 @@ namespace fs = std::filesystem;
 namespace {
 std::mutex cs;
 
+//! Streams set with Action::setOutput() for the current thread, nullptr for std::cout and std::cerr
+thread_local std::ostream* taskOut = nullptr;
+thread_local std::ostream* taskErr = nullptr;
+
 //! Helper class to set the timestamp of a file to that of another file
 class Timestamp {
  public:
@@ -122,6 +126,14 @@ std::string newFilePath(const std::string& path, const std::string& ext);
  */
 int dontOverwrite(const std::string& path);
 
+/*!
+  @brief Ask the user \em question on the terminal and return the answer.
+         The question bypasses output redirected with Action::setOutput(),
+         and questions from different threads are asked one at a time.
+         In server mode, the question is written to err() and answered no.
+ */
+std::string prompt(const std::string& question);
+
 /*!
   @brief Output a text with a given minimum number of chars, honoring
          multi-byte characters correctly. Replace code in the form
@@ -133,11 +145,30 @@ std::ostream& operator<<(std::ostream& os, const std::pair<std::string, int>& st
 
 //! Print image Structure information
 int printStructure(std::ostream& out, Exiv2::PrintStructureOption option, const std::string& path);
+
+//! Return the plain (untranslated) value of \em md, with SByte values shown as negative numbers
+std::string plainValue(const Exiv2::Metadatum& md);
+
+//! Append \em str to \em json as a quoted JSON string, invalid UTF-8 sequences are replaced with U+FFFD
+void appendJsonString(std::string& json, const std::string& str);
 }  // namespace
 
 // *****************************************************************************
 // class member definitions
 namespace Action {
+std::ostream& out() {
+  return taskOut ? *taskOut : std::cout;
+}
+
+std::ostream& err() {
+  return taskErr ? *taskErr : std::cerr;
+}
+
+void setOutput(std::ostream* os, std::ostream* es) {
+  taskOut = os;
+  taskErr = es;
+}
+
 TaskFactory& TaskFactory::instance() {
   static TaskFactory instance_;
   return instance_;
@@ -167,13 +198,12 @@ Task::UniquePtr TaskFactory::create(TaskType type) {
   return nullptr;
 }
 
-int setModeAndPrintStructure(Exiv2::PrintStructureOption option, const std::string& path, bool binary) {
-  int result = 0;
+void setModeAndPrintStructure(Exiv2::PrintStructureOption option, Exiv2::Image& image, bool binary) {
   if (binary && option == Exiv2::kpsIccProfile) {
     std::stringstream output(std::stringstream::out | std::stringstream::binary);
-    result = printStructure(output, option, path);
+    image.printStructure(output, option);
     std::string str = output.str();
-    if (result == 0 && !str.empty()) {
+    if (!str.empty()) {
       Exiv2::DataBuf iccProfile(str.size());
       Exiv2::DataBuf ascii(str.size() * 3 + 1);
       ascii.write_uint8(str.size() * 3, 0);
@@ -184,87 +214,104 @@ int setModeAndPrintStructure(Exiv2::PrintStructureOption option, const std::stri
         size_t length = code.size();
         for (size_t start = 0; start < length; start += chunk) {
           size_t count = (start + chunk) < length ? chunk : length - start;
-          std::cout << code.substr(start, count) << std::endl;
+          out() << code.substr(start, count) << std::endl;
         }
       }
     }
   } else {
     _setmode(fileno(stdout), O_BINARY);
-    result = printStructure(std::cout, option, path);
+    image.printStructure(out(), option);
   }
-
-  return result;
 }
 
 int Print::run(const std::string& path) {
   try {
     path_ = path;
+    if (!Exiv2::fileExists(path_)) {
+      err() << path_ << ": " << _("Failed to open the file\n");
+      return -1;
+    }
+
+    // Open the file once and decode its metadata at most once for all print modes
+    auto image = Exiv2::ImageFactory::open(path_);
+    bool metadataRead = false;
+    auto modes = Params::instance().printModes_;
+    if (modes.empty())
+      modes.push_back(Params::pmSummary);
+
     int rc = 0;
-    switch (Params::instance().printMode_) {
-      case Params::pmSummary:
-        rc = Params::instance().greps_.empty() ? printSummary() : printList();
-        break;
-      case Params::pmList:
-        rc = printList();
-        break;
-      case Params::pmComment:
-        rc = printComment();
-        break;
-      case Params::pmPreview:
-        rc = printPreviewList();
-        break;
-      case Params::pmStructure:
-        rc = printStructure(std::cout, Exiv2::kpsBasic, path_);
-        break;
-      case Params::pmRecursive:
-        rc = printStructure(std::cout, Exiv2::kpsRecursive, path_);
-        break;
-      case Params::pmXMP:
-        rc = setModeAndPrintStructure(Exiv2::kpsXMP, path_, binary());
-        break;
-      case Params::pmIccProfile:
-        rc = setModeAndPrintStructure(Exiv2::kpsIccProfile, path_, binary());
-        break;
+    for (auto&& mode : modes) {
+      const bool structure = mode == Params::pmStructure || mode == Params::pmRecursive || mode == Params::pmXMP ||
+                             mode == Params::pmIccProfile;
+      if (!structure && !metadataRead) {
+        image->readMetadata();
+        metadataRead = true;
+      }
+      int ret = 0;
+      switch (mode) {
+        case Params::pmSummary:
+          ret = printSummary(*image);
+          break;
+        case Params::pmList:
+          ret = printMetadata(image.get());
+          break;
+        case Params::pmComment:
+          ret = printComment(*image);
+          break;
+        case Params::pmPreview:
+          ret = printPreviewList(*image);
+          break;
+        case Params::pmJson:
+          ret = printJson(*image);
+          break;
+        case Params::pmStructure:
+          image->printStructure(out(), Exiv2::kpsBasic);
+          break;
+        case Params::pmRecursive:
+          image->printStructure(out(), Exiv2::kpsRecursive);
+          break;
+        case Params::pmXMP:
+          setModeAndPrintStructure(Exiv2::kpsXMP, *image, binary());
+          break;
+        case Params::pmIccProfile:
+          setModeAndPrintStructure(Exiv2::kpsIccProfile, *image, binary());
+          break;
+      }
+      if (rc == 0)
+        rc = ret;
     }
     return rc;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in print action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in print action for file " << path << ":\n" << e << "\n";
     return 1;
   } catch (const std::overflow_error& e) {
-    std::cerr << "std::overflow_error exception in print action for file " << path << ":\n" << e.what() << "\n";
+    err() << "std::overflow_error exception in print action for file " << path << ":\n" << e.what() << "\n";
     return 1;
   }
 }
 
-int Print::printSummary() {
-  if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
-    return -1;
-  }
-
-  auto image = Exiv2::ImageFactory::open(path_);
-  image->readMetadata();
-  Exiv2::ExifData& exifData = image->exifData();
+int Print::printSummary(Exiv2::Image& image) {
+  Exiv2::ExifData& exifData = image.exifData();
   align_ = 16;
 
   // Filename
   printLabel(_("File name"));
-  std::cout << path_ << std::endl;
+  out() << path_ << std::endl;
 
   // Filesize
   printLabel(_("File size"));
-  std::cout << fs::file_size(path_) << " " << _("Bytes") << std::endl;
+  out() << fs::file_size(path_) << " " << _("Bytes") << std::endl;
 
   // MIME type
   printLabel(_("MIME type"));
-  std::cout << image->mimeType() << std::endl;
+  out() << image.mimeType() << std::endl;
 
   // Image size
   printLabel(_("Image size"));
-  std::cout << image->pixelWidth() << " x " << image->pixelHeight() << std::endl;
+  out() << image.pixelWidth() << " x " << image.pixelHeight() << std::endl;
 
   if (exifData.empty()) {
-    std::cerr << path_ << ": " << _("No Exif data found in the file\n");
+    err() << path_ << ": " << _("No Exif data found in the file\n");
     return -3;
   }
 
@@ -273,16 +320,16 @@ int Print::printSummary() {
   Exiv2::ExifThumbC exifThumb(exifData);
   std::string thumbExt = exifThumb.extension();
   if (thumbExt.empty()) {
-    std::cout << _("None");
+    out() << _("None");
   } else {
     auto dataBuf = exifThumb.copy();
     if (dataBuf.empty()) {
-      std::cout << _("None");
+      out() << _("None");
     } else {
-      std::cout << exifThumb.mimeType() << ", " << dataBuf.size() << " " << _("Bytes");
+      out() << exifThumb.mimeType() << ", " << dataBuf.size() << " " << _("Bytes");
     }
   }
-  std::cout << std::endl;
+  out() << std::endl;
 
   printTag(exifData, Exiv2::make, _("Camera make"));
   printTag(exifData, Exiv2::model, _("Camera model"));
@@ -304,17 +351,17 @@ int Print::printSummary() {
   printTag(exifData, "Exif.Image.Copyright", _("Copyright"));
   printTag(exifData, "Exif.Photo.UserComment", _("Exif comment"));
 
-  std::cout << std::endl;
+  out() << std::endl;
 
   return 0;
 }  // Print::printSummary
 
 void Print::printLabel(const std::string& label) const {
-  std::cout << std::setfill(' ') << std::left;
+  out() << std::setfill(' ') << std::left;
   if (Params::instance().files_.size() > 1) {
-    std::cout << std::setw(20) << path_ << " ";
+    out() << std::setw(20) << path_ << " ";
   }
-  std::cout << std::pair(label, align_) << ": ";
+  out() << std::pair(label, align_) << ": ";
 }
 
 int Print::printTag(const Exiv2::ExifData& exifData, const std::string& key, const std::string& label) const {
@@ -325,11 +372,11 @@ int Print::printTag(const Exiv2::ExifData& exifData, const std::string& key, con
   Exiv2::ExifKey ek(key);
   auto md = exifData.findKey(ek);
   if (md != exifData.end()) {
-    md->write(std::cout, &exifData);
+    md->write(out(), &exifData);
     rc = 1;
   }
   if (!label.empty())
-    std::cout << std::endl;
+    out() << std::endl;
   return rc;
 }  // Print::printTag
 
@@ -341,38 +388,20 @@ int Print::printTag(const Exiv2::ExifData& exifData, const EasyAccessFct& easyAc
   }
   auto md = easyAccessFct(exifData);
   if (md != exifData.end()) {
-    md->write(std::cout, &exifData);
+    md->write(out(), &exifData);
     rc = 1;
   } else if (easyAccessFctFallback) {
     md = easyAccessFctFallback(exifData);
     if (md != exifData.end()) {
-      md->write(std::cout, &exifData);
+      md->write(out(), &exifData);
       rc = 1;
     }
   }
   if (!label.empty())
-    std::cout << std::endl;
+    out() << std::endl;
   return rc;
 }  // Print::printTag
 
-int Print::printList() {
-  if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
-    return -1;
-  }
-
-  auto image = Exiv2::ImageFactory::open(path_);
-  image->readMetadata();
-  // Set defaults for metadata types and data columns
-  if (Params::instance().printTags_ == MetadataId::invalid) {
-    Params::instance().printTags_ = MetadataId::exif | MetadataId::iptc | MetadataId::xmp;
-  }
-  if (Params::instance().printItems_ == 0) {
-    Params::instance().printItems_ = Params::prKey | Params::prType | Params::prCount | Params::prTrans;
-  }
-  return printMetadata(image.get());
-}  // Print::printList
-
 int Print::printMetadata(const Exiv2::Image* image) {
   bool ret = false;
   bool noExif = false;
@@ -408,11 +437,11 @@ int Print::printMetadata(const Exiv2::Image* image) {
   // With -v, inform about the absence of any (requested) type of metadata
   if (Params::instance().verbose_) {
     if (noExif)
-      std::cerr << path_ << ": " << _("No Exif data found in the file\n");
+      err() << path_ << ": " << _("No Exif data found in the file\n");
     if (noIptc)
-      std::cerr << path_ << ": " << _("No IPTC data found in the file\n");
+      err() << path_ << ": " << _("No IPTC data found in the file\n");
     if (noXmp)
-      std::cerr << path_ << ": " << _("No XMP data found in the file\n");
+      err() << path_ << ": " << _("No XMP data found in the file\n");
   }
 
   // With -g or -K, return -3 if no matching tags were found
@@ -424,28 +453,15 @@ int Print::printMetadata(const Exiv2::Image* image) {
 }  // Print::printMetadata
 
 bool Print::grepTag(const std::string& key) {
-  bool result = Params::instance().greps_.empty();
-  for (auto const& g : Params::instance().greps_) {
-    result = std::regex_search(key, g);
-    if (result) {
-      break;
-    }
-  }
-  return result;
+  return Params::instance().grepFilter_.empty() || Params::instance().grepFilter_.matches(key);
 }
 
 bool Print::keyTag(const std::string& key) {
-  bool result = Params::instance().keys_.empty();
-  for (auto&& k : Params::instance().keys_) {
-    if (result)
-      break;
-    result = key == k;
-  }
-  return result;
+  return Params::instance().keys_.empty() || Params::instance().keys_.matches(key);
 }
 
 static void binaryOutput(const std::ostringstream& os) {
-  std::cout << os.str();
+  out() << os.str();
 }
 
 bool Print::printMetadatum(const Exiv2::Metadatum& md, const Exiv2::Image* pImage) {
@@ -460,89 +476,79 @@ bool Print::printMetadatum(const Exiv2::Metadatum& md, const Exiv2::Image* pImag
 
   bool const manyFiles = Params::instance().files_.size() > 1;
   if (manyFiles) {
-    std::cout << std::setfill(' ') << std::left << std::setw(20) << path_ << "  ";
+    out() << std::setfill(' ') << std::left << std::setw(20) << path_ << "  ";
   }
 
   bool first = true;
   if (Params::instance().printItems_ & Params::prTag) {
     first = false;
-    std::cout << "0x" << std::setw(4) << std::setfill('0') << std::right << std::hex << md.tag();
+    out() << "0x" << std::setw(4) << std::setfill('0') << std::right << std::hex << md.tag();
   }
   if (Params::instance().printItems_ & Params::prSet) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << "set";
+    out() << "set";
   }
   if (Params::instance().printItems_ & Params::prGroup) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::setw(12) << std::setfill(' ') << std::left << md.groupName();
+    out() << std::setw(12) << std::setfill(' ') << std::left << md.groupName();
   }
   if (Params::instance().printItems_ & Params::prKey) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::setfill(' ') << std::left << std::setw(44) << md.key();
+    out() << std::setfill(' ') << std::left << std::setw(44) << md.key();
   }
   if (Params::instance().printItems_ & Params::prName) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::setw(27) << std::setfill(' ') << std::left << md.tagName();
+    out() << std::setw(27) << std::setfill(' ') << std::left << md.tagName();
   }
   if (Params::instance().printItems_ & Params::prLabel) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::setw(30) << std::setfill(' ') << std::left << md.tagLabel();
+    out() << std::setw(30) << std::setfill(' ') << std::left << md.tagLabel();
   }
   if (Params::instance().printItems_ & Params::prType) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::setw(9) << std::setfill(' ') << std::left;
+    out() << std::setw(9) << std::setfill(' ') << std::left;
     const char* tn = md.typeName();
     if (tn) {
-      std::cout << tn;
+      out() << tn;
     } else {
       std::ostringstream os;
       os << "0x" << std::setw(4) << std::setfill('0') << std::hex << md.typeId();
-      std::cout << os.str();
+      out() << os.str();
     }
   }
   if (Params::instance().printItems_ & Params::prCount) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::dec << std::setw(3) << std::setfill(' ') << std::right << md.count();
+    out() << std::dec << std::setw(3) << std::setfill(' ') << std::right << md.count();
   }
   if (Params::instance().printItems_ & Params::prSize) {
     if (!first)
-      std::cout << " ";
+      out() << " ";
     first = false;
-    std::cout << std::dec << std::setw(3) << std::setfill(' ') << std::right << md.size();
+    out() << std::dec << std::setw(3) << std::setfill(' ') << std::right << md.size();
   }
   if (Params::instance().printItems_ & Params::prValue && md.size() > 0) {
     if (!first)
-      std::cout << "  ";
+      out() << "  ";
     first = false;
-    std::ostringstream os;
-    // #1114 - show negative values for SByte
-    if (md.typeId() == Exiv2::signedByte) {
-      for (size_t c = 0; c < md.value().count(); c++) {
-        const auto value = md.value().toInt64(c);
-        os << (c ? " " : "") << std::dec << (value < 128 ? value : value - 256);
-      }
-    } else {
-      os << std::dec << md.value();
-    }
-    binaryOutput(os);
+    out() << plainValue(md);
   }
   if (Params::instance().printItems_ & Params::prTrans) {
     if (!first)
-      std::cout << "  ";
+      out() << "  ";
     first = false;
     std::ostringstream os;
     os << std::dec << md.print(&pImage->exifData());
@@ -550,53 +556,103 @@ bool Print::printMetadatum(const Exiv2::Metadatum& md, const Exiv2::Image* pImag
   }
   if (Params::instance().printItems_ & Params::prHex) {
     if (!first)
-      std::cout << std::endl;
+      out() << std::endl;
     if (md.size() > 0) {
       Exiv2::DataBuf buf(md.size());
       md.copy(buf.data(), pImage->byteOrder());
-      Exiv2::hexdump(std::cout, buf.c_data(), buf.size());
+      Exiv2::hexdump(out(), buf.c_data(), buf.size());
     }
   }
-  std::cout << std::endl;
+  out() << std::endl;
   return true;
 }  // Print::printMetadatum
 
-int Print::printComment() {
-  if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
-    return -1;
-  }
+int Print::printJson(const Exiv2::Image& image) {
+  // Write the output in large pieces, without column alignment and iostream formatting
+  constexpr size_t flushSize = 64 * 1024;
+  std::string json = "{\"file\":";
+  appendJsonString(json, path_);
+  json += ",\"metadata\":[";
+  bool ret = false;
+  // Interpreted values are only available from the print functions, which write to a stream. Use a single stream
+  // for all of them rather than the one which Metadatum::print() creates for each value, and reset the format which
+  // a print function may have changed.
+  std::ostringstream text;
+  std::ios textFormat(nullptr);
+  textFormat.copyfmt(text);
+  auto printJsonDatum = [&](const Exiv2::Metadatum& md) {
+    if (!grepTag(md.key()) || !keyTag(md.key()))
+      return;
+    if (Params::instance().unknown_ && md.tagName().substr(0, 2) == "0x")
+      return;
+    json += ret ? ",{\"key\":" : "{\"key\":";
+    ret = true;
+    appendJsonString(json, md.key());
+    json += ",\"type\":";
+    const char* tn = md.typeName();
+    if (tn) {
+      appendJsonString(json, tn);
+    } else {
+      char type[16];
+      snprintf(type, sizeof(type), "0x%04x", static_cast<unsigned int>(md.typeId()));
+      appendJsonString(json, type);
+    }
+    json += ",\"count\":";
+    json += std::to_string(md.count());
+    json += ",\"value\":";
+    appendJsonString(json, plainValue(md));
+    json += ",\"text\":";
+    text.str(std::string());
+    text.clear();
+    text.copyfmt(textFormat);
+    md.write(text, &image.exifData());
+    appendJsonString(json, text.str());
+    json += '}';
+    if (json.size() >= flushSize) {
+      out().write(json.data(), json.size());
+      json.clear();
+    }
+  };
+  for (auto&& md : image.exifData()) {
+    printJsonDatum(md);
+  }
+  for (auto&& md : image.iptcData()) {
+    printJsonDatum(md);
+  }
+  for (auto&& md : image.xmpData()) {
+    printJsonDatum(md);
+  }
+  json += "]}\n";
+  out().write(json.data(), json.size());
+
+  // With -g or -K, return 1 if no matching tags were found, like printMetadata()
+  if ((!Params::instance().greps_.empty() || !Params::instance().keys_.empty()) && !ret)
+    return 1;
+  return 0;
+}  // Print::printJson
 
-  auto image = Exiv2::ImageFactory::open(path_);
-  image->readMetadata();
+int Print::printComment(const Exiv2::Image& image) {
   if (Params::instance().verbose_) {
-    std::cout << _("JPEG comment") << ": ";
+    out() << _("JPEG comment") << ": ";
   }
-  std::cout << image->comment() << std::endl;
+  out() << image.comment() << std::endl;
   return 0;
 }  // Print::printComment
 
-int Print::printPreviewList() {
-  if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
-    return -1;
-  }
-
-  auto image = Exiv2::ImageFactory::open(path_);
-  image->readMetadata();
+int Print::printPreviewList(const Exiv2::Image& image) {
   bool const manyFiles = Params::instance().files_.size() > 1;
   int cnt = 0;
-  Exiv2::PreviewManager pm(*image);
+  Exiv2::PreviewManager pm(image);
   Exiv2::PreviewPropertiesList list = pm.getPreviewProperties();
   for (auto&& pos : list) {
     if (manyFiles) {
-      std::cout << std::setfill(' ') << std::left << std::setw(20) << path_ << "  ";
+      out() << std::setfill(' ') << std::left << std::setw(20) << path_ << "  ";
     }
-    std::cout << _("Preview") << " " << ++cnt << ": " << pos.mimeType_ << ", ";
+    out() << _("Preview") << " " << ++cnt << ": " << pos.mimeType_ << ", ";
     if (pos.width_ != 0 && pos.height_ != 0) {
-      std::cout << pos.width_ << "x" << pos.height_ << " " << _("pixels") << ", ";
+      out() << pos.width_ << "x" << pos.height_ << " " << _("pixels") << ", ";
     }
-    std::cout << pos.size_ << " " << _("bytes") << "\n";
+    out() << pos.size_ << " " << _("bytes") << "\n";
   }
   return 0;
 }  // Print::printPreviewList
@@ -608,7 +664,7 @@ Task::UniquePtr Print::clone() const {
 int Rename::run(const std::string& path) {
   try {
     if (!Exiv2::fileExists(path)) {
-      std::cerr << path << ": " << _("Failed to open the file\n");
+      err() << path << ": " << _("Failed to open the file\n");
       return -1;
     }
     Timestamp ts;
@@ -619,7 +675,7 @@ int Rename::run(const std::string& path) {
     image->readMetadata();
     Exiv2::ExifData& exifData = image->exifData();
     if (exifData.empty()) {
-      std::cerr << path << ": " << _("No Exif data found in the file\n");
+      err() << path << ": " << _("No Exif data found in the file\n");
       return -3;
     }
     Exiv2::ExifKey key("Exif.Photo.DateTimeOriginal");
@@ -629,18 +685,18 @@ int Rename::run(const std::string& path) {
       md = exifData.findKey(key);
     }
     if (md == exifData.end()) {
-      std::cerr << _("Neither tag") << " `Exif.Photo.DateTimeOriginal' " << _("nor") << " `Exif.Image.DateTime' "
-                << _("found in the file") << " " << path << "\n";
+      err() << _("Neither tag") << " `Exif.Photo.DateTimeOriginal' " << _("nor") << " `Exif.Image.DateTime' "
+            << _("found in the file") << " " << path << "\n";
       return 1;
     }
     std::string v = md->toString();
     if (v.length() == 0 || v[0] == ' ') {
-      std::cerr << _("Image file creation timestamp not set in the file") << " " << path << "\n";
+      err() << _("Image file creation timestamp not set in the file") << " " << path << "\n";
       return 1;
     }
     struct tm tm;
     if (str2Tm(v, &tm) != 0) {
-      std::cerr << _("Failed to parse timestamp") << " `" << v << "' " << _("in the file") << " " << path << "\n";
+      err() << _("Failed to parse timestamp") << " `" << v << "' " << _("in the file") << " " << path << "\n";
       return 1;
     }
     if (Params::instance().timestamp_ || Params::instance().timestampOnly_) {
@@ -650,7 +706,7 @@ int Rename::run(const std::string& path) {
     std::string newPath = path;
     if (Params::instance().timestampOnly_) {
       if (Params::instance().verbose_) {
-        std::cout << _("Updating timestamp to") << " " << v << std::endl;
+        out() << _("Updating timestamp to") << " " << v << std::endl;
       }
     } else {
       rc = renameFile(newPath, &tm);
@@ -663,7 +719,7 @@ int Rename::run(const std::string& path) {
     }
     return rc;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in rename action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in rename action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }
@@ -677,7 +733,7 @@ int Erase::run(const std::string& path) {
     path_ = path;
 
     if (!Exiv2::fileExists(path_)) {
-      std::cerr << path_ << ": " << _("Failed to open the file\n");
+      err() << path_ << ": " << _("Failed to open the file\n");
       return -1;
     }
     Timestamp ts;
@@ -707,7 +763,7 @@ int Erase::run(const std::string& path) {
       rc = eraseIccProfile(image.get());
     }
     if (0 == rc && Params::instance().target_ & Params::ctIptcRaw) {
-      rc = printStructure(std::cout, Exiv2::kpsIptcErase, path_);
+      rc = printStructure(out(), Exiv2::kpsIptcErase, path_);
     }
 
     if (0 == rc) {
@@ -718,7 +774,7 @@ int Erase::run(const std::string& path) {
 
     return rc;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in erase action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in erase action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }
@@ -731,14 +787,14 @@ int Erase::eraseThumbnail(Exiv2::Image* image) {
   }
   exifThumb.erase();
   if (Params::instance().verbose_) {
-    std::cout << _("Erasing thumbnail data") << std::endl;
+    out() << _("Erasing thumbnail data") << std::endl;
   }
   return 0;
 }
 
 int Erase::eraseExifData(Exiv2::Image* image) {
   if (Params::instance().verbose_ && image->exifData().count() > 0) {
-    std::cout << _("Erasing Exif data from the file") << std::endl;
+    out() << _("Erasing Exif data from the file") << std::endl;
   }
   image->clearExifData();
   return 0;
@@ -746,7 +802,7 @@ int Erase::eraseExifData(Exiv2::Image* image) {
 
 int Erase::eraseIptcData(Exiv2::Image* image) {
   if (Params::instance().verbose_ && image->iptcData().count() > 0) {
-    std::cout << _("Erasing IPTC data from the file") << std::endl;
+    out() << _("Erasing IPTC data from the file") << std::endl;
   }
   image->clearIptcData();
   return 0;
@@ -754,7 +810,7 @@ int Erase::eraseIptcData(Exiv2::Image* image) {
 
 int Erase::eraseComment(Exiv2::Image* image) {
   if (Params::instance().verbose_ && !image->comment().empty()) {
-    std::cout << _("Erasing JPEG comment from the file") << std::endl;
+    out() << _("Erasing JPEG comment from the file") << std::endl;
   }
   image->clearComment();
   return 0;
@@ -762,7 +818,7 @@ int Erase::eraseComment(Exiv2::Image* image) {
 
 int Erase::eraseXmpData(Exiv2::Image* image) {
   if (Params::instance().verbose_ && image->xmpData().count() > 0) {
-    std::cout << _("Erasing XMP data from the file") << std::endl;
+    out() << _("Erasing XMP data from the file") << std::endl;
   }
   image->clearXmpData();  // Quick fix for bug #612
   image->clearXmpPacket();
@@ -770,7 +826,7 @@ int Erase::eraseXmpData(Exiv2::Image* image) {
 }
 int Erase::eraseIccProfile(Exiv2::Image* image) {
   if (Params::instance().verbose_ && image->iccProfileDefined()) {
-    std::cout << _("Erasing ICC Profile data from the file") << std::endl;
+    out() << _("Erasing ICC Profile data from the file") << std::endl;
   }
   image->clearIccProfile();
   return 0;
@@ -816,32 +872,32 @@ int Extract::run(const std::string& path) {
     }
     return rc;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in extract action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in extract action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }
 
 int Extract::writeThumbnail() const {
   if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
+    err() << path_ << ": " << _("Failed to open the file\n");
     return -1;
   }
   auto image = Exiv2::ImageFactory::open(path_);
   image->readMetadata();
   Exiv2::ExifData& exifData = image->exifData();
   if (exifData.empty()) {
-    std::cerr << path_ << ": " << _("No Exif data found in the file\n");
+    err() << path_ << ": " << _("No Exif data found in the file\n");
     return -3;
   }
   int rc = 0;
   Exiv2::ExifThumb exifThumb(exifData);
   std::string thumbExt = exifThumb.extension();
   if (thumbExt.empty()) {
-    std::cerr << path_ << ": " << _("Image does not contain an Exif thumbnail\n");
+    err() << path_ << ": " << _("Image does not contain an Exif thumbnail\n");
   } else {
     if ((Params::instance().target_ & Params::ctStdInOut) != 0) {
       Exiv2::DataBuf buf = exifThumb.copy();
-      std::cout.write(buf.c_str(), buf.size());
+      out().write(buf.c_str(), buf.size());
       return 0;
     }
 
@@ -852,13 +908,13 @@ int Extract::writeThumbnail() const {
     if (Params::instance().verbose_) {
       Exiv2::DataBuf buf = exifThumb.copy();
       if (!buf.empty()) {
-        std::cout << _("Writing thumbnail") << " (" << exifThumb.mimeType() << ", " << buf.size() << " " << _("Bytes")
-                  << ") " << _("to file") << " " << thumbPath << std::endl;
+        out() << _("Writing thumbnail") << " (" << exifThumb.mimeType() << ", " << buf.size() << " " << _("Bytes")
+              << ") " << _("to file") << " " << thumbPath << std::endl;
       }
     }
     rc = static_cast<int>(exifThumb.writeFile(thumb));
     if (rc == 0) {
-      std::cerr << path_ << ": " << _("Exif data doesn't contain a thumbnail\n");
+      err() << path_ << ": " << _("Exif data doesn't contain a thumbnail\n");
     }
   }
   return rc;
@@ -866,7 +922,7 @@ int Extract::writeThumbnail() const {
 
 int Extract::writePreviews() const {
   if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
+    err() << path_ << ": " << _("Failed to open the file\n");
     return -1;
   }
 
@@ -888,7 +944,7 @@ int Extract::writePreviews() const {
     }
     num--;
     if (num >= pvList.size()) {
-      std::cerr << path_ << ": " << _("Image does not have preview") << " " << num + 1 << "\n";
+      err() << path_ << ": " << _("Image does not have preview") << " " << num + 1 << "\n";
       continue;
     }
     writePreviewFile(pvMgr.getPreviewImage(pvList[num]), num + 1);
@@ -899,7 +955,7 @@ int Extract::writePreviews() const {
 int Extract::writeIccProfile(const std::string& target) const {
   int rc = 0;
   if (!Exiv2::fileExists(path_)) {
-    std::cerr << path_ << ": " << _("Failed to open the file\n");
+    err() << path_ << ": " << _("Failed to open the file\n");
     rc = -1;
   }
 
@@ -909,14 +965,14 @@ int Extract::writeIccProfile(const std::string& target) const {
     auto image = Exiv2::ImageFactory::open(path_);
     image->readMetadata();
     if (!image->iccProfileDefined()) {
-      std::cerr << _("No embedded iccProfile: ") << path_ << std::endl;
+      err() << _("No embedded iccProfile: ") << path_ << std::endl;
       rc = -2;
     } else {
       if (bStdout) {  // -eC-
-        std::cout.write(image->iccProfile().c_str(), image->iccProfile().size());
+        out().write(image->iccProfile().c_str(), image->iccProfile().size());
       } else {
         if (Params::instance().verbose_) {
-          std::cout << _("Writing iccProfile: ") << target << std::endl;
+          out() << _("Writing iccProfile: ") << target << std::endl;
         }
         Exiv2::FileIo iccFile(target);
         iccFile.open("wb");
@@ -934,15 +990,15 @@ void Extract::writePreviewFile(const Exiv2::PreviewImage& pvImg, size_t num) con
   if (dontOverwrite(pvPath))
     return;
   if (Params::instance().verbose_) {
-    std::cout << _("Writing preview") << " " << num << " (" << pvImg.mimeType() << ", ";
+    out() << _("Writing preview") << " " << num << " (" << pvImg.mimeType() << ", ";
     if (pvImg.width() != 0 && pvImg.height() != 0) {
-      std::cout << pvImg.width() << "x" << pvImg.height() << " " << _("pixels") << ", ";
+      out() << pvImg.width() << "x" << pvImg.height() << " " << _("pixels") << ", ";
     }
-    std::cout << pvImg.size() << " " << _("bytes") << ") " << _("to file") << " " << pvPath << std::endl;
+    out() << pvImg.size() << " " << _("bytes") << ") " << _("to file") << " " << pvPath << std::endl;
   }
   auto rc = pvImg.writeFile(pvFile);
   if (rc == 0) {
-    std::cerr << path_ << ": " << _("Image does not have preview") << " " << num << "\n";
+    err() << path_ << ": " << _("Image does not have preview") << " " << num << "\n";
   }
 }
 
@@ -955,7 +1011,7 @@ int Insert::run(const std::string& path) try {
   bool bStdin = (Params::instance().target_ & Params::ctStdInOut) != 0;
 
   if (!Exiv2::fileExists(path)) {
-    std::cerr << path << ": " << _("Failed to open the file\n");
+    err() << path << ": " << _("Failed to open the file\n");
     return -1;
   }
 
@@ -994,7 +1050,7 @@ int Insert::run(const std::string& path) try {
     ts.touch(path);
   return rc;
 } catch (const Exiv2::Error& e) {
-  std::cerr << "Exiv2 exception in insert action for file " << path << ":\n" << e << "\n";
+  err() << "Exiv2 exception in insert action for file " << path << ":\n" << e << "\n";
   return 1;
 }  // Insert::run
 
@@ -1007,11 +1063,11 @@ int Insert::insertXmpPacket(const std::string& path, const std::string& xmpPath)
     rc = insertXmpPacket(path, xmpBlob, true);
   } else {
     if (!Exiv2::fileExists(xmpPath)) {
-      std::cerr << xmpPath << ": " << _("Failed to open the file\n");
+      err() << xmpPath << ": " << _("Failed to open the file\n");
       rc = -1;
     }
     if (rc == 0 && !Exiv2::fileExists(path)) {
-      std::cerr << path << ": " << _("Failed to open the file\n");
+      err() << path << ": " << _("Failed to open the file\n");
       rc = -1;
     }
     if (rc == 0) {
@@ -1048,7 +1104,7 @@ int Insert::insertIccProfile(const std::string& path, const std::string& iccPath
     rc = insertIccProfile(path, std::move(iccProfile));
   } else {
     if (!Exiv2::fileExists(iccProfilePath)) {
-      std::cerr << iccProfilePath << ": " << _("Failed to open the file\n");
+      err() << iccProfilePath << ": " << _("Failed to open the file\n");
       rc = -1;
     } else {
       Exiv2::DataBuf iccProfile = Exiv2::readFile(iccPath);
@@ -1062,7 +1118,7 @@ int Insert::insertIccProfile(const std::string& path, Exiv2::DataBuf&& iccProfil
   int rc = 0;
   // test path exists
   if (!Exiv2::fileExists(path)) {
-    std::cerr << path << ": " << _("Failed to open the file\n");
+    err() << path << ": " << _("Failed to open the file\n");
     rc = -1;
   }
 
@@ -1084,11 +1140,11 @@ int Insert::insertIccProfile(const std::string& path, Exiv2::DataBuf&& iccProfil
 int Insert::insertThumbnail(const std::string& path) {
   std::string thumbPath = newFilePath(path, "-thumb.jpg");
   if (!Exiv2::fileExists(thumbPath)) {
-    std::cerr << thumbPath << ": " << _("Failed to open the file\n");
+    err() << thumbPath << ": " << _("Failed to open the file\n");
     return -1;
   }
   if (!Exiv2::fileExists(path)) {
-    std::cerr << path << ": " << _("Failed to open the file\n");
+    err() << path << ": " << _("Failed to open the file\n");
     return -1;
   }
   auto image = Exiv2::ImageFactory::open(path);
@@ -1107,7 +1163,7 @@ Task::UniquePtr Insert::clone() const {
 int Modify::run(const std::string& path) {
   try {
     if (!Exiv2::fileExists(path)) {
-      std::cerr << path << ": " << _("Failed to open the file\n");
+      err() << path << ": " << _("Failed to open the file\n");
       return -1;
     }
     Timestamp ts;
@@ -1127,7 +1183,7 @@ int Modify::run(const std::string& path) {
 
     return rc;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in modify action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in modify action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }  // Modify::run
@@ -1137,7 +1193,7 @@ int Modify::applyCommands(Exiv2::Image* pImage) {
     // If modify is used when extracting to stdout then ignore verbose
     if (Params::instance().verbose_ &&
         !(Params::instance().action_ & Action::extract && Params::instance().target_ & Params::ctStdInOut)) {
-      std::cout << _("Setting JPEG comment") << " '" << Params::instance().jpegComment_ << "'" << std::endl;
+      out() << _("Setting JPEG comment") << " '" << Params::instance().jpegComment_ << "'" << std::endl;
     }
     pImage->setComment(Params::instance().jpegComment_);
   }
@@ -1175,8 +1231,8 @@ int Modify::addMetadatum(Exiv2::Image* pImage, const ModifyCmd& modifyCmd) {
   // If modify is used when extracting to stdout then ignore verbose
   if (Params::instance().verbose_ &&
       !(Params::instance().action_ & Action::extract && Params::instance().target_ & Params::ctStdInOut)) {
-    std::cout << _("Add") << " " << modifyCmd.key_ << " \"" << modifyCmd.value_ << "\" ("
-              << Exiv2::TypeInfo::typeName(modifyCmd.typeId_) << ")" << std::endl;
+    out() << _("Add") << " " << modifyCmd.key_ << " \"" << modifyCmd.value_ << "\" ("
+          << Exiv2::TypeInfo::typeName(modifyCmd.typeId_) << ")" << std::endl;
   }
   Exiv2::ExifData& exifData = pImage->exifData();
   Exiv2::IptcData& iptcData = pImage->iptcData();
@@ -1194,8 +1250,8 @@ int Modify::addMetadatum(Exiv2::Image* pImage, const ModifyCmd& modifyCmd) {
       xmpData.add(Exiv2::XmpKey(modifyCmd.key_), value.get());
     }
   } else {
-    std::cerr << _("Warning") << ": " << modifyCmd.key_ << ": " << _("Failed to read") << " "
-              << Exiv2::TypeInfo::typeName(value->typeId()) << " " << _("value") << " \"" << modifyCmd.value_ << "\"\n";
+    err() << _("Warning") << ": " << modifyCmd.key_ << ": " << _("Failed to read") << " "
+          << Exiv2::TypeInfo::typeName(value->typeId()) << " " << _("value") << " \"" << modifyCmd.value_ << "\"\n";
   }
   return rc;
 }
@@ -1206,8 +1262,8 @@ int Modify::setMetadatum(Exiv2::Image* pImage, const ModifyCmd& modifyCmd) {
   // If modify is used when extracting to stdout then ignore verbose
   if (Params::instance().verbose_ &&
       !(Params::instance().action_ & Action::extract && Params::instance().target_ & Params::ctStdInOut)) {
-    std::cout << _("Set") << " " << modifyCmd.key_ << " \"" << modifyCmd.value_ << "\" ("
-              << Exiv2::TypeInfo::typeName(modifyCmd.typeId_) << ")" << std::endl;
+    out() << _("Set") << " " << modifyCmd.key_ << " \"" << modifyCmd.value_ << "\" ("
+          << Exiv2::TypeInfo::typeName(modifyCmd.typeId_) << ")" << std::endl;
   }
   Exiv2::ExifData& exifData = pImage->exifData();
   Exiv2::IptcData& iptcData = pImage->iptcData();
@@ -1257,8 +1313,8 @@ int Modify::setMetadatum(Exiv2::Image* pImage, const ModifyCmd& modifyCmd) {
       }
     }
   } else {
-    std::cerr << _("Warning") << ": " << modifyCmd.key_ << ": " << _("Failed to read") << " "
-              << Exiv2::TypeInfo::typeName(value->typeId()) << " " << _("value") << " \"" << modifyCmd.value_ << "\"\n";
+    err() << _("Warning") << ": " << modifyCmd.key_ << ": " << _("Failed to read") << " "
+          << Exiv2::TypeInfo::typeName(value->typeId()) << " " << _("value") << " \"" << modifyCmd.value_ << "\"\n";
   }
   return rc;
 }
@@ -1267,7 +1323,7 @@ void Modify::delMetadatum(Exiv2::Image* pImage, const ModifyCmd& modifyCmd) {
   // If modify is used when extracting to stdout then ignore verbose
   if (Params::instance().verbose_ &&
       !(Params::instance().action_ & Action::extract && Params::instance().target_ & Params::ctStdInOut)) {
-    std::cout << _("Del") << " " << modifyCmd.key_ << std::endl;
+    out() << _("Del") << " " << modifyCmd.key_ << std::endl;
   }
 
   Exiv2::ExifData& exifData = pImage->exifData();
@@ -1300,7 +1356,7 @@ void Modify::regNamespace(const ModifyCmd& modifyCmd) {
   // If modify is used when extracting to stdout then ignore verbose
   if (Params::instance().verbose_ &&
       !(Params::instance().action_ & Action::extract && Params::instance().target_ & Params::ctStdInOut)) {
-    std::cout << _("Reg ") << modifyCmd.key_ << "=\"" << modifyCmd.value_ << "\"" << std::endl;
+    out() << _("Reg ") << modifyCmd.key_ << "=\"" << modifyCmd.value_ << "\"" << std::endl;
   }
   Exiv2::XmpProperties::registerNs(modifyCmd.value_, modifyCmd.key_);
 }
@@ -1316,7 +1372,7 @@ int Adjust::run(const std::string& path) try {
   dayAdjustment_ = Params::instance().yodAdjust_[Params::yodDay].adjustment_;
 
   if (!Exiv2::fileExists(path)) {
-    std::cerr << path << ": " << _("Failed to open the file\n");
+    err() << path << ": " << _("Failed to open the file\n");
     return -1;
   }
   Timestamp ts;
@@ -1327,7 +1383,7 @@ int Adjust::run(const std::string& path) try {
   image->readMetadata();
   Exiv2::ExifData& exifData = image->exifData();
   if (exifData.empty()) {
-    std::cerr << path << ": " << _("No Exif data found in the file\n");
+    err() << path << ": " << _("No Exif data found in the file\n");
     return -3;
   }
   int rc = adjustDateTime(exifData, "Exif.Image.DateTime", path);
@@ -1342,7 +1398,7 @@ int Adjust::run(const std::string& path) try {
   }
   return rc ? 1 : 0;
 } catch (const Exiv2::Error& e) {
-  std::cerr << "Exiv2 exception in adjust action for file " << path << ":\n" << e << "\n";
+  err() << "Exiv2 exception in adjust action for file " << path << ":\n" << e << "\n";
   return 1;
 }  // Adjust::run
 
@@ -1359,54 +1415,54 @@ int Adjust::adjustDateTime(Exiv2::ExifData& exifData, const std::string& key, co
   }
   std::string timeStr = md->toString();
   if (timeStr.empty() || timeStr[0] == ' ') {
-    std::cerr << path << ": " << _("Timestamp of metadatum with key") << " `" << ek << "' " << _("not set\n");
+    err() << path << ": " << _("Timestamp of metadatum with key") << " `" << ek << "' " << _("not set\n");
     return 1;
   }
   if (Params::instance().verbose_) {
     bool comma = false;
-    std::cout << _("Adjusting") << " `" << ek << "' " << _("by");
+    out() << _("Adjusting") << " `" << ek << "' " << _("by");
     if (yearAdjustment_ != 0) {
-      std::cout << (yearAdjustment_ < 0 ? " " : " +") << yearAdjustment_ << " ";
+      out() << (yearAdjustment_ < 0 ? " " : " +") << yearAdjustment_ << " ";
       if (yearAdjustment_ < -1 || yearAdjustment_ > 1) {
-        std::cout << _("years");
+        out() << _("years");
       } else {
-        std::cout << _("year");
+        out() << _("year");
       }
       comma = true;
     }
     if (monthAdjustment_ != 0) {
       if (comma)
-        std::cout << ",";
-      std::cout << (monthAdjustment_ < 0 ? " " : " +") << monthAdjustment_ << " ";
+        out() << ",";
+      out() << (monthAdjustment_ < 0 ? " " : " +") << monthAdjustment_ << " ";
       if (monthAdjustment_ < -1 || monthAdjustment_ > 1) {
-        std::cout << _("months");
+        out() << _("months");
       } else {
-        std::cout << _("month");
+        out() << _("month");
       }
       comma = true;
     }
     if (dayAdjustment_ != 0) {
       if (comma)
-        std::cout << ",";
-      std::cout << (dayAdjustment_ < 0 ? " " : " +") << dayAdjustment_ << " ";
+        out() << ",";
+      out() << (dayAdjustment_ < 0 ? " " : " +") << dayAdjustment_ << " ";
       if (dayAdjustment_ < -1 || dayAdjustment_ > 1) {
-        std::cout << _("days");
+        out() << _("days");
       } else {
-        std::cout << _("day");
+        out() << _("day");
       }
       comma = true;
     }
     if (adjustment_ != 0) {
       if (comma)
-        std::cout << ",";
-      std::cout << " " << adjustment_ << _("s");
+        out() << ",";
+      out() << " " << adjustment_ << _("s");
     }
   }
   struct tm tm;
   if (str2Tm(timeStr, &tm) != 0) {
     if (Params::instance().verbose_)
-      std::cout << std::endl;
-    std::cerr << path << ": " << _("Failed to parse timestamp") << " `" << timeStr << "'\n";
+      out() << std::endl;
+    err() << path << ": " << _("Failed to parse timestamp") << " `" << timeStr << "'\n";
     return 1;
   }
 
@@ -1443,16 +1499,16 @@ int Adjust::adjustDateTime(Exiv2::ExifData& exifData, const std::string& key, co
   // Let's not create files with non-4-digit years, we can't read them.
   if (tm.tm_year > 9999 - 1900 || tm.tm_year < 1000 - 1900) {
     if (Params::instance().verbose_)
-      std::cout << std::endl;
-    std::cerr << path << ": " << _("Can't adjust timestamp by") << " " << yearAdjustment + monOverflow << " "
-              << _("years") << "\n";
+      out() << std::endl;
+    err() << path << ": " << _("Can't adjust timestamp by") << " " << yearAdjustment + monOverflow << " " << _("years")
+          << "\n";
     return 1;
   }
   time_t time = mktime(&tm);
   time = Safe::add(time, Safe::add(adjustment, dayAdjustment * secondsInDay));
   timeStr = time2Str(time);
   if (Params::instance().verbose_) {
-    std::cout << " " << _("to") << " " << timeStr << std::endl;
+    out() << " " << _("to") << " " << timeStr << std::endl;
   }
   md->setValue(timeStr);
   return 0;
@@ -1461,7 +1517,7 @@ int Adjust::adjustDateTime(Exiv2::ExifData& exifData, const std::string& key, co
 int FixIso::run(const std::string& path) {
   try {
     if (!Exiv2::fileExists(path)) {
-      std::cerr << path << ": " << _("Failed to open the file\n");
+      err() << path << ": " << _("Failed to open the file\n");
       return -1;
     }
     Timestamp ts;
@@ -1472,14 +1528,14 @@ int FixIso::run(const std::string& path) {
     image->readMetadata();
     Exiv2::ExifData& exifData = image->exifData();
     if (exifData.empty()) {
-      std::cerr << path << ": " << _("No Exif data found in the file\n");
+      err() << path << ": " << _("No Exif data found in the file\n");
       return -3;
     }
     auto md = Exiv2::isoSpeed(exifData);
     if (md != exifData.end()) {
       if (strcmp(md->key().c_str(), "Exif.Photo.ISOSpeedRatings") == 0) {
         if (Params::instance().verbose_) {
-          std::cout << _("Standard Exif ISO tag exists; not modified\n");
+          out() << _("Standard Exif ISO tag exists; not modified\n");
         }
         return 0;
       }
@@ -1487,7 +1543,7 @@ int FixIso::run(const std::string& path) {
       std::ostringstream os;
       md->write(os, &exifData);
       if (Params::instance().verbose_) {
-        std::cout << _("Setting Exif ISO value to") << " " << os.str() << "\n";
+        out() << _("Setting Exif ISO value to") << " " << os.str() << "\n";
       }
       exifData["Exif.Photo.ISOSpeedRatings"] = os.str();
     }
@@ -1497,7 +1553,7 @@ int FixIso::run(const std::string& path) {
 
     return 0;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in fixiso action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in fixiso action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }  // FixIso::run
@@ -1509,7 +1565,7 @@ Task::UniquePtr FixIso::clone() const {
 int FixCom::run(const std::string& path) {
   try {
     if (!Exiv2::fileExists(path)) {
-      std::cerr << path << ": " << _("Failed to open the file\n");
+      err() << path << ": " << _("Failed to open the file\n");
       return -1;
     }
     Timestamp ts;
@@ -1520,13 +1576,13 @@ int FixCom::run(const std::string& path) {
     image->readMetadata();
     Exiv2::ExifData& exifData = image->exifData();
     if (exifData.empty()) {
-      std::cerr << path << ": " << _("No Exif data found in the file\n");
+      err() << path << ": " << _("No Exif data found in the file\n");
       return -3;
     }
     auto pos = exifData.findKey(Exiv2::ExifKey("Exif.Photo.UserComment"));
     if (pos == exifData.end()) {
       if (Params::instance().verbose_) {
-        std::cout << _("No Exif user comment found") << "\n";
+        out() << _("No Exif user comment found") << "\n";
       }
       return 0;
     }
@@ -1534,20 +1590,20 @@ int FixCom::run(const std::string& path) {
     const auto pcv = dynamic_cast<const Exiv2::CommentValue*>(v.get());
     if (!pcv) {
       if (Params::instance().verbose_) {
-        std::cout << _("Found Exif user comment with unexpected value type") << "\n";
+        out() << _("Found Exif user comment with unexpected value type") << "\n";
       }
       return 0;
     }
     Exiv2::CommentValue::CharsetId csId = pcv->charsetId();
     if (csId != Exiv2::CommentValue::unicode) {
       if (Params::instance().verbose_) {
-        std::cout << _("No Exif UNICODE user comment found") << "\n";
+        out() << _("No Exif UNICODE user comment found") << "\n";
       }
       return 0;
     }
     std::string comment = pcv->comment(Params::instance().charset_.c_str());
     if (Params::instance().verbose_) {
-      std::cout << _("Setting Exif UNICODE user comment to") << " \"" << comment << "\"\n";
+      out() << _("Setting Exif UNICODE user comment to") << " \"" << comment << "\"\n";
     }
     comment = std::string("charset=\"") + Exiv2::CommentValue::CharsetInfo::name(csId) + "\" " + comment;
     // Remove BOM and convert value from source charset to UCS-2, but keep byte order
@@ -1558,7 +1614,7 @@ int FixCom::run(const std::string& path) {
 
     return 0;
   } catch (const Exiv2::Error& e) {
-    std::cerr << "Exiv2 exception in fixcom action for file " << path << ":\n" << e << "\n";
+    err() << "Exiv2 exception in fixcom action for file " << path << ":\n" << e << "\n";
     return 1;
   }
 }  // FixCom::run
@@ -1651,8 +1707,16 @@ int str2Tm(const std::string& timeStr, struct tm* tm) {
 }  // str2Tm
 
 std::string time2Str(time_t time) {
-  struct tm* tm = localtime(&time);
-  return tm2Str(tm);
+  // localtime() is not reentrant and files may be adjusted in parallel
+  struct tm tm = {};
+#ifdef _WIN32
+  if (localtime_s(&tm, &time) != 0)
+    return "";
+#else
+  if (!localtime_r(&time, &tm))
+    return "";
+#endif
+  return tm2Str(&tm);
 }  // time2Str
 
 std::string tm2Str(const struct tm* tm) {
@@ -1688,14 +1752,13 @@ std::string temporaryPath() {
 
 int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType targetType, bool preserve) {
 #ifdef EXIV2_DEBUG_MESSAGES
-  std::cerr << "actions.cpp::metacopy"
-            << " source = " << source << " target = " << tgt << std::endl;
+  Action::err() << "actions.cpp::metacopy" << " source = " << source << " target = " << tgt << std::endl;
 #endif
 
   // read the source metadata
   int rc = -1;
   if (!Exiv2::fileExists(source)) {
-    std::cerr << source << ": " << _("Failed to open the file\n");
+    Action::err() << source << ": " << _("Failed to open the file\n");
     return rc;
   }
 
@@ -1731,7 +1794,7 @@ int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType
   // Copy each type of metadata
   if (Params::instance().target_ & Params::ctExif && !sourceImage->exifData().empty()) {
     if (Params::instance().verbose_ && !bStdout) {
-      std::cout << _("Writing Exif data from") << " " << source << " " << _("to") << " " << target << std::endl;
+      Action::out() << _("Writing Exif data from") << " " << source << " " << _("to") << " " << target << std::endl;
     }
     if (preserve) {
       for (auto&& exif : sourceImage->exifData()) {
@@ -1743,7 +1806,7 @@ int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType
   }
   if (Params::instance().target_ & Params::ctIptc && !sourceImage->iptcData().empty()) {
     if (Params::instance().verbose_ && !bStdout) {
-      std::cout << _("Writing IPTC data from") << " " << source << " " << _("to") << " " << target << std::endl;
+      Action::out() << _("Writing IPTC data from") << " " << source << " " << _("to") << " " << target << std::endl;
     }
     if (preserve) {
       for (auto&& iptc : sourceImage->iptcData()) {
@@ -1755,7 +1818,7 @@ int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType
   }
   if (Params::instance().target_ & (Params::ctXmp | Params::ctXmpRaw) && !sourceImage->xmpData().empty()) {
     if (Params::instance().verbose_ && !bStdout) {
-      std::cout << _("Writing XMP data from") << " " << source << " " << _("to") << " " << target << std::endl;
+      Action::out() << _("Writing XMP data from") << " " << source << " " << _("to") << " " << target << std::endl;
     }
 
     // #1148 use Raw XMP packet if there are no XMP modification commands
@@ -1779,7 +1842,7 @@ int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType
   }
   if (Params::instance().target_ & Params::ctComment && !sourceImage->comment().empty()) {
     if (Params::instance().verbose_ && !bStdout) {
-      std::cout << _("Writing JPEG comment from") << " " << source << " " << _("to") << " " << tgt << std::endl;
+      Action::out() << _("Writing JPEG comment from") << " " << source << " " << _("to") << " " << tgt << std::endl;
     }
     targetImage->setComment(sourceImage->comment());
   }
@@ -1788,7 +1851,7 @@ int metacopy(const std::string& source, const std::string& tgt, Exiv2::ImageType
       targetImage->writeMetadata();
       rc = 0;
     } catch (const Exiv2::Error& e) {
-      std::cerr << tgt << ": " << _("Could not write metadata to file") << ": " << e << "\n";
+      Action::err() << tgt << ": " << _("Could not write metadata to file") << ": " << e << "\n";
       rc = 1;
     }
 
@@ -1843,7 +1906,7 @@ int renameFile(std::string& newPath, const struct tm* tm) {
   const size_t max = 1024;
   char basename[max] = {};
   if (strftime(basename, max, format.c_str(), tm) == 0) {
-    std::cerr << _("Filename format yields empty filename for the file") << " " << path << "\n";
+    Action::err() << _("Filename format yields empty filename for the file") << " " << path << "\n";
     return 1;
   }
 
@@ -1852,7 +1915,7 @@ int renameFile(std::string& newPath, const struct tm* tm) {
 
   if (p.parent_path() == oldFsPath.parent_path() && p.filename() == oldFsPath.filename()) {
     if (Params::instance().verbose_) {
-      std::cout << _("This file already has the correct name") << std::endl;
+      Action::out() << _("This file already has the correct name") << std::endl;
     }
     return -1;
   }
@@ -1872,9 +1935,8 @@ int renameFile(std::string& newPath, const struct tm* tm) {
                         .string();
           break;
         case Params::askPolicy:
-          std::cout << Params::instance().progname() << ": " << _("File") << " `" << newPath << "' "
-                    << _("exists. [O]verwrite, [r]ename or [s]kip?") << " ";
-          std::cin >> s;
+          s = prompt(Params::instance().progname() + ": " + _("File") + " `" + newPath + "' " +
+                     _("exists. [O]verwrite, [r]ename or [s]kip?") + " ");
           switch (s.at(0)) {
             case 'o':
             case 'O':
@@ -1898,11 +1960,11 @@ int renameFile(std::string& newPath, const struct tm* tm) {
   }
 
   if (Params::instance().verbose_) {
-    std::cout << _("Renaming file to") << " " << newPath;
+    Action::out() << _("Renaming file to") << " " << newPath;
     if (Params::instance().timestamp_) {
-      std::cout << ", " << _("updating timestamp");
+      Action::out() << ", " << _("updating timestamp");
     }
-    std::cout << std::endl;
+    Action::out() << std::endl;
   }
 
   fs::rename(path, newPath);
@@ -1924,15 +1986,27 @@ int dontOverwrite(const std::string& path) {
     return 0;
 
   if (!Params::instance().force_ && Exiv2::fileExists(path)) {
-    std::cout << Params::instance().progname() << ": " << _("Overwrite") << " `" << path << "'? ";
-    std::string s;
-    std::cin >> s;
+    std::string s = prompt(Params::instance().progname() + ": " + _("Overwrite") + " `" + path + "'? ");
     if (s.at(0) != 'y' && s.at(0) != 'Y')
       return 1;
   }
   return 0;
 }
 
+std::string prompt(const std::string& question) {
+  static std::mutex promptMutex;
+  std::lock_guard<std::mutex> guard(promptMutex);
+  if (Params::instance().serving_) {
+    // stdin carries the requests in server mode, answer no
+    Action::err() << question << "n\n";
+    return "n";
+  }
+  std::cout << question;
+  std::string s;
+  std::cin >> s;
+  return s;
+}
+
 std::ostream& operator<<(std::ostream& os, const std::pair<std::string, int>& strAndWidth) {
   const std::string& str(strAndWidth.first);
   size_t minChCount(strAndWidth.second);
@@ -1945,11 +2019,91 @@ std::ostream& operator<<(std::ostream& os, const std::pair<std::string, int>& st
 
 int printStructure(std::ostream& out, Exiv2::PrintStructureOption option, const std::string& path) {
   if (!Exiv2::fileExists(path)) {
-    std::cerr << path << ": " << _("Failed to open the file\n");
+    Action::err() << path << ": " << _("Failed to open the file\n");
     return -1;
   }
   Exiv2::Image::UniquePtr image = Exiv2::ImageFactory::open(path);
   image->printStructure(out, option);
   return 0;
 }
+
+std::string plainValue(const Exiv2::Metadatum& md) {
+  // #1114 - show negative values for SByte
+  if (md.typeId() == Exiv2::signedByte) {
+    std::ostringstream os;
+    for (size_t c = 0; c < md.value().count(); c++) {
+      const auto value = md.value().toInt64(c);
+      os << (c ? " " : "") << std::dec << (value < 128 ? value : value - 256);
+    }
+    return os.str();
+  }
+  std::string value;
+  md.appendTo(value);
+  return value;
+}
+
+void appendJsonString(std::string& json, const std::string& str) {
+  static constexpr char hex[] = "0123456789abcdef";
+  json += '"';
+  for (size_t i = 0; i < str.size();) {
+    auto ch = static_cast<unsigned char>(str[i]);
+    if (ch >= 0x80) {
+      // Length of a valid UTF-8 sequence starting at i, 0 if it is invalid
+      size_t len = 0;
+      if (ch >= 0xc2 && ch <= 0xdf)
+        len = 2;
+      else if (ch >= 0xe0 && ch <= 0xef)
+        len = 3;
+      else if (ch >= 0xf0 && ch <= 0xf4)
+        len = 4;
+      for (size_t k = 1; k < len; ++k) {
+        auto cont = i + k < str.size() ? static_cast<unsigned char>(str[i + k]) : 0;
+        // Exclude overlong forms, surrogates and code points above U+10FFFF
+        const unsigned char lo = k > 1 ? 0x80 : ch == 0xe0 ? 0xa0 : ch == 0xf0 ? 0x90 : 0x80;
+        const unsigned char hi = k > 1 ? 0xbf : ch == 0xed ? 0x9f : ch == 0xf4 ? 0x8f : 0xbf;
+        if (cont < lo || cont > hi) {
+          len = 0;
+          break;
+        }
+      }
+      if (len == 0) {
+        json += "\\ufffd";
+        ++i;
+      } else {
+        json.append(str, i, len);
+        i += len;
+      }
+      continue;
+    }
+    switch (ch) {
+      case '"':
+        json += "\\\"";
+        break;
+      case '\\':
+        json += "\\\\";
+        break;
+      case '\n':
+        json += "\\n";
+        break;
+      case '\r':
+        json += "\\r";
+        break;
+      case '\t':
+        json += "\\t";
+        break;
+      default:
+        if (ch < 0x20) {
+          json += "\\u00";
+          json += hex[ch >> 4];
+          json += hex[ch & 0xf];
+        } else {
+          json += static_cast<char>(ch);
+        }
+        break;
+    }
+    ++i;
+  }
+  json += '"';
+}
+
 }  // namespace
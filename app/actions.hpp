@@ -43,6 +43,17 @@ enum TaskType {
   fixcom,
 };
 
+/*!
+  @brief Return the stream for the output of tasks run on the current thread.
+         This is std::cout, unless the thread processes files in parallel
+         (option -j) and the output is buffered, see setOutput().
+ */
+std::ostream& out();
+//! Return the stream for error messages of tasks run on the current thread, std::cerr by default.
+std::ostream& err();
+//! Redirect out() and err() of the current thread to \em os and \em es, nullptr restores the defaults.
+void setOutput(std::ostream* os, std::ostream* es);
+
 // *****************************************************************************
 // class definitions
 
@@ -133,13 +144,13 @@ class Print : public Task {
   Task::UniquePtr clone() const override;
 
   //! Print the Jpeg comment
-  int printComment();
+  int printComment(const Exiv2::Image& image);
   //! Print list of available preview images
-  int printPreviewList();
+  int printPreviewList(const Exiv2::Image& image);
   //! Print Exif summary information
-  int printSummary();
-  //! Print Exif, IPTC and XMP metadata in user defined format
-  int printList();
+  int printSummary(Exiv2::Image& image);
+  //! Print Exif, IPTC and XMP metadata as one line of JSON
+  int printJson(const Exiv2::Image& image);
   //! Return true if key should be printed, else false
   static bool grepTag(const std::string& key);
   //! Return true if key should be printed, else false
@@ -14,12 +14,19 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 #if defined(_WIN32) || defined(__CYGWIN__)
 #include <fcntl.h>
@@ -31,6 +38,8 @@
 #include <unistd.h>
 #endif
 
+namespace fs = std::filesystem;
+
 // *****************************************************************************
 // local declarations
 namespace {
@@ -73,6 +82,13 @@ int64_t parseCommonTargets(const std::string& optArg, const std::string& action)
  */
 int parsePreviewNumbers(Params::PreviewNumbers& previewNumbers, const std::string& optArg, int j);
 
+/*!
+  @brief Parse metadata modification commands from a file
+  @param modifyCmds Reference to a structure to store the parsed commands
+  @param filename Name of the file, "-" for stdin
+ */
+bool parseCmdFile(ModifyCmds& modifyCmds, const std::string& filename);
+
 /*!
   @brief Parse metadata modification commands from multiple files
   @param modifyCmds Reference to a structure to store the parsed commands
@@ -87,6 +103,9 @@ bool parseCmdFiles(ModifyCmds& modifyCmds, const Params::CmdFiles& cmdFiles);
  */
 bool parseCmdLines(ModifyCmds& modifyCmds, const Params::CmdLines& cmdLines);
 
+//! Register the XMP namespaces of the reg commands in \em modifyCmds, as parsing them does
+void registerNamespaces(const ModifyCmds& modifyCmds);
+
 /*!
   @brief Parse one line of the command file
   @param modifyCmd Reference to a command structure to store the parsed
@@ -101,6 +120,44 @@ bool parseLine(ModifyCmd& modifyCmd, const std::string& line, int num);
   @param input Input string, assumed to be UTF-8
  */
 std::string parseEscapes(const std::string& input);
+
+//! Print the "File n/count: file" line of verbose output
+void printFileHeader(std::ostream& os, size_t n, size_t count, const std::string& file);
+
+/*!
+  @brief Run \em task on all \em files, with up to \em jobs files processed in
+         parallel by clones of the task. The output of each file is buffered
+         and written in the order of the files, so it is the same as that of
+         a sequential run. No file is started more than 2 * \em jobs files
+         ahead of the next one to write. Return the exit code of the first
+         file that fails.
+ */
+int runParallel(const Action::Task& task, const Params::Files& files, unsigned jobs, bool verbose);
+
+/*!
+  @brief Parse the command line into the global Params instance and run
+         the requested task on all files. Return the exit code.
+ */
+int run(int argc, char* const argv[]);
+
+/*!
+  @brief Server mode (option --serve): Read one command line per line from
+         stdin and run it as if it had been passed to exiv2 on the command
+         line, without starting a new process for each command. The response
+         to each command is a line with the exit code and the number of bytes
+         written to standard output and standard error, "rc nout nerr",
+         followed by the output and the error messages.
+  @param progname Program name to use as argv[0] of the commands.
+  @return The exit code of the program.
+ */
+int serve(const char* progname);
+
+/*!
+  @brief Split a command line into arguments at unquoted whitespace, with
+         shell-like single and double quotes and backslash escapes.
+  @return False if the line ends within quotes or with a backslash.
+ */
+bool splitArgs(const std::string& line, std::vector<std::string>& args);
 }  // namespace
 
 // *****************************************************************************
@@ -108,7 +165,9 @@ std::string parseEscapes(const std::string& input);
 int main(int argc, char* const argv[]) {
   setlocale(LC_CTYPE, ".utf8");
 
-  Exiv2::XmpParser::initialize();
+  // Serialize XMP namespace registrations of files processed in parallel
+  static std::mutex xmpMutex;
+  Exiv2::XmpParser::initialize([](void*, bool lock) { lock ? xmpMutex.lock() : xmpMutex.unlock(); });
   ::atexit(Exiv2::XmpParser::terminate);
 #ifdef EXV_ENABLE_BMFF
   Exiv2::enableBMFF();
@@ -122,54 +181,14 @@ int main(int argc, char* const argv[]) {
   textdomain(EXV_PACKAGE_NAME);
 #endif
 
-  // Handle command line arguments
-  Params& params = Params::instance();
-  if (params.getopt(argc, argv)) {
-    params.usage();
-    return 1;
-  }
-  if (params.help_) {
-    params.help();
-    return 0;
-  }
-  if (params.version_) {
-    Params::version(params.verbose_);
-    return 0;
-  }
-
   int returnCode = EXIT_SUCCESS;
-
-  try {
-    // Create the required action class
-    auto task = Action::TaskFactory::instance().create(static_cast<Action::TaskType>(params.action_));
-
-    // Process all files
-    auto filesCount = params.files_.size();
-    if (params.action_ & Action::extract && params.target_ & Params::ctStdInOut && filesCount > 1) {
-      std::cerr << params.progname() << ": " << _("Only one file is allowed when extracting to stdout") << std::endl;
-      returnCode = EXIT_FAILURE;
-    } else {
-      int w = filesCount > 9 ? filesCount > 99 ? 3 : 2 : 1;
-      int n = 1;
-      for (auto&& file : params.files_) {
-        // If extracting to stdout then ignore verbose
-        if (params.verbose_ && !(params.action_ & Action::extract && params.target_ & Params::ctStdInOut)) {
-          std::cout << _("File") << " " << std::setw(w) << std::right << n++ << "/" << filesCount << ": " << file
-                    << std::endl;
-        }
-        task->setBinary(params.binary_);
-        int ret = task->run(file);
-        if (returnCode == EXIT_SUCCESS)
-          returnCode = ret;
-      }
-
-      Action::TaskFactory::instance().cleanup();
-      Exiv2::XmpParser::terminate();
-    }
-  } catch (const std::exception& exc) {
-    std::cerr << "Uncaught exception: " << exc.what() << std::endl;
-    returnCode = EXIT_FAILURE;
+  if (argc == 2 && strcmp(argv[1], "--serve") == 0) {
+    returnCode = serve(argv[0]);
+  } else {
+    returnCode = run(argc, argv);
   }
+  Action::TaskFactory::instance().cleanup();
+  Exiv2::XmpParser::terminate();
 
   // Return a positive one byte code for better consistency across platforms
   return static_cast<unsigned int>(returnCode) % 256;
@@ -179,7 +198,7 @@ int main(int argc, char* const argv[]) {
 // class Params
 
 Params::Params() :
-    optstring_(":hVvqfbuktTFa:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:"),
+    optstring_(":hVvqfbuktTFa:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:j:"),
 
     target_(ctExif | ctIptc | ctComment | ctXmp),
 
@@ -189,9 +208,15 @@ Params::Params() :
   yodAdjust_[yodDay] = emptyYodAdjust_[yodDay];
 }
 
+// Created before main() so that the worker threads of -j never race to create it
+std::unique_ptr<Params> Params::instance_(new Params);
+
 Params& Params::instance() {
-  static Params instance_;
-  return instance_;
+  return *instance_;
+}
+
+void Params::reset() {
+  instance_.reset(new Params);
 }
 
 void Params::version(bool verbose, std::ostream& os) {
@@ -214,8 +239,18 @@ void Params::version(bool verbose, std::ostream& os) {
             "Boston, MA 02110-1301 USA\n");
   }
 
-  if (verbose)
-    Exiv2::dumpLibraryInfo(os, Params::instance().greps_);
+  if (verbose) {
+    // The regular expressions are only compiled here, the metadata is filtered with grepFilter_
+    std::vector<std::regex> keys;
+    for (auto&& grep : Params::instance().greps_) {
+      bool bIgnoreCase = grep.size() > 2 && grep.back() == 'i' && grep[grep.size() - 2] == '/';
+      // use POSIX syntax, optimize for faster matching, treat all sub expressions as unnamed
+      auto flags = std::regex::basic | std::regex::optimize | std::regex::nosubs;
+      keys.emplace_back(bIgnoreCase ? grep.substr(0, grep.size() - 2) : grep,
+                        bIgnoreCase ? flags | std::regex::icase : flags);
+    }
+    Exiv2::dumpLibraryInfo(os, keys);
+  }
 }
 
 void Params::usage(std::ostream& os) const {
@@ -262,6 +297,7 @@ void Params::help(std::ostream& os) const {
      << _("   -k      Preserve file timestamps when updating files (keep)\n")
      << _("   -t      Set the file timestamp from Exif metadata when renaming (overrides -k)\n")
      << _("   -T      Only set the file timestamp from Exif metadata ('rename' action)\n")
+     << _("   -j n    Process n files in parallel, 0 for one per processor core\n")
      << _("   -f      Do not prompt before overwriting existing files (force)\n")
      << _("   -F      Do not prompt before renaming files (Force)\n")
      << _("   -a time Time adjustment in the format [+|-]HH[:MM[:SS]]. For 'adjust' action\n")
@@ -281,6 +317,7 @@ void Params::help(std::ostream& os) const {
      << _("             R : Recursive print structure of image (debug build only)\n")
      << _("             S : Print structure of image (limited file types)\n")
      << _("             X : Extract \"raw\" XMP\n")
+     << _("             J : Exif, IPTC and XMP tags as JSON, one line per file\n")
      << _("   -P flgs Print flags for fine control of tag lists ('print' action):\n")
      << _("             E : Exif tags\n") << _("             I : IPTC tags\n") << _("             X : XMP tags\n")
      << _("             x : Tag number (Exif and IPTC only)\n")
@@ -325,7 +362,10 @@ void Params::help(std::ostream& os) const {
      << _("           ( (set | add) <key> [[<type>] <value>] |\n") << _("             del <key> [<type>] |\n")
      << _("             reg prefix namespace )\n")
      << _("   -l dir  Location (directory) for files to be inserted from or extracted to.\n")
-     << _("   -S suf Use suffix 'suf' for source files for insert action.\n") << _("\nExamples:\n")
+     << _("   -S suf Use suffix 'suf' for source files for insert action.\n")
+     << _("   --serve Read command lines from stdin, one per line, and run them in this process.\n"
+          "           Must be the only option\n")
+     << _("\nExamples:\n")
      << _("   exiv2 -pe image.dng *.jp2\n"
           "           Print all Exif tags in image.dng and all .jp2 files\n")
      << _("   exiv2 -g date/i https://clanmills.com/Stonehenge.jpg\n"
@@ -374,7 +414,6 @@ int Params::option(int opt, const std::string& optArg, int optOpt) {
       break;
     case 'K':
       rc = evalKey(optArg);
-      printMode_ = pmList;
       break;
     case 'n':
       charset_ = optArg;
@@ -433,6 +472,9 @@ int Params::option(int opt, const std::string& optArg, int optOpt) {
     case 'S':
       suffix_ = optArg;
       break;
+    case 'j':
+      rc = evalJobs(optArg);
+      break;
     case ':':
       std::cerr << progname() << ": " << _("Option") << " -" << static_cast<char>(optOpt) << " "
                 << _("requires an argument\n");
@@ -478,18 +520,25 @@ int Params::setLogLevel(const std::string& optArg) {
   return rc;
 }  // Params::setLogLevel
 
+int Params::evalJobs(const std::string& optArg) {
+  int64_t jobs = 0;
+  if (!Util::strtol(optArg.c_str(), jobs) || jobs < 0 || jobs > 1024) {
+    std::cerr << progname() << ": " << _("Option") << " -j: " << _("Invalid argument") << " \"" << optArg << "\"\n";
+    return 1;
+  }
+  jobs_ = jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : static_cast<unsigned>(jobs);
+  return 0;
+}  // Params::evalJobs
+
 int Params::evalGrep(const std::string& optArg) {
   // check that string ends in "/i"
   bool bIgnoreCase = optArg.size() > 2 && optArg.back() == 'i' && optArg[optArg.size() - 2] == '/';
   auto pattern = bIgnoreCase ? optArg.substr(0, optArg.size() - 2) : optArg;
 
   try {
-    // use POSIX syntax, optimize for faster matching, treat all sub expressions as unnamed
-    auto flags = std::regex::basic | std::regex::optimize | std::regex::nosubs;
-    flags = bIgnoreCase ? flags | std::regex::icase : flags;
-    // try and emplace regex into vector
     // might throw if invalid pattern
-    greps_.emplace_back(pattern, flags);
+    grepFilter_.addPattern(pattern, bIgnoreCase);
+    greps_.push_back(optArg);
   } catch (std::regex_error const&) {
     // there was an error compiling the regexp
     std::cerr << progname() << ": " << _("Option") << " -g: " << _("Invalid regexp") << " \"" << optArg << "\n";
@@ -501,7 +550,7 @@ int Params::evalGrep(const std::string& optArg) {
 
 int Params::evalKey(const std::string& optArg) {
   int result = 0;
-  keys_.push_back(optArg);
+  keys_.addKey(optArg);
   return result;
 }  // Params::evalKey
 
@@ -595,60 +644,71 @@ int Params::evalPrint(const std::string& optArg) {
   int rc = 0;
   switch (action_) {
     case Action::none:
+    case Action::print:
       switch (optArg[0]) {
         case 's':
-          action_ = Action::print;
-          printMode_ = pmSummary;
+          rc = addPrintMode(pmSummary, optArg);
           break;
         case 'a':
-          rc = evalPrintFlags("kyct");
-          break;
         case 'e':
-          rc = evalPrintFlags("Ekycv");
-          break;
         case 't':
-          rc = evalPrintFlags("Ekyct");
-          break;
         case 'v':
-          rc = evalPrintFlags("Exgnycv");
-          break;
         case 'h':
-          rc = evalPrintFlags("Exgnycsh");
-          break;
         case 'i':
-          rc = evalPrintFlags("Ikyct");
-          break;
         case 'x':
-          rc = evalPrintFlags("Xkyct");
+          if (std::find(printModes_.begin(), printModes_.end(), pmList) != printModes_.end()) {
+            std::cerr << progname() << ": " << _("Ignoring surplus option -p") << optArg << "\n";
+            break;
+          }
+          switch (optArg[0]) {
+            case 'a':
+              rc = evalPrintFlags("kyct");
+              break;
+            case 'e':
+              rc = evalPrintFlags("Ekycv");
+              break;
+            case 't':
+              rc = evalPrintFlags("Ekyct");
+              break;
+            case 'v':
+              rc = evalPrintFlags("Exgnycv");
+              break;
+            case 'h':
+              rc = evalPrintFlags("Exgnycsh");
+              break;
+            case 'i':
+              rc = evalPrintFlags("Ikyct");
+              break;
+            case 'x':
+              rc = evalPrintFlags("Xkyct");
+              break;
+          }
           break;
         case 'c':
-          action_ = Action::print;
-          printMode_ = pmComment;
+          rc = addPrintMode(pmComment, optArg);
           break;
         case 'p':
-          action_ = Action::print;
-          printMode_ = pmPreview;
+          rc = addPrintMode(pmPreview, optArg);
           break;
         case 'C':
-          action_ = Action::print;
-          printMode_ = pmIccProfile;
+          rc = addPrintMode(pmIccProfile, optArg);
           break;
         case 'R':
 #ifdef NDEBUG
           std::cerr << progname() << ": " << _("Action not available in Release mode") << ": '" << optArg << "'\n";
           rc = 1;
 #else
-          action_ = Action::print;
-          printMode_ = pmRecursive;
+          rc = addPrintMode(pmRecursive, optArg);
 #endif
           break;
         case 'S':
-          action_ = Action::print;
-          printMode_ = pmStructure;
+          rc = addPrintMode(pmStructure, optArg);
           break;
         case 'X':
-          action_ = Action::print;
-          printMode_ = pmXMP;
+          rc = addPrintMode(pmXMP, optArg);
+          break;
+        case 'J':
+          rc = addPrintMode(pmJson, optArg);
           break;
         default:
           std::cerr << progname() << ": " << _("Unrecognized print mode") << " `" << optArg << "'\n";
@@ -656,9 +716,6 @@ int Params::evalPrint(const std::string& optArg) {
           break;
       }
       break;
-    case Action::print:
-      std::cerr << progname() << ": " << _("Ignoring surplus option -p") << optArg << "\n";
-      break;
     default:
       std::cerr << progname() << ": " << _("Option -p is not compatible with a previous option\n");
       rc = 1;
@@ -667,12 +724,28 @@ int Params::evalPrint(const std::string& optArg) {
   return rc;
 }  // Params::evalPrint
 
+int Params::addPrintMode(PrintMode mode, const std::string& optArg) {
+  action_ = Action::print;
+  if (std::find(printModes_.begin(), printModes_.end(), mode) != printModes_.end()) {
+    std::cerr << progname() << ": " << _("Ignoring surplus option -p") << optArg << "\n";
+  } else {
+    printModes_.push_back(mode);
+  }
+  return 0;
+}  // Params::addPrintMode
+
 int Params::evalPrintFlags(const std::string& optArg) {
   int rc = 0;
+  const bool list = std::find(printModes_.begin(), printModes_.end(), pmList) != printModes_.end();
   switch (action_) {
     case Action::none:
+    case Action::print:
+      if (list) {
+        std::cerr << progname() << ": " << _("Ignoring surplus option -P") << optArg << "\n";
+        break;
+      }
       action_ = Action::print;
-      printMode_ = pmList;
+      printModes_.push_back(pmList);
       for (auto&& i : optArg) {
         switch (i) {
           case 'E':
@@ -727,9 +800,6 @@ int Params::evalPrintFlags(const std::string& optArg) {
         }
       }
       break;
-    case Action::print:
-      std::cerr << progname() << ": " << _("Ignoring surplus option -P") << optArg << "\n";
-      break;
     default:
       std::cerr << progname() << ": " << _("Option -P is not compatible with a previous option\n");
       rc = 1;
@@ -1001,7 +1071,7 @@ int Params::getopt(int argc, char* const Argv[]) {
       {"--Modify", "-M"},    {"--encode", "-n"},  {"--months", "-O"},  {"--print", "-p"},    {"--Print", "-P"},
       {"--quiet", "-q"},     {"--log", "-Q"},     {"--rename", "-r"},  {"--suffix", "-S"},   {"--timestamp", "-t"},
       {"--Timestamp", "-T"}, {"--unknown", "-u"}, {"--verbose", "-v"}, {"--Version", "-V"},  {"--version", "-V"},
-      {"--years", "-Y"},
+      {"--years", "-Y"},     {"--jobs", "-j"},    {"--json", "-pJ"},
   };
 
   for (int i = 0; i < argc; i++) {
@@ -1036,6 +1106,11 @@ int Params::getopt(int argc, char* const Argv[]) {
     std::cerr << progname() << ": " << _("At least one file is required\n");
     rc = 1;
   }
+  if (serving_ && (target_ & ctStdInOut || std::find(files_.begin(), files_.end(), "-") != files_.end() ||
+                   std::find(cmdFiles_.begin(), cmdFiles_.end(), "-") != cmdFiles_.end())) {
+    std::cerr << progname() << ": " << _("stdin and stdout cannot be used in server mode\n");
+    rc = 1;
+  }
   if (rc == 0 && !cmdFiles_.empty()) {
     // Parse command files
     if (!parseCmdFiles(modifyCmds_, cmdFiles_)) {
@@ -1070,6 +1145,33 @@ int Params::getopt(int argc, char* const Argv[]) {
     std::cerr << progname() << ": " << _("-T option can only be used with rename action\n");
     rc = 1;
   }
+  if (action_ == Action::print && !keys_.empty() &&
+      std::find(printModes_.begin(), printModes_.end(), pmList) == printModes_.end() &&
+      std::find(printModes_.begin(), printModes_.end(), pmJson) == printModes_.end()) {
+    // -K prints the matching keys as a list
+    printModes_.push_back(pmList);
+  }
+  if (action_ == Action::print && (!greps_.empty() || !keys_.empty())) {
+    // A summary with -g or -K prints the matching keys as a list
+    auto summary = std::find(printModes_.begin(), printModes_.end(), pmSummary);
+    if (printModes_.empty()) {
+      printModes_.push_back(pmList);
+    } else if (summary != printModes_.end()) {
+      if (std::find(printModes_.begin(), printModes_.end(), pmList) != printModes_.end())
+        printModes_.erase(summary);
+      else
+        *summary = pmList;
+    }
+  }
+  if (action_ == Action::print && std::find(printModes_.begin(), printModes_.end(), pmList) != printModes_.end()) {
+    // Set defaults for metadata types and data columns
+    if (printTags_ == MetadataId::invalid) {
+      printTags_ = MetadataId::exif | MetadataId::iptc | MetadataId::xmp;
+    }
+    if (printItems_ == 0) {
+      printItems_ = prKey | prType | prCount | prTrans;
+    }
+  }
 
 cleanup:
   // cleanup the argument vector
@@ -1082,6 +1184,315 @@ cleanup:
 // *****************************************************************************
 // local implementations
 namespace {
+void printFileHeader(std::ostream& os, size_t n, size_t count, const std::string& file) {
+  int w = count > 9 ? count > 99 ? 3 : 2 : 1;
+  os << _("File") << " " << std::setw(w) << std::right << n << "/" << count << ": " << file << std::endl;
+}
+
+//! Stream buffer which collects the output and error messages of one file, in the order they are written
+class TaskOutputBuf : public std::streambuf {
+ public:
+  //! Output segments, the flag is true for error messages
+  using Segments = std::vector<std::pair<bool, std::string>>;
+
+  TaskOutputBuf(Segments& segments, bool err) : segments_(segments), err_(err) {
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      char c = traits_type::to_char_type(ch);
+      xsputn(&c, 1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    if (segments_.empty() || segments_.back().first != err_)
+      segments_.emplace_back(err_, std::string());
+    segments_.back().second.append(s, n);
+    return n;
+  }
+
+ private:
+  Segments& segments_;
+  bool err_;
+};
+
+//! Log message handler for parallel runs, sends log messages to the error stream of the current file
+void taskLogHandler(int level, const char* s) {
+  switch (static_cast<Exiv2::LogMsg::Level>(level)) {
+    case Exiv2::LogMsg::debug:
+      Action::err() << "Debug: ";
+      break;
+    case Exiv2::LogMsg::info:
+      Action::err() << "Info: ";
+      break;
+    case Exiv2::LogMsg::warn:
+      Action::err() << "Warning: ";
+      break;
+    case Exiv2::LogMsg::error:
+      Action::err() << "Error: ";
+      break;
+    default:
+      break;
+  }
+  Action::err() << s;
+}
+
+int runParallel(const Action::Task& task, const Params::Files& files, unsigned jobs, bool verbose) {
+  struct Result {
+    bool done{false};
+    int rc{EXIT_SUCCESS};
+    bool failed{false};
+    std::string exception;
+    TaskOutputBuf::Segments output;
+  };
+  std::vector<Result> results(files.size());
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::condition_variable windowCv;
+  std::atomic<size_t> next{0};
+  std::atomic<bool> stop{false};
+  // Files are not started further ahead of the next file to write than this, to bound the buffered output
+  const size_t window = 2 * static_cast<size_t>(jobs);
+  size_t written = 0;
+
+  auto worker = [&](Action::Task::UniquePtr t) {
+    for (size_t i = next++; i < files.size() && !stop; i = next++) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        windowCv.wait(lock, [&] { return stop || i < written + window; });
+      }
+      if (stop)
+        break;
+      Result result;
+      TaskOutputBuf outBuf(result.output, false);
+      TaskOutputBuf errBuf(result.output, true);
+      std::ostream os(&outBuf);
+      std::ostream es(&errBuf);
+      Action::setOutput(&os, &es);
+      if (verbose) {
+        printFileHeader(os, i + 1, files.size(), files[i]);
+      }
+      try {
+        result.rc = t->run(files[i]);
+      } catch (const std::exception& exc) {
+        result.failed = true;
+        result.exception = exc.what();
+      } catch (...) {
+        result.failed = true;
+        result.exception = "unknown exception while processing " + files[i];
+      }
+      Action::setOutput(nullptr, nullptr);
+      std::lock_guard<std::mutex> lock(mutex);
+      result.done = true;
+      results[i] = std::move(result);
+      cv.notify_one();
+    }
+  };
+
+  Exiv2::LogMsg::Handler handler = Exiv2::LogMsg::handler();
+  if (handler == Exiv2::LogMsg::defaultHandler)
+    Exiv2::LogMsg::setHandler(taskLogHandler);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < std::min<size_t>(jobs, files.size()); ++i) {
+    threads.emplace_back(worker, task.clone());
+  }
+
+  // Write the output of the files in order, as soon as it is available
+  int rc = EXIT_SUCCESS;
+  for (auto&& result : results) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&result] { return result.done; });
+    ++written;
+    windowCv.notify_all();
+    lock.unlock();
+    for (auto&& [err, text] : result.output) {
+      std::ostream& os = err ? std::cerr : std::cout;
+      os << text;
+      os.flush();
+    }
+    result.output.clear();
+    if (result.failed) {
+      std::cerr << "Uncaught exception: " << result.exception << std::endl;
+      rc = EXIT_FAILURE;
+      lock.lock();
+      stop = true;
+      windowCv.notify_all();
+      break;
+    }
+    if (rc == EXIT_SUCCESS)
+      rc = result.rc;
+  }
+
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  Exiv2::LogMsg::setHandler(handler);
+  return rc;
+}
+
+int run(int argc, char* const argv[]) {
+  // Handle command line arguments
+  Params& params = Params::instance();
+  if (params.getopt(argc, argv)) {
+    params.usage();
+    return 1;
+  }
+  if (params.help_) {
+    params.help();
+    return 0;
+  }
+  if (params.version_) {
+    Params::version(params.verbose_);
+    return 0;
+  }
+
+  int returnCode = EXIT_SUCCESS;
+
+  try {
+    // Create the required action class
+    auto task = Action::TaskFactory::instance().create(static_cast<Action::TaskType>(params.action_));
+
+    // Process all files
+    auto filesCount = params.files_.size();
+    if (params.action_ & Action::extract && params.target_ & Params::ctStdInOut && filesCount > 1) {
+      std::cerr << params.progname() << ": " << _("Only one file is allowed when extracting to stdout") << std::endl;
+      returnCode = EXIT_FAILURE;
+    } else {
+      // If extracting to stdout then ignore verbose
+      const bool verbose =
+          params.verbose_ && !(params.action_ & Action::extract && params.target_ & Params::ctStdInOut);
+      // Files and data from stdin or to stdout can only be processed one at a time
+      const bool stdInOut = params.target_ & Params::ctStdInOut ||
+                            std::find(params.files_.begin(), params.files_.end(), "-") != params.files_.end();
+      // Renamed files may collide with each other, so they are renamed one at a time
+      const bool parallel = params.jobs_ > 1 && filesCount > 1 && !stdInOut && params.action_ != Action::rename;
+      task->setBinary(params.binary_);
+      if (parallel) {
+        returnCode = runParallel(*task, params.files_, params.jobs_, verbose);
+      } else {
+        size_t n = 1;
+        for (auto&& file : params.files_) {
+          if (verbose) {
+            printFileHeader(std::cout, n++, filesCount, file);
+          }
+          int ret = task->run(file);
+          if (returnCode == EXIT_SUCCESS)
+            returnCode = ret;
+        }
+      }
+    }
+  } catch (const std::exception& exc) {
+    std::cerr << "Uncaught exception: " << exc.what() << std::endl;
+    returnCode = EXIT_FAILURE;
+  }
+  return returnCode;
+}
+
+int serve(const char* progname) {
+  // Settings which commands can change and which are restored for each command
+  const Exiv2::LogMsg::Level level = Exiv2::LogMsg::level();
+  std::ios outFormat(nullptr);
+  std::ios errFormat(nullptr);
+  outFormat.copyfmt(std::cout);
+  errFormat.copyfmt(std::cerr);
+
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+
+    std::stringbuf outBuf;
+    std::stringbuf errBuf;
+    std::streambuf* coutBuf = std::cout.rdbuf(&outBuf);
+    std::streambuf* cerrBuf = std::cerr.rdbuf(&errBuf);
+
+    int rc = EXIT_SUCCESS;
+    std::vector<std::string> args{progname};
+    if (!splitArgs(line, args)) {
+      std::cerr << fs::path(progname).filename().string() << ": " << _("Unterminated quote or escape in command")
+                << "\n";
+      rc = 1;
+    } else {
+      std::vector<char*> argv;
+      for (auto&& arg : args) {
+        argv.push_back(arg.data());
+      }
+      argv.push_back(nullptr);
+      Params::reset();
+      Params::instance().serving_ = true;
+      try {
+        rc = run(static_cast<int>(args.size()), argv.data());
+      } catch (const std::exception& exc) {
+        std::cerr << "Uncaught exception: " << exc.what() << std::endl;
+        rc = EXIT_FAILURE;
+      }
+      // Namespaces registered by a command must not leak into the next one
+      Exiv2::XmpProperties::unregisterNs();
+    }
+
+    std::cout.rdbuf(coutBuf);
+    std::cerr.rdbuf(cerrBuf);
+    std::cout.copyfmt(outFormat);
+    std::cerr.copyfmt(errFormat);
+    std::cout.clear();
+    std::cerr.clear();
+    Exiv2::LogMsg::setLevel(level);
+
+    const std::string out = outBuf.str();
+    const std::string err = errBuf.str();
+    std::cout << static_cast<unsigned int>(rc) % 256 << " " << out.size() << " " << err.size() << "\n"
+              << out << err;
+    std::cout.flush();
+  }
+  return EXIT_SUCCESS;
+}
+
+bool splitArgs(const std::string& line, std::vector<std::string>& args) {
+  std::string arg;
+  bool inArg = false;
+  char quote = 0;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char ch = line[i];
+    if (quote == '\'') {
+      if (ch == '\'')
+        quote = 0;
+      else
+        arg += ch;
+    } else if (ch == '\\' &&
+               (quote == 0 || (i + 1 < line.size() && (line[i + 1] == '"' || line[i + 1] == '\\')))) {
+      if (++i == line.size())
+        return false;
+      arg += line[i];
+      inArg = true;
+    } else if (quote == '"') {
+      if (ch == '"')
+        quote = 0;
+      else
+        arg += ch;
+    } else if (ch == '\'' || ch == '"') {
+      quote = ch;
+      inArg = true;
+    } else if (ch == ' ' || ch == '\t' || ch == '\r') {
+      if (inArg)
+        args.push_back(arg);
+      arg.clear();
+      inArg = false;
+    } else {
+      arg += ch;
+      inArg = true;
+    }
+  }
+  if (quote != 0)
+    return false;
+  if (inArg)
+    args.push_back(arg);
+  return true;
+}
+
 bool parseTime(const std::string& ts, int64_t& time) {
   std::string hstr, mstr, sstr;
   auto cts = new char[ts.length() + 1];
@@ -1233,40 +1644,97 @@ int parsePreviewNumbers(Params::PreviewNumbers& previewNumbers, const std::strin
   return static_cast<int>(k - j);
 }  // parsePreviewNumbers
 
+bool parseCmdFile(ModifyCmds& modifyCmds, const std::string& filename) {
+  try {
+    std::ifstream file(filename.c_str());
+    bool bStdin = filename == "-";
+    if (!file && !bStdin) {
+      std::cerr << filename << ": " << _("Failed to open command file for reading\n");
+      return false;
+    }
+    int num = 0;
+    std::string line;
+    while (bStdin ? std::getline(std::cin, line) : std::getline(file, line)) {
+      ModifyCmd modifyCmd;
+      if (parseLine(modifyCmd, line, ++num)) {
+        modifyCmds.push_back(modifyCmd);
+      }
+    }
+  } catch (const Exiv2::Error& error) {
+    std::cerr << filename << ", " << _("line") << " " << error << "\n";
+    return false;
+  }
+  return true;
+}  // parseCmdFile
+
+//! Number of parsed command files or command lines which server mode keeps at most
+constexpr size_t maxCachedCmds = 64;
+
 bool parseCmdFiles(ModifyCmds& modifyCmds, const Params::CmdFiles& cmdFiles) {
+  // Parsed command files, reused in server mode as long as the file does not change
+  struct CachedCmdFile {
+    fs::file_time_type time;
+    std::uintmax_t size;
+    ModifyCmds cmds;
+  };
+  static std::map<std::string, CachedCmdFile> cache;
+
   for (auto&& filename : cmdFiles) {
-    try {
-      std::ifstream file(filename.c_str());
-      bool bStdin = filename == "-";
-      if (!file && !bStdin) {
-        std::cerr << filename << ": " << _("Failed to open command file for reading\n");
+    if (!Params::instance().serving_) {
+      if (!parseCmdFile(modifyCmds, filename))
         return false;
-      }
-      int num = 0;
-      std::string line;
-      while (bStdin ? std::getline(std::cin, line) : std::getline(file, line)) {
-        ModifyCmd modifyCmd;
-        if (parseLine(modifyCmd, line, ++num)) {
-          modifyCmds.push_back(modifyCmd);
-        }
-      }
-    } catch (const Exiv2::Error& error) {
-      std::cerr << filename << ", " << _("line") << " " << error << "\n";
+      continue;
+    }
+    std::error_code ec;
+    const auto time = fs::last_write_time(filename, ec);
+    const auto size = fs::file_size(filename, ec);
+    auto cached = cache.find(filename);
+    if (!ec && cached != cache.end() && cached->second.time == time && cached->second.size == size) {
+      registerNamespaces(cached->second.cmds);
+      modifyCmds.insert(modifyCmds.end(), cached->second.cmds.begin(), cached->second.cmds.end());
+      continue;
+    }
+    ModifyCmds cmds;
+    if (!parseCmdFile(cmds, filename))
       return false;
+    if (!ec) {
+      if (cache.size() >= maxCachedCmds)
+        cache.clear();
+      cache[filename] = {time, size, cmds};
     }
+    modifyCmds.insert(modifyCmds.end(), cmds.begin(), cmds.end());
   }
   return true;
-}  // parseCmdFile
+}  // parseCmdFiles
 
 bool parseCmdLines(ModifyCmds& modifyCmds, const Params::CmdLines& cmdLines) {
+  // Parsed commands, reused in server mode
+  static std::map<Params::CmdLines, ModifyCmds> cache;
+
+  const bool serving = Params::instance().serving_;
+  if (serving) {
+    auto cached = cache.find(cmdLines);
+    if (cached != cache.end()) {
+      registerNamespaces(cached->second);
+      modifyCmds.insert(modifyCmds.end(), cached->second.begin(), cached->second.end());
+      return true;
+    }
+  }
   try {
+    ModifyCmds cmds;
     int num = 0;
     for (auto&& line : cmdLines) {
       ModifyCmd modifyCmd;
       if (parseLine(modifyCmd, line, ++num)) {
-        modifyCmds.push_back(modifyCmd);
+        cmds.push_back(modifyCmd);
       }
     }
+    if (serving) {
+      if (cache.size() >= maxCachedCmds)
+        cache.clear();
+      cache[cmdLines] = cmds;
+    }
+    modifyCmds.insert(modifyCmds.end(), cmds.begin(), cmds.end());
     return true;
   } catch (const Exiv2::Error& error) {
     std::cerr << _("-M option") << " " << error << "\n";
@@ -1274,6 +1742,13 @@ bool parseCmdLines(ModifyCmds& modifyCmds, const Params::CmdLines& cmdLines) {
   }
 }  // parseCmdLines
 
+void registerNamespaces(const ModifyCmds& modifyCmds) {
+  for (auto&& cmd : modifyCmds) {
+    if (cmd.cmdId_ == CmdId::reg)
+      Exiv2::XmpProperties::registerNs(cmd.value_, cmd.key_);
+  }
+}
+
 #if defined(_MSC_VER) || defined(__MINGW__)
 static std::string formatArg(const char* arg) {
   std::string result = "";
@@ -17,8 +17,9 @@
 
 // + standard includes
 #include <iostream>
-#include <regex>
+#include <memory>
 #include <set>
+#include <vector>
 
 //! Command identifiers
 enum class CmdId {
@@ -112,8 +113,6 @@ class Params : public Util::Getopt {
   using Files = std::vector<std::string>;
   //! Container for preview image numbers
   using PreviewNumbers = std::set<int>;
-  //! Container for keys
-  using Keys = std::vector<std::string>;
 
   /*!
     @brief Controls all access to the global Params instance.
@@ -121,6 +120,13 @@ class Params : public Util::Getopt {
   */
   static Params& instance();
 
+  /*!
+    @brief Replace the global Params instance with a new one with default
+           settings, to parse another command line in server mode. Must not
+           be called while tasks are running.
+  */
+  static void reset();
+
   //! Prevent copy-construction: not implemented.
   ~Params() = default;
   Params(const Params&) = delete;
@@ -136,6 +142,7 @@ class Params : public Util::Getopt {
     pmXMP,
     pmIccProfile,
     pmRecursive,
+    pmJson,
   };
 
   //! Individual items to print, bitmap
@@ -201,7 +208,7 @@ class Params : public Util::Getopt {
   bool timestampOnly_{false};                     //!< Rename only sets the file timestamp.
   FileExistsPolicy fileExistsPolicy_{askPolicy};  //!< What to do if file to rename exists.
   bool adjust_{false};                            //!< Adjustment flag.
-  PrintMode printMode_{pmSummary};                //!< Print mode.
+  std::vector<PrintMode> printModes_;             //!< Print modes in the order of the options, summary if none.
   PrintItem printItems_{0};                       //!< Print items.
   MetadataId printTags_{Exiv2::mdNone};           //!< Print tags (bitmap of MetadataId flags).
   //! %Action (integer rather than TaskType to avoid dependency).
@@ -220,13 +227,17 @@ class Params : public Util::Getopt {
   std::string suffix_;             //!< File extension of the file to insert
   Files files_;                    //!< List of non-option arguments.
   PreviewNumbers previewNumbers_;  //!< List of preview numbers
-  std::vector<std::regex> greps_;  //!< List of keys to 'grep' from the metadata
-  Keys keys_;                      //!< List of keys to match from the metadata
+  std::vector<std::string> greps_;  //!< Arguments of the -g options, including a trailing "/i"
+  Exiv2::KeyFilter grepFilter_;    //!< Selects the keys which match one of the greps
+  Exiv2::KeyFilter keys_;          //!< Selects the keys to match exactly from the metadata
   std::string charset_;            //!< Charset to use for UNICODE Exif user comment
+  unsigned jobs_{1};               //!< Number of files to process in parallel
+  bool serving_{false};            //!< Server mode, stdin and stdout carry requests and responses
 
   Exiv2::DataBuf stdinBuf;  //!< DataBuf with the binary bytes from stdin
 
  private:
+  static std::unique_ptr<Params> instance_;
   bool first_{true};
 
   Params();
@@ -241,10 +252,12 @@ class Params : public Util::Getopt {
   int evalYodAdjust(const Yod& yod, const std::string& optarg);
   int evalPrint(const std::string& optarg);
   int evalPrintFlags(const std::string& optarg);
+  int addPrintMode(PrintMode mode, const std::string& optarg);
   int evalDelete(const std::string& optarg);
   int evalExtract(const std::string& optarg);
   int evalInsert(const std::string& optarg);
   int evalModify(int opt, const std::string& optarg);
+  int evalJobs(const std::string& optarg);
   //@}
 
  public:
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "corpus.hpp"
+
+#include <map>
+#include <memory>
+
+namespace {
+using Files = std::vector<const Bench::File*>;
+
+size_t totalSize(const Files& files) {
+  size_t size = 0;
+  for (auto&& file : files)
+    size += file->size;
+  return size;
+}
+
+void openAndRead(benchmark::State& state, const Files& files) {
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    for (auto&& file : files) {
+      auto image = Exiv2::ImageFactory::open(file->path, false);
+      image->readMetadata();
+      benchmark::DoNotOptimize(image.get());
+    }
+  }
+  Bench::setCounters(state, files.size(), totalSize(files), Bench::allocations() - allocs);
+}
+
+//! Files in memory, to write their metadata without touching the disk
+using Buffers = std::vector<Exiv2::DataBuf>;
+
+/*!
+  @brief Write the metadata of each of the \em buffers. Add a tag before if
+         \em intrusive is true, which forces the library to rebuild the Exif
+         structure, otherwise it can update the existing one in place.
+ */
+void writeMetadata(benchmark::State& state, const Buffers& buffers, bool intrusive) {
+  uint64_t allocs = 0;
+  size_t bytes = 0;
+  for (auto&& buf : buffers)
+    bytes += buf.size();
+  for (auto _ : state) {
+    for (auto&& buf : buffers) {
+      state.PauseTiming();
+      auto image = Exiv2::ImageFactory::open(buf.c_data(), buf.size());
+      image->readMetadata();
+      if (intrusive)
+        image->exifData()["Exif.Photo.UserComment"] = "charset=Ascii A comment which does not fit anywhere";
+      const uint64_t start = Bench::allocations();
+      state.ResumeTiming();
+      image->writeMetadata();
+      allocs += Bench::allocations() - start;
+    }
+  }
+  Bench::setCounters(state, buffers.size(), bytes, allocs);
+}
+
+//! Return the buffers of the \em files which can be written in both ways
+Buffers writableBuffers(const Files& files) {
+  Buffers buffers;
+  for (auto&& file : files) {
+    try {
+      auto buf = Exiv2::readFile(file->path);
+      for (bool intrusive : {false, true}) {
+        auto image = Exiv2::ImageFactory::open(buf.c_data(), buf.size());
+        image->readMetadata();
+        if (intrusive)
+          image->exifData()["Exif.Photo.UserComment"] = "charset=Ascii A comment";
+        image->writeMetadata();
+      }
+      buffers.push_back(std::move(buf));
+    } catch (const std::exception&) {
+      // The format or this particular file can't be written
+    }
+  }
+  return buffers;
+}
+
+//! An image with previews, with its metadata read
+struct PreviewFile {
+  Exiv2::Image::UniquePtr image;
+  Exiv2::PreviewPropertiesList properties;
+};
+
+void extractPreviews(benchmark::State& state, const std::vector<PreviewFile>& files) {
+  size_t bytes = 0;
+  for (auto&& file : files) {
+    for (auto&& properties : file.properties)
+      bytes += properties.size_;
+  }
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    for (auto&& file : files) {
+      Exiv2::PreviewManager manager(*file.image);
+      for (auto&& properties : manager.getPreviewProperties()) {
+        auto preview = manager.getPreviewImage(properties);
+        benchmark::DoNotOptimize(preview.pData());
+      }
+    }
+  }
+  Bench::setCounters(state, files.size(), bytes, Bench::allocations() - allocs);
+}
+}  // namespace
+
+namespace Bench {
+void registerImageBenchmarks(const std::vector<File>& corpus) {
+  std::map<std::string, Files> formats;
+  for (auto&& file : corpus)
+    formats[file.mimeType].push_back(&file);
+
+  for (auto&& [mimeType, files] : formats) {
+    benchmark::RegisterBenchmark(("readMetadata/" + mimeType).c_str(), openAndRead, files)
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  for (auto&& [mimeType, files] : formats) {
+    auto buffers = std::make_shared<Buffers>(writableBuffers(files));
+    if (buffers->empty())
+      continue;
+    for (bool intrusive : {false, true}) {
+      auto name = std::string(intrusive ? "writeMetadata/intrusive/" : "writeMetadata/nonIntrusive/") + mimeType;
+      benchmark::RegisterBenchmark(name.c_str(), [buffers, intrusive](benchmark::State& state) {
+        writeMetadata(state, *buffers, intrusive);
+      })->Unit(benchmark::kMillisecond);
+    }
+  }
+
+  auto previews = std::make_shared<std::vector<PreviewFile>>();
+  for (auto&& file : corpus) {
+    auto image = Exiv2::ImageFactory::open(file.path, false);
+    image->readMetadata();
+    auto properties = Exiv2::PreviewManager(*image).getPreviewProperties();
+    if (!properties.empty())
+      previews->push_back({std::move(image), std::move(properties)});
+  }
+  benchmark::RegisterBenchmark("previews", [previews](benchmark::State& state) {
+    extractPreviews(state, *previews);
+  })->Unit(benchmark::kMillisecond);
+}
+}  // namespace Bench
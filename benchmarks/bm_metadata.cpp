@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "corpus.hpp"
+
+#include <filesystem>
+#include <memory>
+
+namespace {
+//! Report the number of operations per second and the memory allocations per operation
+void setOpCounters(benchmark::State& state, size_t ops, uint64_t allocs) {
+  using benchmark::Counter;
+  state.counters["ops/s"] = Counter(static_cast<double>(ops), Counter::kIsIterationInvariantRate);
+  if (ops > 0)
+    state.counters["allocs/op"] = Counter(static_cast<double>(allocs) / ops, Counter::kAvgIterations);
+}
+
+//! The metadata of the file with the most tags, which the container benchmarks work on
+struct Metadata {
+  std::string name;  //!< File name, without the directory
+  Exiv2::ExifData exifData;
+  Exiv2::XmpData xmpData;
+  std::string xmpPacket;
+};
+
+//! Look up each key of \em data in \em data with findKey()
+template <typename Data, typename Key>
+void findKey(benchmark::State& state, const Data& data) {
+  std::vector<Key> keys;
+  for (auto&& md : data)
+    keys.emplace_back(md.key());
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    for (auto&& key : keys)
+      benchmark::DoNotOptimize(data.findKey(key));
+  }
+  setOpCounters(state, keys.size(), Bench::allocations() - allocs);
+}
+
+//! Look up each key of \em data in a copy of \em data with operator[]
+template <typename Data>
+void subscript(benchmark::State& state, const Data& data) {
+  Data copy = data;
+  std::vector<std::string> keys;
+  for (auto&& md : data)
+    keys.push_back(md.key());
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    for (auto&& key : keys)
+      benchmark::DoNotOptimize(&copy[key]);
+  }
+  setOpCounters(state, keys.size(), Bench::allocations() - allocs);
+}
+
+void xmpDecode(benchmark::State& state, const std::string& xmpPacket) {
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    Exiv2::XmpData xmpData;
+    Exiv2::XmpParser::decode(xmpData, xmpPacket);
+    benchmark::DoNotOptimize(xmpData.count());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * xmpPacket.size()));
+  setOpCounters(state, 1, Bench::allocations() - allocs);
+}
+
+void xmpEncode(benchmark::State& state, const Exiv2::XmpData& xmpData) {
+  std::string xmpPacket;
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    Exiv2::XmpParser::encode(xmpPacket, xmpData);
+    benchmark::DoNotOptimize(xmpPacket.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * xmpPacket.size()));
+  setOpCounters(state, 1, Bench::allocations() - allocs);
+}
+
+//! Format the value of each tag of \em data, interpreted with print() if \em interpreted is true
+template <typename Data>
+void formatValues(benchmark::State& state, const Data& data, const Exiv2::ExifData* exifData, bool interpreted) {
+  size_t bytes = 0;
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    bytes = 0;
+    for (auto&& md : data)
+      bytes += (interpreted ? md.print(exifData) : md.toString()).size();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+  setOpCounters(state, data.count(), Bench::allocations() - allocs);
+}
+
+//! Encode the metadata to a snapshot
+void snapshotEncode(benchmark::State& state, const Metadata& metadata) {
+  Exiv2::Blob blob;
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    Exiv2::SnapshotParser::encode(blob, metadata.exifData, Exiv2::IptcData(), metadata.xmpData, Exiv2::DataBuf(), "");
+    benchmark::DoNotOptimize(blob.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * blob.size()));
+  setOpCounters(state, 1, Bench::allocations() - allocs);
+}
+
+//! Decode the metadata from a snapshot
+void snapshotDecode(benchmark::State& state, const Metadata& metadata) {
+  Exiv2::Blob blob;
+  Exiv2::SnapshotParser::encode(blob, metadata.exifData, Exiv2::IptcData(), metadata.xmpData, Exiv2::DataBuf(), "");
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    Exiv2::ExifData exifData;
+    Exiv2::IptcData iptcData;
+    Exiv2::XmpData xmpData;
+    Exiv2::DataBuf iccProfile;
+    std::string comment;
+    Exiv2::SnapshotParser::decode(exifData, iptcData, xmpData, iccProfile, comment, blob.data(), blob.size());
+    benchmark::DoNotOptimize(exifData.count());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * blob.size()));
+  setOpCounters(state, 1, Bench::allocations() - allocs);
+}
+
+//! Read the metadata from an EXV file in memory, the alternative to snapshots
+void exvRead(benchmark::State& state, const Metadata& metadata) {
+  auto exv = Exiv2::ImageFactory::create(Exiv2::ImageType::exv);
+  exv->setExifData(metadata.exifData);
+  exv->setXmpData(metadata.xmpData);
+  exv->writeMetadata();
+  Exiv2::DataBuf file(exv->io().size());
+  exv->io().seek(0, Exiv2::BasicIo::beg);
+  exv->io().read(file.data(), file.size());
+  const uint64_t allocs = Bench::allocations();
+  for (auto _ : state) {
+    auto image = Exiv2::ImageFactory::open(file.c_data(), file.size());
+    image->readMetadata();
+    benchmark::DoNotOptimize(image->exifData().count());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file.size()));
+  setOpCounters(state, 1, Bench::allocations() - allocs);
+}
+
+/*!
+  @brief Read the metadata of the file of \em corpus with the most tags counted
+         by \em count, among the camera JPEGs if \em jpeg is true. Files
+         which reproduce bugs, named after the issue, are left out. They have
+         extreme metadata more often than not.
+ */
+Metadata richestFile(const std::vector<Bench::File>& corpus, size_t Bench::File::*count, bool jpeg) {
+  const Bench::File* richest = nullptr;
+  for (auto&& file : corpus) {
+    auto name = std::filesystem::path(file.path).filename().string();
+    if (name.find("issue") != std::string::npos || name.find("poc") != std::string::npos)
+      continue;
+    if (jpeg && file.mimeType != "image/jpeg")
+      continue;
+    if (!richest || file.*count > richest->*count)
+      richest = &file;
+  }
+  if (!richest)
+    richest = &corpus.front();
+  auto image = Exiv2::ImageFactory::open(richest->path, false);
+  image->readMetadata();
+  return {std::filesystem::path(richest->path).filename().string(), image->exifData(), image->xmpData(),
+          image->xmpPacket()};
+}
+}  // namespace
+
+namespace Bench {
+void registerMetadataBenchmarks(const std::vector<File>& corpus) {
+  if (corpus.empty())
+    return;
+  auto exif = std::make_shared<Metadata>(richestFile(corpus, &File::exifCount, true));
+  auto xmp = std::make_shared<Metadata>(richestFile(corpus, &File::xmpCount, false));
+
+  benchmark::RegisterBenchmark("ExifData/findKey", [exif](benchmark::State& state) {
+    state.SetLabel(exif->name);
+    findKey<Exiv2::ExifData, Exiv2::ExifKey>(state, exif->exifData);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("ExifData/operator[]", [exif](benchmark::State& state) {
+    state.SetLabel(exif->name);
+    subscript(state, exif->exifData);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("XmpData/findKey", [xmp](benchmark::State& state) {
+    state.SetLabel(xmp->name);
+    findKey<Exiv2::XmpData, Exiv2::XmpKey>(state, xmp->xmpData);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("XmpData/operator[]", [xmp](benchmark::State& state) {
+    state.SetLabel(xmp->name);
+    subscript(state, xmp->xmpData);
+  })->Unit(benchmark::kMicrosecond);
+
+  benchmark::RegisterBenchmark("XmpParser/decode", [xmp](benchmark::State& state) {
+    state.SetLabel(xmp->name);
+    xmpDecode(state, xmp->xmpPacket);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("XmpParser/encode", [xmp](benchmark::State& state) {
+    state.SetLabel(xmp->name);
+    xmpEncode(state, xmp->xmpData);
+  })->Unit(benchmark::kMicrosecond);
+
+  benchmark::RegisterBenchmark("Snapshot/encode", [exif](benchmark::State& state) {
+    state.SetLabel(exif->name);
+    snapshotEncode(state, *exif);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("Snapshot/decode", [exif](benchmark::State& state) {
+    state.SetLabel(exif->name);
+    snapshotDecode(state, *exif);
+  })->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("Snapshot/exvRead", [exif](benchmark::State& state) {
+    state.SetLabel(exif->name);
+    exvRead(state, *exif);
+  })->Unit(benchmark::kMicrosecond);
+
+  for (bool interpreted : {false, true}) {
+    const std::string method = interpreted ? "/print" : "/toString";
+    benchmark::RegisterBenchmark(("format/Exif" + method).c_str(), [exif, interpreted](benchmark::State& state) {
+      state.SetLabel(exif->name);
+      formatValues(state, exif->exifData, &exif->exifData, interpreted);
+    })->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark(("format/Xmp" + method).c_str(), [xmp, interpreted](benchmark::State& state) {
+      state.SetLabel(xmp->name);
+      formatValues(state, xmp->xmpData, &xmp->exifData, interpreted);
+    })->Unit(benchmark::kMicrosecond);
+  }
+}
+}  // namespace Bench
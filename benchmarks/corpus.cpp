@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "corpus.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+namespace fs = std::filesystem;
+
+namespace {
+std::atomic<uint64_t> allocationCount{0};
+
+size_t logMessages = 0;
+
+void countLogMessage(int, const char*) {
+  ++logMessages;
+}
+}  // namespace
+
+// Count the allocations with the replaceable global allocation functions. This
+// includes the allocations in the library, except for Windows DLLs, which
+// have their own allocation functions.
+void* operator new(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace Bench {
+std::vector<File> loadCorpus(const std::string& dir) {
+  std::vector<std::string> paths;
+  for (auto&& entry : fs::directory_iterator(dir)) {
+    if (entry.is_regular_file())
+      paths.push_back(entry.path().string());
+  }
+  std::sort(paths.begin(), paths.end());
+
+  auto level = Exiv2::LogMsg::level();
+  auto handler = Exiv2::LogMsg::handler();
+  Exiv2::LogMsg::setLevel(Exiv2::LogMsg::warn);
+  Exiv2::LogMsg::setHandler(countLogMessage);
+
+  std::vector<File> corpus;
+  for (auto&& path : paths) {
+    logMessages = 0;
+    try {
+      auto image = Exiv2::ImageFactory::open(path, false);
+      image->readMetadata();
+      if (logMessages == 0) {
+        corpus.push_back({path, image->mimeType(), static_cast<size_t>(fs::file_size(path)),
+                          image->exifData().count(), image->xmpData().count()});
+      }
+    } catch (const std::exception&) {
+      // Not an image or a damaged one, leave it out
+    }
+  }
+
+  Exiv2::LogMsg::setHandler(handler);
+  Exiv2::LogMsg::setLevel(level);
+  return corpus;
+}
+
+uint64_t allocations() {
+  return allocationCount.load(std::memory_order_relaxed);
+}
+
+void setCounters(benchmark::State& state, size_t files, size_t bytes, uint64_t allocs) {
+  using benchmark::Counter;
+  state.counters["files/s"] = Counter(static_cast<double>(files), Counter::kIsIterationInvariantRate);
+  state.counters["MB/s"] = Counter(static_cast<double>(bytes) / 1e6, Counter::kIsIterationInvariantRate);
+  if (files > 0)
+    state.counters["allocs/file"] = Counter(static_cast<double>(allocs) / files, Counter::kAvgIterations);
+}
+}  // namespace Bench
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef BENCHMARKS_CORPUS_HPP_
+#define BENCHMARKS_CORPUS_HPP_
+
+#include <exiv2/exiv2.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Bench {
+//! An image file of the corpus
+struct File {
+  std::string path;      //!< Path of the file
+  std::string mimeType;  //!< MIME type of the image, used to group the files by format
+  size_t size;           //!< Size of the file in bytes
+  size_t exifCount;      //!< Number of Exif tags in the file
+  size_t xmpCount;       //!< Number of XMP properties in the file
+};
+
+/*!
+  @brief Load the files in directory \em dir which exiv2 reads without
+         errors or warnings. Damaged files, like most of the files which
+         reproduce old bugs, are left out. They measure error handling
+         rather than the usual path through the library.
+ */
+std::vector<File> loadCorpus(const std::string& dir);
+
+//! Return the number of memory allocations made by the program so far
+uint64_t allocations();
+
+/*!
+  @brief Report the throughput of a benchmark which processed \em files files
+         with \em bytes bytes in each iteration, and the number of memory
+         allocations per file. \em allocs is the number of allocations made
+         during all iterations.
+ */
+void setCounters(benchmark::State& state, size_t files, size_t bytes, uint64_t allocs);
+
+//! Register the benchmarks of ImageFactory::open(), Image::readMetadata(), writeMetadata() and previews
+void registerImageBenchmarks(const std::vector<File>& corpus);
+
+/*!
+  @brief Register the benchmarks of the metadata containers, the XMP parser, metadata
+         snapshots and the formatting of values
+ */
+void registerMetadataBenchmarks(const std::vector<File>& corpus);
+}  // namespace Bench
+
+#endif  // BENCHMARKS_CORPUS_HPP_
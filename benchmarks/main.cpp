@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "corpus.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  Exiv2::XmpParser::initialize();
+  ::atexit(Exiv2::XmpParser::terminate);
+#ifdef EXV_ENABLE_BMFF
+  Exiv2::enableBMFF();
+#endif
+
+  const char* dir = std::getenv("EXIV2_BENCHMARK_DATA");
+  auto corpus = Bench::loadCorpus(dir ? dir : EXIV2_BENCHMARK_DATA);
+  if (corpus.empty()) {
+    std::cerr << "No image files found in " << (dir ? dir : EXIV2_BENCHMARK_DATA) << "\n";
+    return 1;
+  }
+  // Files which pass the check still have unusual content now and then
+  Exiv2::LogMsg::setLevel(Exiv2::LogMsg::mute);
+
+  Bench::registerImageBenchmarks(corpus);
+  Bench::registerMetadataBenchmarks(corpus);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -65,6 +65,7 @@ OptionOutput( "Building exiv2 command:             " EXIV2_BUILD_EXIV2_COMMAND
 OptionOutput( "Building samples:                   " EXIV2_BUILD_SAMPLES             )
 OptionOutput( "Building unit tests:                " EXIV2_BUILD_UNIT_TESTS          )
 OptionOutput( "Building fuzz tests:                " EXIV2_BUILD_FUZZ_TESTS          )
+OptionOutput( "Building benchmarks:                " EXIV2_BUILD_BENCHMARKS          )
 OptionOutput( "Building doc:                       " EXIV2_BUILD_DOC                 )
 OptionOutput( "Building with coverage flags:       " BUILD_WITH_COVERAGE             )
 OptionOutput( "Using ccache:                       " BUILD_WITH_CCACHE               )
@@ -123,6 +123,12 @@ class EXIV2API BmffImage : public Image {
     @warning This function should only be called by readMetadata()
    */
   long boxHandler(std::ostream& out, Exiv2::PrintStructureOption option, long pbox_end, int depth);
+  /*!
+    @brief Call boxHandler(). In Image::tryReadMetadata(), an error in the box is
+        recorded instead and the box is skipped.
+    @return address of next box
+   */
+  long nextBox(std::ostream& out, Exiv2::PrintStructureOption option, long pbox_end, int depth);
   [[nodiscard]] static std::string indent(int i) {
     return std::string(2 * i, ' ');
   }
@@ -60,14 +60,16 @@ EXIV2API void moveXmpToIptc(XmpData& xmpData, IptcData& iptcData);
   @brief Convert character encoding of \em str from \em from to \em to.
          If the function succeeds, \em str contains the result string.
 
-  This function uses the iconv library, if the %Exiv2 library was compiled
-  with iconv support.  Otherwise, on Windows, it uses Windows functions to
-  support a limited number of conversions and fails with a warning if an
-  unsupported conversion is attempted.  If the function is called but %Exiv2
-  was not compiled with iconv support and can't use Windows functions, it
-  fails with a warning.
-
-  The conversions supported on Windows without iconv are:
+  The conversions listed below are done directly, on all platforms, if the
+  input is valid in the source charset. All other conversions use the iconv
+  library, if the %Exiv2 library was compiled with iconv support.
+  Otherwise, on Windows, it uses Windows functions to support a limited
+  number of conversions and fails with a warning if an unsupported
+  conversion is attempted.  If the function is called but %Exiv2 was not
+  compiled with iconv support and can't use Windows functions, it fails
+  with a warning.
+
+  The conversions supported without iconv are:
 
   <TABLE>
   <TR><TD><B>from</B></TD><TD><B>to</B></TD></TR>
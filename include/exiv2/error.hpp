@@ -16,9 +16,11 @@
 
 #include "config.h"
 
+#include <atomic>     // for atomic
 #include <exception>  // for exception
 #include <sstream>    // for operator<<, ostream, ostringstream, bas...
 #include <string>     // for basic_string, string
+#include <vector>     // for vector
 
 // *****************************************************************************
 // namespace extensions
@@ -41,7 +43,7 @@ namespace Exiv2 {
          which translates to
 
          <code>
-         if (LogMsg::warn >= LogMsg::level() && LogMsg::handler())
+         if (LogMsg::enabled(LogMsg::warn))
              LogMsg(LogMsg::warn).os() << "Warning! Something looks fishy.\n";
          </code>
 
@@ -106,19 +108,25 @@ class EXIV2API LogMsg {
            the log message handler to 0 (or set the log level to \c mute).
    */
   static void setHandler(Handler handler);
-  //! Return the current log level
+  //! Return the log level
   static Level level();
-  //! Return the current log message handler
+  //! Return the log message handler
   static Handler handler();
+  /*!
+    @brief Return true if a log message of \em level is processed in the calling
+           thread: captured by its Diagnostics, if there is one, else passed to
+           the log message handler.
+   */
+  static bool enabled(Level level);
   //! The default log handler. Sends the log message to standard error.
   static void defaultHandler(int level, const char* s);
 
  private:
   // DATA
   // The output level. Only messages with type >= level_ will be written
-  static Level level_;
+  static std::atomic<Level> level_;
   // The log handler in use
-  static Handler handler_;
+  static std::atomic<Handler> handler_;
   // The type of this log message
   const Level msgType_;
   // Holds the log message until it is passed to the message handler
@@ -128,20 +136,20 @@ class EXIV2API LogMsg {
 
 // Macros for simple access
 //! Shorthand to create a temp debug log message object and return its ostringstream
-#define EXV_DEBUG                                            \
-  if (LogMsg::debug >= LogMsg::level() && LogMsg::handler()) \
+#define EXV_DEBUG                     \
+  if (LogMsg::enabled(LogMsg::debug)) \
   LogMsg(LogMsg::debug).os()
 //! Shorthand for a temp info log message object and return its ostringstream
-#define EXV_INFO                                            \
-  if (LogMsg::info >= LogMsg::level() && LogMsg::handler()) \
+#define EXV_INFO                     \
+  if (LogMsg::enabled(LogMsg::info)) \
   LogMsg(LogMsg::info).os()
 //! Shorthand for a temp warning log message object and return its ostringstream
-#define EXV_WARNING                                         \
-  if (LogMsg::warn >= LogMsg::level() && LogMsg::handler()) \
+#define EXV_WARNING                  \
+  if (LogMsg::enabled(LogMsg::warn)) \
   LogMsg(LogMsg::warn).os()
 //! Shorthand for a temp error log message object and return its ostringstream
-#define EXV_ERROR                                            \
-  if (LogMsg::error >= LogMsg::level() && LogMsg::handler()) \
+#define EXV_ERROR                     \
+  if (LogMsg::enabled(LogMsg::error)) \
   LogMsg(LogMsg::error).os()
 
 #ifdef _MSC_VER
@@ -295,6 +303,117 @@ inline std::ostream& operator<<(std::ostream& os, const Error& error) {
   return os << error.what();
 }
 
+/*!
+  @brief Collects the errors found by Image::tryReadMetadata(), which decodes
+         as much metadata as it can from corrupt or truncated files instead of
+         throwing at the first error.
+ */
+class EXIV2API ErrorCollector {
+ public:
+  //! Offset of an error which is not known
+  static constexpr size_t noOffset = static_cast<size_t>(-1);
+
+  //! An error found in the data
+  struct Entry {
+    ErrorCode code;       //!< Error code
+    size_t offset;        //!< Offset of the corrupt data in the file, or noOffset
+    std::string message;  //!< Description of the error
+  };
+
+  //! @name Manipulators
+  //@{
+  //! Add an error
+  void add(ErrorCode code, size_t offset, std::string message);
+  //! Remove all errors
+  void clear();
+  //@}
+
+  //! @name Accessors
+  //@{
+  //! Return the errors in the order they were found
+  [[nodiscard]] const std::vector<Entry>& errors() const;
+  //! Return true if no errors were found
+  [[nodiscard]] bool empty() const;
+  //! Return the number of errors
+  [[nodiscard]] size_t count() const;
+  //@}
+
+ private:
+  std::vector<Entry> errors_;
+};  // class ErrorCollector
+
+/*!
+  @brief Diagnostics sink of the calling thread, to capture the warnings and
+         errors about each file separately when several threads decode files.
+
+  While an object of this class exists, the log messages of the thread which
+  created it go to this object instead of the LogMsg handler, filtered by the
+  level of this object instead of the LogMsg level. LogMsg::level() and
+  LogMsg::handler() still return the global settings, so code which saves and
+  restores them is not affected. The messages of other threads are not
+  affected either, and no locks are taken. Messages below the level are not
+  even formatted.
+
+  Parsers also add structured records for the corrupt data they find, with the
+  error code, the file offset, and the IFD group and tag of TIFF entries. These
+  are kept without formatting any text; text() formats them on request.
+
+  Objects must be destroyed in the thread which created them. They nest: the
+  innermost one receives the messages.
+ */
+class EXIV2API Diagnostics {
+ public:
+  //! A log message or a report of corrupt data
+  struct Record {
+    LogMsg::Level level;  //!< Log level
+    ErrorCode code;       //!< Error code, kerSuccess for log messages
+    size_t offset;        //!< Offset in the file, or ErrorCollector::noOffset
+    const char* group;    //!< Name of the IFD group of a TIFF entry, or nullptr
+    uint16_t tag;         //!< Tag of the TIFF entry, if group is set
+    std::string message;  //!< Description of the problem, or the log message
+
+    //! Return the record as one line of text, without a newline
+    [[nodiscard]] std::string text() const;
+  };
+
+  //! @name Creators
+  //@{
+  //! Start capturing the messages of the calling thread with a level of at least \em level
+  explicit Diagnostics(LogMsg::Level level = LogMsg::warn);
+  //! Stop capturing; the messages go where they went before
+  ~Diagnostics();
+  //@}
+
+  Diagnostics(const Diagnostics&) = delete;
+  Diagnostics& operator=(const Diagnostics&) = delete;
+
+  //! @name Manipulators
+  //@{
+  //! Add a record, if its level is at least the level of this object
+  void add(Record record);
+  //! Remove all records
+  void clear();
+  //@}
+
+  //! @name Accessors
+  //@{
+  //! Return the level
+  [[nodiscard]] LogMsg::Level level() const;
+  //! Return the records in the order they were added
+  [[nodiscard]] const std::vector<Record>& records() const;
+  //! Return the text of all records, one per line
+  [[nodiscard]] std::string text() const;
+  //@}
+
+  //! Return the innermost Diagnostics of the calling thread, nullptr if there is none
+  static Diagnostics* current();
+
+ private:
+  const LogMsg::Level level_;
+  Diagnostics* previous_;
+  std::vector<Record> records_;
+};  // class Diagnostics
+
 #ifdef _MSC_VER
 #pragma warning(default : 4275)
 #endif
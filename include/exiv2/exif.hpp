@@ -57,7 +57,16 @@ class EXIV2API Exifdatum : public Metadatum {
     @throw Error if the key cannot be parsed and converted.
    */
   explicit Exifdatum(const ExifKey& key, const Value* pValue = nullptr);
-  //! Copy constructor
+  /*!
+    @brief Constructor which takes over \em value and shares \em key, which
+           is never modified, with other metadata. Decoders use it to avoid
+           copying keys and values.
+   */
+  Exifdatum(std::shared_ptr<const ExifKey> key, Value::UniquePtr value);
+  /*!
+    @brief Copy constructor. The copy shares the key and value of \em rhs
+           until either of them is modified.
+   */
   Exifdatum(const Exifdatum& rhs);
   //! Destructor
   ~Exifdatum() override = default;
@@ -65,7 +74,7 @@ class EXIV2API Exifdatum : public Metadatum {
 
   //! @name Manipulators
   //@{
-  //! Assignment operator
+  //! Assignment operator, shares the key and value of \em rhs like the copy constructor
   Exifdatum& operator=(const Exifdatum& rhs);
   /*!
     @brief Assign \em value to the %Exifdatum. The type of the new Value
@@ -173,6 +182,7 @@ class EXIV2API Exifdatum : public Metadatum {
   //! Return the value as a string.
   [[nodiscard]] std::string toString() const override;
   [[nodiscard]] std::string toString(size_t n) const override;
+  void appendTo(std::string& out) const override;
   [[nodiscard]] int64_t toInt64(size_t n = 0) const override;
   [[nodiscard]] float toFloat(size_t n = 0) const override;
   [[nodiscard]] Rational toRational(size_t n = 0) const override;
@@ -197,8 +207,8 @@ class EXIV2API Exifdatum : public Metadatum {
 
  private:
   // DATA
-  ExifKey::UniquePtr key_;  //!< Key
-  Value::UniquePtr value_;  //!< Value
+  std::shared_ptr<const ExifKey> key_;  //!< Key, shared with copies
+  std::shared_ptr<Value> value_;        //!< Value, shared with copies until it is modified
 
 };  // class Exifdatum
 
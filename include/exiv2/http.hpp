@@ -7,6 +7,9 @@
 
 #include "datasets.hpp"
 
+#include <memory>
+#include <vector>
+
 namespace Exiv2 {
 /*!
  @brief execute an HTTP request
@@ -16,6 +19,75 @@ namespace Exiv2 {
  @return Server response 200 = OK, 404 = Not Found etc...
 */
 EXIV2API int http(Exiv2::Dictionary& request, Exiv2::Dictionary& response, std::string& errors);
+
+/*!
+  @brief HTTP/1.1 client for one server which keeps its connection open between
+         requests and pipelines several range requests on it.
+
+  The connection is opened by the first request and reopened transparently when the
+  server closes it. Sockets are non-blocking and every wait for the network is a
+  poll() limited by the timeout given to the constructor. The HTTP_PROXY and NO_PROXY
+  environment variables are honoured in the same way as by http().
+ */
+class EXIV2API HttpClient {
+ public:
+  //! A byte range of a resource, first and last byte inclusive as in the Range header
+  using Range = std::pair<uint64_t, uint64_t>;
+
+  //! @name Creators
+  //@{
+  /*!
+    @brief Create a client for a server. No connection is made yet.
+    @param server  Host name or IPv4 address of the server
+    @param port    Port of the server, "80" if empty
+    @param timeout Longest time in milliseconds to wait for the network at a time
+   */
+  explicit HttpClient(const std::string& server, const std::string& port = "", int timeout = 30000);
+  //! Destructor. Closes the connection.
+  ~HttpClient();
+  //@}
+
+  HttpClient(const HttpClient&) = delete;
+  HttpClient& operator=(const HttpClient&) = delete;
+
+  //! @name Manipulators
+  //@{
+  /*!
+    @brief Send one request and read its response.
+    @param verb     Request method, e.g. "GET" or "HEAD"
+    @param page     Path of the resource on the server
+    @param response Filled with the status line (key ""), the response headers and the body (key "body")
+    @param errors   Set to a description of the error if the request failed
+    @param header   Additional request header lines, each terminated with "\r\n"
+    @return The status code of the response, or -1 if there was no response
+   */
+  int request(const std::string& verb, const std::string& page, Dictionary& response, std::string& errors,
+              const std::string& header = "");
+  /*!
+    @brief Get several byte ranges of a resource with pipelined GET requests.
+    @param page   Path of the resource on the server
+    @param ranges The byte ranges to get
+    @param bodies Filled with the data of each range, in the order of ranges. If the
+                  server ignores a Range header, the body is the whole resource.
+    @param errors Set to a description of the error if a request failed
+    @return The highest status code of the responses, or -1 if a response is missing
+   */
+  int get(const std::string& page, const std::vector<Range>& ranges, std::vector<std::string>& bodies,
+          std::string& errors);
+  //! Close the connection. The next request opens a new one.
+  void close();
+  //@}
+
+  //! @name Accessors
+  //@{
+  //! Return the number of connections opened so far
+  [[nodiscard]] size_t connections() const;
+  //@}
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> p_;
+};
 }  // namespace Exiv2
 
 #endif
@@ -88,6 +88,27 @@ class EXIV2API Image {
         type).
    */
   virtual void readMetadata() = 0;
+  /*!
+    @brief Best-effort variant of readMetadata() for files which may be corrupt.
+
+    The parsers record errors in corrupt or truncated data in \em errors and
+    continue with the next entry, IFD, segment or box where they can; no
+    exception reaches the caller. An error which they cannot step over ends
+    the decoding; it is recorded as well and the metadata decoded until then
+    is kept. This includes errors which prevent reading altogether, e.g. if
+    the file cannot be opened.
+
+    Only the TIFF reader checks its entries and directories without throwing.
+    The JPEG, PNG and BMFF parsers, and everything which uses enforce(), still
+    throw an exception for an error; it is caught at the segment, chunk or box
+    which contains the error. This mode therefore spares the caller the
+    exceptions and keeps the metadata of the intact parts, but a corrupt file
+    still costs an exception per corrupt segment, chunk or box.
+
+    @param errors Collector to which the errors found are added
+    @return true if no errors were found
+   */
+  bool tryReadMetadata(ErrorCollector& errors);
   /*!
     @brief Write metadata back to the image.
 
@@ -107,6 +128,12 @@ class EXIV2API Image {
     @param exifData An ExifData instance holding Exif data to be copied
    */
   virtual void setExifData(const ExifData& exifData);
+  /*!
+    @brief Assign new Exif data, moving it instead of copying it. Images which
+        do not support writing Exif data handle it like setExifData(const ExifData&).
+    @param exifData An ExifData instance holding Exif data to be moved
+   */
+  void setExifData(ExifData&& exifData);
   /*!
     @brief Erase any buffered Exif data. Exif data is not removed from
         the actual image until the writeMetadata() method is called.
@@ -118,6 +145,12 @@ class EXIV2API Image {
     @param iptcData An IptcData instance holding IPTC data to be copied
    */
   virtual void setIptcData(const IptcData& iptcData);
+  /*!
+    @brief Assign new IPTC data, moving it instead of copying it. Images which
+        do not support writing IPTC data handle it like setIptcData(const IptcData&).
+    @param iptcData An IptcData instance holding IPTC data to be moved
+   */
+  void setIptcData(IptcData&& iptcData);
   /*!
     @brief Erase any buffered IPTC data. IPTC data is not removed from
         the actual image until the writeMetadata() method is called.
@@ -161,6 +194,12 @@ class EXIV2API Image {
     @param xmpData An XmpData instance holding XMP data to be copied
    */
   virtual void setXmpData(const XmpData& xmpData);
+  /*!
+    @brief Assign new XMP data, moving it instead of copying it. Images which
+        do not support writing XMP data handle it like setXmpData(const XmpData&).
+    @param xmpData An XmpData instance holding XMP data to be moved
+   */
+  void setXmpData(XmpData&& xmpData);
   /*!
     @brief Erase any buffered XMP data. XMP data is not removed from
         the actual image until the writeMetadata() method is called.
@@ -213,7 +252,9 @@ class EXIV2API Image {
   /*!
     @brief Copy all existing metadata from source Image. The data is
         copied into internal buffers and is not written to the image
-        until the writeMetadata() method is called.
+        until the writeMetadata() method is called. The keys and values
+        are shared with the source until either image modifies them; both
+        images can still be read from different threads.
     @param image Metadata source. All metadata types are copied.
    */
   virtual void setMetadata(const Image& image);
@@ -144,6 +144,9 @@ class EXIV2API INIReader {
     @return value
   */
   std::string Get(const std::string& section, const std::string& name, const std::string& default_value);
+  //! @brief Get a string value, like Get(), from a const INIReader.
+  [[nodiscard]] std::string Get(const std::string& section, const std::string& name,
+                                const std::string& default_value) const;
 
   /*! @brief Get an integer (long) value from INI file, returning default_value if
       not found or not a valid integer (decimal "1234", "-1234", or hex "0x4d2").
@@ -155,6 +158,8 @@ class EXIV2API INIReader {
     @return value
   */
   long GetInteger(const std::string& section, const std::string& name, long default_value);
+  //! @brief Get an integer value, like GetInteger(), from a const INIReader.
+  [[nodiscard]] long GetInteger(const std::string& section, const std::string& name, long default_value) const;
 
   /*! @brief Get a real (floating point double) value from INI file, returning
       default_value if not found or not a valid floating point value
@@ -167,6 +172,8 @@ class EXIV2API INIReader {
     @return value
   */
   double GetReal(const std::string& section, const std::string& name, double default_value);
+  //! @brief Get a real value, like GetReal(), from a const INIReader.
+  [[nodiscard]] double GetReal(const std::string& section, const std::string& name, double default_value) const;
 
   /*! @brief Get a boolean value from INI file, returning default_value if not found or if
       not a valid true/false value. Valid true values are "true", "yes", "on", "1",
@@ -179,6 +186,8 @@ class EXIV2API INIReader {
     @return value
   */
   bool GetBoolean(const std::string& section, const std::string& name, bool default_value);
+  //! @brief Get a boolean value, like GetBoolean(), from a const INIReader.
+  [[nodiscard]] bool GetBoolean(const std::string& section, const std::string& name, bool default_value) const;
 
  private:
   int _error;                                  //!< status
@@ -47,7 +47,16 @@ class EXIV2API Iptcdatum : public Metadatum {
            to a tag number and record id.
    */
   explicit Iptcdatum(const IptcKey& key, const Value* pValue = nullptr);
-  //! Copy constructor
+  /*!
+    @brief Constructor which takes over \em value and shares \em key, which
+           is never modified, with other metadata. Decoders use it to avoid
+           copying keys and values.
+   */
+  Iptcdatum(std::shared_ptr<const IptcKey> key, Value::UniquePtr value);
+  /*!
+    @brief Copy constructor. The copy shares the key and value of \em rhs
+           until either of them is modified.
+   */
   Iptcdatum(const Iptcdatum& rhs);
   //! Destructor
   ~Iptcdatum() override = default;
@@ -55,7 +64,7 @@ class EXIV2API Iptcdatum : public Metadatum {
 
   //! @name Manipulators
   //@{
-  //! Assignment operator
+  //! Assignment operator, shares the key and value of \em rhs like the copy constructor
   Iptcdatum& operator=(const Iptcdatum& rhs);
   /*!
     @brief Assign \em value to the %Iptcdatum. The type of the new Value
@@ -122,6 +131,7 @@ class EXIV2API Iptcdatum : public Metadatum {
   [[nodiscard]] size_t size() const override;
   [[nodiscard]] std::string toString() const override;
   [[nodiscard]] std::string toString(size_t n) const override;
+  void appendTo(std::string& out) const override;
   [[nodiscard]] int64_t toInt64(size_t n = 0) const override;
   [[nodiscard]] float toFloat(size_t n = 0) const override;
   [[nodiscard]] Rational toRational(size_t n = 0) const override;
@@ -131,8 +141,8 @@ class EXIV2API Iptcdatum : public Metadatum {
 
  private:
   // DATA
-  IptcKey::UniquePtr key_;  //!< Key
-  Value::UniquePtr value_;  //!< Value
+  std::shared_ptr<const IptcKey> key_;  //!< Key, shared with copies
+  std::shared_ptr<Value> value_;        //!< Value, shared with copies until it is modified
 
 };  // class Iptcdatum
 
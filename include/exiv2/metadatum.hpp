@@ -201,6 +201,15 @@ class EXIV2API Metadatum {
            is no <EM>n</EM>-th component.
    */
   [[nodiscard]] virtual std::string toString(size_t n) const = 0;
+  /*!
+    @brief Append the value, converted to a string as by toString(), to
+           \em out. Nothing is appended if the value is not set.
+
+    The default implementation appends toString(). The Exif, IPTC and XMP
+    datums use Value::format() instead, so that rendering many values does
+    not create an output stream per value.
+   */
+  virtual void appendTo(std::string& out) const;
   /*!
     @brief Return the <EM>n</EM>-th component of the value converted to int64_t.
            The return value is -1 if the value is not set and the behaviour
@@ -261,6 +270,12 @@ class EXIV2API Metadatum {
            by subclasses but not directly.
    */
   Metadatum& operator=(const Metadatum&) = default;
+  /*!
+    @brief Make \em value the only owner of its %Value, cloning it if it is
+           shared with copies of the metadatum. Subclasses share the keys and
+           values of copies and call this before they modify a value in place.
+   */
+  static void detach(std::shared_ptr<Value>& value);
   //@}
 
 };  // class Metadatum
@@ -284,6 +299,55 @@ EXIV2API bool cmpMetadataByTag(const Metadatum& lhs, const Metadatum& rhs);
  */
 EXIV2API bool cmpMetadataByKey(const Metadatum& lhs, const Metadatum& rhs);
 
+/*!
+  @brief Select metadata by key, e.g., to print or decode only some of the tags.
+
+  A key is selected if it equals one of the keys added with addKey() or if
+  one of the patterns added with addPattern() matches part of it, like
+  std::regex_search() with a POSIX basic regular expression. Patterns which
+  are plain text, with optional '^' and '$' anchors, '.' wildcards and
+  escaped special characters, are matched with a hash set, a prefix trie or
+  a plain search. Only other patterns are matched with std::regex.
+ */
+class EXIV2API KeyFilter {
+ public:
+  //! @name Creators
+  //@{
+  //! Default constructor, creates a filter which selects no keys.
+  KeyFilter();
+  //! Destructor
+  ~KeyFilter();
+  //! Copy constructor
+  KeyFilter(const KeyFilter& rhs);
+  //@}
+
+  //! @name Manipulators
+  //@{
+  //! Assignment operator
+  KeyFilter& operator=(const KeyFilter& rhs);
+  //! Select keys equal to \em key
+  void addKey(const std::string& key);
+  /*!
+    @brief Select keys which the regular expression \em pattern in POSIX
+           basic syntax matches a part of.
+    @throw std::regex_error if \em pattern is not a valid regular expression.
+   */
+  void addPattern(const std::string& pattern, bool ignoreCase = false);
+  //@}
+
+  //! @name Accessors
+  //@{
+  //! Return true if no keys and patterns were added
+  [[nodiscard]] bool empty() const;
+  //! Return true if \em key is selected
+  [[nodiscard]] bool matches(const std::string& key) const;
+  //@}
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> p_;
+};
+
 }  // namespace Exiv2
 
 #endif  // #ifndef METADATUM_HPP_
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef SNAPSHOT_HPP_
+#define SNAPSHOT_HPP_
+
+#include "exiv2lib_export.h"
+
+#include "types.hpp"
+
+#include <string>
+
+namespace Exiv2 {
+// Forward declarations
+class ExifData;
+class Image;
+class IptcData;
+class XmpData;
+
+/*!
+  @brief Stateless parser class for metadata snapshots, a compact binary form of the
+         Exif, IPTC and XMP metadata, the ICC profile and the comment of an image.
+
+  Snapshots are meant to be kept in a cache and read back by the same or a later
+  version of the library, which is much faster than writing and reading an EXV
+  file because no TIFF structure is built or parsed. Exif and IPTC keys are
+  stored as numbers, values as their type id and their bytes in little endian
+  order, and the strings of XMP metadata in a table in which each string occurs
+  once.
+
+  A snapshot starts with the magic "Exv2Snap" and a version. The decoder rejects
+  snapshots of other versions, which should then be created again from the image.
+
+  Decoding is not zero-copy: each Value owns its data, so the values are created
+  from the bytes in the buffer, while the keys are shared between snapshots. For
+  Exif metadata decoding is about 5 times faster than reading an EXV file, short
+  of an order of magnitude because every entry still allocates its list node and
+  its value.
+ */
+class EXIV2API SnapshotParser {
+ public:
+  //! Version of the snapshot format written by encode()
+  static constexpr uint16_t version_ = 1;
+
+  /*!
+    @brief Encode metadata to a snapshot.
+
+    @param blob       Container for the snapshot, which is replaced.
+    @param exifData   Exif metadata to encode.
+    @param iptcData   IPTC metadata to encode.
+    @param xmpData    XMP metadata to encode.
+    @param iccProfile ICC profile to encode, may be empty.
+    @param comment    Comment to encode, may be empty.
+   */
+  static void encode(Blob& blob, const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData,
+                     const DataBuf& iccProfile, const std::string& comment);
+  //! Encode the metadata, ICC profile and comment of \em image to a snapshot in \em blob.
+  static void encode(Blob& blob, const Image& image);
+
+  /*!
+    @brief Decode a snapshot from a buffer \em pData of length \em size to the
+           provided containers, which are replaced.
+
+    XMP namespaces of the snapshot which are not known yet are registered with
+    XmpProperties::registerNs() once the snapshot was decoded successfully.
+
+    @throw Error if the buffer is not a snapshot of this version or it is corrupt,
+           or it uses a prefix of another namespace. The containers and the XMP
+           namespaces are not changed in that case.
+   */
+  static void decode(ExifData& exifData, IptcData& iptcData, XmpData& xmpData, DataBuf& iccProfile,
+                     std::string& comment, const byte* pData, size_t size);
+  /*!
+    @brief Decode a snapshot to \em image like Image::setMetadata(). Only the types
+           of metadata which the image can write are set.
+
+    @throw Error if the buffer is not a snapshot of this version or it is corrupt.
+   */
+  static void decode(Image& image, const byte* pData, size_t size);
+};  // class SnapshotParser
+
+}  // namespace Exiv2
+
+#endif  // SNAPSHOT_HPP_
@@ -10,6 +10,7 @@
 #include "types.hpp"
 
 // + standard includes
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <iomanip>
@@ -39,7 +40,8 @@ class EXIV2API Value {
   //@{
   //! Constructor, taking a type id to initialize the base class with
   explicit Value(TypeId typeId);
-  Value(const Value&) = default;
+  //! Copy constructor
+  Value(const Value& rhs);
   //! Virtual destructor.
   virtual ~Value() = default;
   //@}
@@ -128,6 +130,22 @@ class EXIV2API Value {
            component.
    */
   virtual std::string toString(size_t n) const;
+  /*!
+    @brief Format the value into \em buf, which has room for \em n
+           characters including the terminating '\\0'. The output is the
+           same as that of toString(), but the concrete classes write it
+           without going through an output stream.
+
+    Like snprintf(), the output is truncated to fit and is always
+    terminated unless \em n is 0. The default implementation is based on
+    write(std::ostream& os) const.
+
+    @return Length of the complete output, not counting the terminating
+            '\\0'. The output was truncated if this is not less than \em n.
+   */
+  virtual size_t format(char* buf, size_t n) const;
+  //! Append the value, formatted as by format(), to \em out.
+  void appendTo(std::string& out) const;
   /*!
     @brief Convert the <EM>n</EM>-th component of the value to an int64_t.
            The behaviour of this method may be undefined if there is no
@@ -178,6 +196,8 @@ class EXIV2API Value {
   /*!
     @brief Check the \em ok status indicator. After a to<Type> conversion,
            this indicator shows whether the conversion was successful.
+           Copies of a metadatum share their value, so the indicator may
+           also show a conversion done by another thread at the same time.
    */
   bool ok() const {
     return ok_;
@@ -227,9 +247,9 @@ class EXIV2API Value {
     @brief Assignment operator. Protected so that it can only be used
            by subclasses but not directly.
    */
-  Value& operator=(const Value&) = default;
+  Value& operator=(const Value& rhs);
   // DATA
-  mutable bool ok_;  //!< Indicates the status of the previous to<Type> conversion
+  mutable std::atomic<bool> ok_{true};  //!< Indicates the status of the previous to<Type> conversion
 
  private:
   //! Internal virtual copy constructor.
@@ -284,6 +304,7 @@ class EXIV2API DataValue : public Value {
   size_t count() const override;
   size_t size() const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   /*!
     @brief Return the <EM>n</EM>-th component of the value as a string.
            The behaviour of this method may be undefined if there is no
@@ -363,6 +384,7 @@ class EXIV2API StringValueBase : public Value {
   float toFloat(size_t n = 0) const override;
   Rational toRational(size_t n = 0) const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //@}
 
  protected:
@@ -455,6 +477,7 @@ class EXIV2API AsciiValue : public StringValueBase {
            written to the output stream.
   */
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //@}
 
  private:
@@ -548,6 +571,7 @@ class EXIV2API CommentValue : public StringValueBase {
     read(const std::string& comment).
    */
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   /*!
     @brief Return the comment (without a charset="..." prefix)
 
@@ -728,6 +752,7 @@ class EXIV2API XmpTextValue : public XmpValue {
    */
   Rational toRational(size_t n = 0) const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //@}
 
  private:
@@ -797,6 +822,7 @@ class EXIV2API XmpArrayValue : public XmpValue {
           for read().
    */
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //@}
 
  private:
@@ -898,6 +924,7 @@ class EXIV2API LangAltValue : public XmpValue {
           for read().
    */
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //@}
 
  private:
@@ -988,6 +1015,7 @@ class EXIV2API DateValue : public Value {
   size_t count() const override;
   size_t size() const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //! Return the value as a UNIX calender time converted to int64_t.
   int64_t toInt64(size_t n = 0) const override;
   //! Return the value as a UNIX calender time converted to uint32_t.
@@ -1085,6 +1113,7 @@ class EXIV2API TimeValue : public Value {
   size_t count() const override;
   size_t size() const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   //! Returns number of seconds in the day in UTC.
   int64_t toInt64(size_t n = 0) const override;
   //! Returns number of seconds in the day in UTC.
@@ -1107,6 +1136,50 @@ class EXIV2API TimeValue : public Value {
 
 };  // class TimeValue
 
+/*!
+  @brief Compact, normalised representation of a date and an optional time
+         of day, as produced by parseTimestamp().
+ */
+struct EXIV2API Timestamp {
+  int32_t year{0};          //!< Year
+  uint8_t month{0};         //!< Month, 1-12
+  uint8_t day{0};           //!< Day of the month, 1-31
+  uint8_t hour{0};          //!< Hour, 0-23
+  uint8_t minute{0};        //!< Minute, 0-59
+  uint8_t second{0};        //!< Second, 0-60 (leap second)
+  bool hasTime{false};      //!< True if the string contained a time of day
+  bool hasTimeZone{false};  //!< True if the string contained a time zone designator
+  bool ok{false};           //!< True if the string could be parsed
+  int16_t tzOffset{0};      //!< Offset from UTC in minutes, 0 if there is no time zone
+};
+
+/*!
+  @brief Parse a date or date and time string in one of the formats used by
+         Exif, XMP and IPTC into a Timestamp.
+
+  Supported formats are
+  - Exif: <tt>YYYY:MM:DD[ HH:MM:SS]</tt>
+  - XMP (ISO 8601): <tt>YYYY[-MM[-DD[Thh:mm[:ss[.s]][TZD]]]]</tt>, where TZD
+    is \c Z or <tt>+hh:mm</tt> / <tt>-hh:mm</tt>
+  - IPTC: <tt>YYYYMMDD[Thhmmss[+hhmm]]</tt> and the extended forms written by
+    DateValue and TimeValue
+
+  Missing month and day default to 1, a missing time to midnight. Fractions
+  of a second are ignored.
+
+  @param str String to parse
+  @param ts Timestamp to write the result to. Its \em ok member is set to
+         false if the string can't be parsed.
+  @return The value of \em ts.ok
+ */
+EXIV2API bool parseTimestamp(const std::string& str, Timestamp& ts);
+
+/*!
+  @brief Parse and normalise a batch of date strings, see parseTimestamp().
+         The result has one entry per input string, in the same order.
+ */
+EXIV2API std::vector<Timestamp> parseTimestamps(const std::vector<std::string>& strs);
+
 //! Template to determine the TypeId for a type T
 template <typename T>
 TypeId getType();
@@ -1210,6 +1283,7 @@ class ValueType : public Value {
   size_t count() const override;
   size_t size() const override;
   std::ostream& write(std::ostream& os) const override;
+  size_t format(char* buf, size_t n) const override;
   /*!
     @brief Return the <EM>n</EM>-th component of the value as a string.
            The behaviour of this method may be undefined if there is no
@@ -1581,6 +1655,28 @@ std::ostream& ValueType<T>::write(std::ostream& os) const {
   return os;
 }
 
+// Default implementation, specialized for the types used by Value::create()
+template <typename T>
+size_t ValueType<T>::format(char* buf, size_t n) const {
+  return Value::format(buf, n);
+}
+template <>
+EXIV2API size_t ValueType<uint16_t>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<uint32_t>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<int16_t>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<int32_t>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<URational>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<Rational>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<float>::format(char* buf, size_t n) const;
+template <>
+EXIV2API size_t ValueType<double>::format(char* buf, size_t n) const;
+
 template <typename T>
 std::string ValueType<T>::toString(size_t n) const {
   ok_ = true;
@@ -1646,16 +1742,18 @@ float ValueType<T>::toFloat(size_t n) const {
 // Specialization for rational
 template <>
 inline float ValueType<Rational>::toFloat(size_t n) const {
-  ok_ = (value_.at(n).second != 0);
-  if (!ok_)
+  const bool ok = value_.at(n).second != 0;
+  ok_ = ok;
+  if (!ok)
     return 0.0f;
   return static_cast<float>(value_.at(n).first) / value_.at(n).second;
 }
 // Specialization for unsigned rational
 template <>
 inline float ValueType<URational>::toFloat(size_t n) const {
-  ok_ = (value_.at(n).second != 0);
-  if (!ok_)
+  const bool ok = value_.at(n).second != 0;
+  ok_ = ok;
+  if (!ok)
     return 0.0f;
   return static_cast<float>(value_.at(n).first) / value_.at(n).second;
 }
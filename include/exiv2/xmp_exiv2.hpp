@@ -43,7 +43,16 @@ class EXIV2API Xmpdatum : public Metadatum {
            to a known schema namespace prefix and property name.
    */
   explicit Xmpdatum(const XmpKey& key, const Value* pValue = nullptr);
-  //! Copy constructor
+  /*!
+    @brief Constructor which takes over \em value and shares \em key, which
+           is never modified, with other metadata. Decoders use it to avoid
+           copying keys and values.
+   */
+  Xmpdatum(std::shared_ptr<const XmpKey> key, Value::UniquePtr value);
+  /*!
+    @brief Copy constructor. The copy shares the key and value of \em rhs
+           until either of them is modified.
+   */
   Xmpdatum(const Xmpdatum& rhs);
   //! Destructor
   ~Xmpdatum() override;
@@ -51,7 +60,7 @@ class EXIV2API Xmpdatum : public Metadatum {
 
   //! @name Manipulators
   //@{
-  //! Assignment operator
+  //! Assignment operator, shares the key and value of \em rhs like the copy constructor
   Xmpdatum& operator=(const Xmpdatum& rhs);
   /*!
     @brief Assign std::string \em value to the %Xmpdatum.
@@ -119,6 +128,7 @@ class EXIV2API Xmpdatum : public Metadatum {
   [[nodiscard]] size_t size() const override;
   [[nodiscard]] std::string toString() const override;
   [[nodiscard]] std::string toString(size_t n) const override;
+  void appendTo(std::string& out) const override;
   [[nodiscard]] int64_t toInt64(size_t n = 0) const override;
   [[nodiscard]] float toFloat(size_t n = 0) const override;
   [[nodiscard]] Rational toRational(size_t n = 0) const override;
@@ -2,6 +2,7 @@
 
 // included header files
 #include "basicio.hpp"
+#include "blockcache_int.hpp"
 #include "config.h"
 #include "datasets.hpp"
 #include "enforce.hpp"
@@ -15,6 +16,7 @@
 #include <fcntl.h>     // _O_BINARY in FileIo::FileIo
 #include <sys/stat.h>  // for stat, chmod
 
+#include <algorithm>
 #include <cstdio>   // for remove, rename
 #include <cstdlib>  // for alloc, realloc, free
 #include <cstring>  // std::memcpy
@@ -1001,10 +1003,16 @@ class RemoteIo::Impl {
   bool eof_;             //!< EOF indicator
   Protocol protocol_;    //!< the protocol of url
   size_t totalRead_;     //!< bytes requested from host
+  size_t readAhead_;     //!< bytes fetched after a missing block, grows while the misses are sequential
+  size_t nextBlock_;     //!< block after the last range fetched
+  bool tailFetched_;     //!< was the end of the file requested with the first fetch?
+
+  std::string validator_;                        //!< ETag or Last-Modified of the remote file, empty if unknown
+  std::unique_ptr<Internal::BlockCache> cache_;  //!< on-disk cache of the blocks, if EXIV2_CACHE_DIR is set
 
   // METHODS
   /*!
-    @brief Get the length (in bytes) of the remote file.
+    @brief Get the length (in bytes) of the remote file and set validator_ if the server sends one.
     @return Return -1 if the size is unknown. Otherwise it returns the length of remote file (in bytes).
     @throw Error if the server returns the error code.
    */
@@ -1030,14 +1038,34 @@ class RemoteIo::Impl {
     @throw Error if it fails.
    */
   virtual void writeRemote(const byte* data, size_t size, size_t from, size_t to) = 0;
+  /*!
+    @brief Get the data of several block ranges. The default implementation calls getDataByRange()
+          for each range, protocols which can send several requests at once override it.
+    @param ranges The start and end block indices of each range.
+    @param responses The data from the server for each range.
+    @throw Error if the server returns the error code.
+   */
+  virtual void getDataByRanges(const std::vector<std::pair<size_t, size_t>>& ranges,
+                               std::vector<std::string>& responses);
   /*!
     @brief Get the data from the remote machine and write them to the memory blocks.
+
+    The missing blocks between lowBlock and highBlock are fetched together with the missing
+    blocks which follow them, as parsers tend to read on from where they are. The read-ahead
+    doubles while each miss starts where the previous fetch ended. The first fetch also takes
+    the missing blocks of the last 64 KB, where many formats keep metadata. Missing runs
+    separated by a few populated blocks are merged into one range, and all ranges are
+    requested at once.
     @param lowBlock The start block index.
     @param highBlock The end block index.
     @return Number of bytes written to the memory block successfully
     @throw Error if it fails.
    */
   virtual size_t populateBlocks(size_t lowBlock, size_t highBlock);
+  //! Return the number of blocks
+  [[nodiscard]] size_t blocks() const;
+  //! Populate the missing blocks from lowBlock onwards with data
+  void storeBlocks(size_t lowBlock, const std::string& data);
 
 };  // class RemoteIo::Impl
 
@@ -1050,35 +1078,106 @@ RemoteIo::Impl::Impl(const std::string& url, size_t blockSize) :
     isMalloced_(false),
     eof_(false),
     protocol_(fileProtocol(url)),
-    totalRead_(0) {
+    totalRead_(0),
+    readAhead_(0),
+    nextBlock_(0),
+    tailFetched_(false) {
+}
+
+//! Least and most number of bytes fetched from the remote file when a read misses
+static constexpr size_t minReadAhead = 64 * 1024;
+static constexpr size_t maxReadAhead = 1024 * 1024;
+//! Missing runs of blocks closer than this number of bytes are fetched as one range
+static constexpr size_t coalesceGap = 16 * 1024;
+//! Number of bytes at the end of the remote file fetched together with the first missing blocks
+static constexpr size_t tailPrefetch = 64 * 1024;
+
+void RemoteIo::Impl::getDataByRanges(const std::vector<std::pair<size_t, size_t>>& ranges,
+                                     std::vector<std::string>& responses) {
+  responses.resize(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i)
+    getDataByRange(ranges[i].first, ranges[i].second, responses[i]);
+}
+
+size_t RemoteIo::Impl::blocks() const {
+  return (size_ + blockSize_ - 1) / blockSize_;
+}
+
+void RemoteIo::Impl::storeBlocks(size_t lowBlock, const std::string& data) {
+  auto source = reinterpret_cast<const byte*>(data.data());
+  for (size_t iBlock = lowBlock, totalRead = 0; totalRead < data.size() && iBlock < blocks(); iBlock++) {
+    size_t allow = std::min(data.size() - totalRead, blockSize_);
+    if (blocksMap_[iBlock].isNone()) {
+      blocksMap_[iBlock].populate(const_cast<byte*>(&source[totalRead]), allow);
+      if (cache_)
+        cache_->put(iBlock, &source[totalRead], allow);
+    }
+    totalRead += allow;
+  }
 }
 
 size_t RemoteIo::Impl::populateBlocks(size_t lowBlock, size_t highBlock) {
-  // optimize: ignore all true blocks on left & right sides.
-  while (!blocksMap_[lowBlock].isNone() && lowBlock < highBlock)
-    lowBlock++;
-  while (!blocksMap_[highBlock].isNone() && highBlock > lowBlock)
-    highBlock--;
+  if (blocks() == 0)
+    return 0;
+  highBlock = std::min(highBlock, blocks() - 1);
+  const size_t gap = std::max<size_t>(coalesceGap / blockSize_, 1);
+
+  if (cache_) {
+    for (size_t iBlock = lowBlock; iBlock <= highBlock; iBlock++) {
+      if (!blocksMap_[iBlock].isNone())
+        continue;
+      DataBuf block = cache_->get(iBlock);
+      if (!block.empty())
+        blocksMap_[iBlock].populate(block.data(), block.size());
+    }
+  }
 
+  // plan the ranges of missing blocks
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (size_t iBlock = lowBlock; iBlock <= highBlock; iBlock++) {
+    if (!blocksMap_[iBlock].isNone())
+      continue;
+    if (ranges.empty() || iBlock - ranges.back().second > gap)
+      ranges.emplace_back(iBlock, iBlock);
+    else
+      ranges.back().second = iBlock;
+  }
+  if (ranges.empty())
+    return 0;
+  readAhead_ = ranges.front().first == nextBlock_ ? std::clamp(2 * readAhead_, minReadAhead, maxReadAhead)
+                                                 : minReadAhead;
+  const size_t ahead = ranges.back().first + std::max<size_t>(readAhead_ / blockSize_, 1) - 1;
+  while (ranges.back().second < std::min(ahead, blocks() - 1) && blocksMap_[ranges.back().second + 1].isNone() &&
+         !(cache_ && cache_->has(ranges.back().second + 1)))
+    ranges.back().second++;
+
+  nextBlock_ = ranges.back().second + 1;
+
+  // BMFF moov and meta boxes, PNG text chunks and TIFF IFDs are often at the end of the file
+  if (!tailFetched_) {
+    tailFetched_ = true;
+    const size_t tail = std::min(std::max<size_t>(tailPrefetch / blockSize_, 1), blocks());
+    for (size_t iBlock = blocks() - tail; iBlock < blocks(); iBlock++) {
+      if (iBlock <= ranges.back().second || !blocksMap_[iBlock].isNone() || (cache_ && cache_->has(iBlock)))
+        continue;
+      if (iBlock - ranges.back().second > gap)
+        ranges.emplace_back(iBlock, iBlock);
+      else
+        ranges.back().second = iBlock;
+    }
+  }
+
+  std::vector<std::string> responses;
+  getDataByRanges(ranges, responses);
   size_t rcount = 0;
-  if (blocksMap_[highBlock].isNone()) {
-    std::string data;
-    getDataByRange(lowBlock, highBlock, data);
-    rcount = data.length();
-    if (rcount == 0) {
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const std::string& data = responses[i];
+    if (data.empty()) {
       throw Error(ErrorCode::kerErrorMessage, "Data By Range is empty. Please check the permission.");
     }
-    auto source = reinterpret_cast<byte*>(const_cast<char*>(data.c_str()));
-    size_t remain = rcount, totalRead = 0;
-    size_t iBlock = (rcount == size_) ? 0 : lowBlock;
-
-    while (remain) {
-      size_t allow = std::min(remain, blockSize_);
-      blocksMap_[iBlock].populate(&source[totalRead], allow);
-      remain -= allow;
-      totalRead += allow;
-      iBlock++;
-    }
+    // a server which ignores the range sends the whole file
+    storeBlocks(data.length() == size_ ? 0 : ranges[i].first, data);
+    rcount += data.length();
   }
 
   return rcount;
@@ -1108,15 +1207,7 @@ int RemoteIo::open() {
       size_t nBlocks = (p_->size_ + p_->blockSize_ - 1) / p_->blockSize_;
       p_->blocksMap_ = new BlockMap[nBlocks];
       p_->isMalloced_ = true;
-      auto source = reinterpret_cast<byte*>(const_cast<char*>(data.c_str()));
-      size_t remain = p_->size_, iBlock = 0, totalRead = 0;
-      while (remain) {
-        size_t allow = std::min(remain, p_->blockSize_);
-        p_->blocksMap_[iBlock].populate(&source[totalRead], allow);
-        remain -= allow;
-        totalRead += allow;
-        iBlock++;
-      }
+      p_->storeBlocks(0, data);
     } else if (length == 0) {  // file is empty
       throw Error(ErrorCode::kerErrorMessage, "the file length is 0");
     } else {
@@ -1124,6 +1215,14 @@ int RemoteIo::open() {
       size_t nBlocks = (p_->size_ + p_->blockSize_ - 1) / p_->blockSize_;
       p_->blocksMap_ = new BlockMap[nBlocks];
       p_->isMalloced_ = true;
+      const std::string cacheDir = getEnv(envCACHEDIR);
+      if (!cacheDir.empty() && !p_->validator_.empty()) {
+        const uint64_t limit = std::strtoull(getEnv(envCACHESIZE).c_str(), nullptr, 10) * 1024 * 1024;
+        p_->cache_ = std::make_unique<Internal::BlockCache>(cacheDir, limit, p_->path_, p_->validator_, p_->size_,
+                                                            p_->blockSize_);
+        if (!p_->cache_->isOpen())
+          p_->cache_.reset();
+      }
     }
   }
   return 0;  // means OK
@@ -1213,6 +1312,12 @@ size_t RemoteIo::write(BasicIo& src) {
     src.seek(left, BasicIo::beg);
     src.read(data.data(), dataSize);
     p_->writeRemote(data.data(), dataSize, left, p_->size_ - right);
+    // the cached blocks belong to the old version of the file
+    const std::string cacheDir = getEnv(envCACHEDIR);
+    if (!cacheDir.empty()) {
+      p_->cache_.reset();
+      Internal::BlockCache::invalidate(cacheDir, p_->path_);
+    }
   }
   return src.size();
 }
@@ -1238,7 +1343,7 @@ size_t RemoteIo::read(byte* buf, size_t rcount) {
 
   size_t allow = std::min(rcount, (p_->size_ - p_->idx_));
   size_t lowBlock = p_->idx_ / p_->blockSize_;
-  size_t highBlock = (p_->idx_ + allow) / p_->blockSize_;
+  size_t highBlock = (p_->idx_ + (allow ? allow - 1 : 0)) / p_->blockSize_;
 
   // connect to the remote machine & populate the blocks just in time.
   p_->populateBlocks(lowBlock, highBlock);
@@ -1318,13 +1423,15 @@ int RemoteIo::seek(int64_t offset, Position pos) {
 byte* RemoteIo::mmap(bool /*isWriteable*/) {
   size_t nRealData = 0;
   if (!bigBlock_) {
+    // parsers like TiffParser follow offsets anywhere in the mapped file, fetch all missing blocks at once
+    p_->populateBlocks(0, p_->blocks());
     size_t blockSize = p_->blockSize_;
-    size_t blocks = (p_->size_ + blockSize - 1) / blockSize;
-    bigBlock_ = new byte[blocks * blockSize];
+    size_t blocks = p_->blocks();
+    bigBlock_ = new byte[blocks * blockSize]();
     for (size_t block = 0; block < blocks; block++) {
       void* p = p_->blocksMap_[block].getData();
       if (p) {
-        size_t nRead = block == (blocks - 1) ? p_->size_ - nRealData : blockSize;
+        size_t nRead = p_->blocksMap_[block].getSize();
         memcpy(bigBlock_ + (block * blockSize), p, nRead);
         nRealData += nRead;
       }
@@ -1378,7 +1485,8 @@ class HttpIo::HttpImpl : public Impl {
  public:
   //! Constructor
   HttpImpl(const std::string& url, size_t blockSize);
-  Exiv2::Uri hostInfo_;  //!< the host information extracted from the path
+  Exiv2::Uri hostInfo_;                 //!< the host information extracted from the path
+  std::unique_ptr<HttpClient> client_;  //!< persistent connection to the host for HEAD and GET requests
 
   ~HttpImpl() override = default;
 
@@ -1398,6 +1506,14 @@ class HttpIo::HttpImpl : public Impl {
     @note Set lowBlock = -1 and highBlock = -1 to get the whole file content.
    */
   void getDataByRange(size_t lowBlock, size_t highBlock, std::string& response) override;
+  /*!
+    @brief Get the data of several block ranges with pipelined requests on one connection.
+    @param ranges The start and end block indices of each range.
+    @param responses The data from the server for each range.
+    @throw Error if the server returns the error code.
+   */
+  void getDataByRanges(const std::vector<std::pair<size_t, size_t>>& ranges,
+                       std::vector<std::string>& responses) override;
   /*!
     @brief Submit the data to the remote machine. The data replace a part of the remote file.
           The replaced part of remote file is indicated by from and to parameters.
@@ -1421,46 +1537,54 @@ class HttpIo::HttpImpl : public Impl {
 HttpIo::HttpImpl::HttpImpl(const std::string& url, size_t blockSize) : Impl(url, blockSize) {
   hostInfo_ = Exiv2::Uri::Parse(url);
   Exiv2::Uri::Decode(hostInfo_);
+  client_ = std::make_unique<HttpClient>(hostInfo_.Host, hostInfo_.Port);
 }
 
 long HttpIo::HttpImpl::getFileLength() {
   Exiv2::Dictionary response;
-  Exiv2::Dictionary request;
   std::string errors;
-  request["server"] = hostInfo_.Host;
-  request["page"] = hostInfo_.Path;
-  if (!hostInfo_.Port.empty())
-    request["port"] = hostInfo_.Port;
-  request["verb"] = "HEAD";
-  int serverCode = http(request, response, errors);
+  int serverCode = client_->request("HEAD", hostInfo_.Path, response, errors);
   if (serverCode < 0 || serverCode >= 400 || !errors.empty()) {
     throw Error(ErrorCode::kerFileOpenFailed, "http", Exiv2::Internal::stringFormat("%d", serverCode), hostInfo_.Path);
   }
 
+  for (auto&& [key, value] : response) {
+    std::string name(key);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (name == "etag" || (name == "last-modified" && validator_.empty()))
+      validator_ = value;
+  }
+
   auto lengthIter = response.find("Content-Length");
   return (lengthIter == response.end()) ? -1 : atol((lengthIter->second).c_str());
 }
 
 void HttpIo::HttpImpl::getDataByRange(size_t lowBlock, size_t highBlock, std::string& response) {
+  if (lowBlock != std::numeric_limits<size_t>::max() && highBlock != std::numeric_limits<size_t>::max()) {
+    std::vector<std::string> responses;
+    getDataByRanges({{lowBlock, highBlock}}, responses);
+    response = std::move(responses.front());
+    return;
+  }
   Exiv2::Dictionary responseDic;
-  Exiv2::Dictionary request;
-  request["server"] = hostInfo_.Host;
-  request["page"] = hostInfo_.Path;
-  if (!hostInfo_.Port.empty())
-    request["port"] = hostInfo_.Port;
-  request["verb"] = "GET";
   std::string errors;
-  if (lowBlock != std::numeric_limits<size_t>::max() && highBlock != std::numeric_limits<size_t>::max()) {
-    std::stringstream ss;
-    ss << "Range: bytes=" << lowBlock * blockSize_ << "-" << ((highBlock + 1) * blockSize_ - 1) << "\r\n";
-    request["header"] = ss.str();
+  int serverCode = client_->request("GET", hostInfo_.Path, responseDic, errors);
+  if (serverCode < 0 || serverCode >= 400 || !errors.empty()) {
+    throw Error(ErrorCode::kerFileOpenFailed, "http", Exiv2::Internal::stringFormat("%d", serverCode), hostInfo_.Path);
   }
+  response = responseDic["body"];
+}
 
-  int serverCode = http(request, responseDic, errors);
+void HttpIo::HttpImpl::getDataByRanges(const std::vector<std::pair<size_t, size_t>>& ranges,
+                                       std::vector<std::string>& responses) {
+  std::vector<HttpClient::Range> bytes;
+  for (auto&& [lowBlock, highBlock] : ranges)
+    bytes.emplace_back(lowBlock * blockSize_, (highBlock + 1) * blockSize_ - 1);
+  std::string errors;
+  int serverCode = client_->get(hostInfo_.Path, bytes, responses, errors);
   if (serverCode < 0 || serverCode >= 400 || !errors.empty()) {
     throw Error(ErrorCode::kerFileOpenFailed, "http", Exiv2::Internal::stringFormat("%d", serverCode), hostInfo_.Path);
   }
-  response = responseDic["body"];
 }
 
 void HttpIo::HttpImpl::writeRemote(const byte* data, size_t size, size_t from, size_t to) {
@@ -1594,6 +1718,7 @@ long CurlIo::CurlImpl::getFileLength() {
   std::string response;
   curl_easy_setopt(curl_, CURLOPT_URL, path_.c_str());
   curl_easy_setopt(curl_, CURLOPT_NOBODY, 1);  // HEAD
+  curl_easy_setopt(curl_, CURLOPT_FILETIME, 1L);
   curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, curlWriter);
   curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
   curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, 0L);
@@ -1612,6 +1737,11 @@ long CurlIo::CurlImpl::getFileLength() {
   if (serverCode >= 400 || serverCode < 0) {
     throw Error(ErrorCode::kerFileOpenFailed, "http", Exiv2::Internal::stringFormat("%d", serverCode), path_);
   }
+  // get the modification time, which identifies the version of the file
+  long filetime = -1;
+  curl_easy_getinfo(curl_, CURLINFO_FILETIME, &filetime);  // return -1 if unknown
+  if (filetime >= 0)
+    validator_ = std::to_string(filetime);
   // get length
   double temp;
   curl_easy_getinfo(curl_, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &temp);  // return -1 if unknown
@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "blockcache_int.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+//! FNV-1a hash, names the files of a version in the cache directory
+uint64_t fnv1a(const std::string& s) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : s) {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::string hex(uint64_t value) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016" PRIx64, value);
+  return buf;
+}
+
+int openFile(const fs::path& path, bool create) {
+#ifdef _WIN32
+  return _wopen(path.c_str(), _O_RDWR | _O_BINARY | (create ? _O_CREAT : 0), _S_IREAD | _S_IWRITE);
+#else
+  return ::open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0644);
+#endif
+}
+
+void closeFile(int fd) {
+  if (fd >= 0) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+  }
+}
+
+/*!
+  @brief Lock a file shared or exclusive. The lock is released when the file is closed.
+
+  Windows locks are mandatory: a locked range cannot be written, not even through
+  the handle which holds a shared lock. So a single byte far past any data is
+  locked there, which leaves the data writable.
+ */
+bool lockFile(int fd, bool exclusive, bool wait) {
+#ifdef _WIN32
+  OVERLAPPED overlapped = {};
+  overlapped.Offset = MAXDWORD;
+  overlapped.OffsetHigh = MAXDWORD >> 1;
+  DWORD flags = (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0) | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+  return LockFileEx(reinterpret_cast<HANDLE>(_get_osfhandle(fd)), flags, 0, 1, 0, &overlapped);
+#else
+  return flock(fd, (exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB)) == 0;
+#endif
+}
+
+//! Return true if \em fd is the file which \em path names
+bool isFileAt(int fd, const fs::path& path) {
+#ifdef _WIN32
+  // files which are open cannot be removed or replaced
+  (void)fd;
+  (void)path;
+  return true;
+#else
+  struct stat opened = {};
+  struct stat named = {};
+  return ::fstat(fd, &opened) == 0 && ::stat(path.c_str(), &named) == 0 && opened.st_dev == named.st_dev &&
+         opened.st_ino == named.st_ino;
+#endif
+}
+
+bool truncateFile(int fd) {
+#ifdef _WIN32
+  return _chsize_s(fd, 0) == 0;
+#else
+  return ::ftruncate(fd, 0) == 0;
+#endif
+}
+
+bool readAt(int fd, uint64_t offset, Exiv2::byte* buf, size_t count) {
+#ifdef _WIN32
+  if (_lseeki64(fd, offset, SEEK_SET) < 0)
+    return false;
+  return _read(fd, buf, static_cast<unsigned>(count)) == static_cast<int>(count);
+#else
+  while (count) {
+    ssize_t n = pread(fd, buf, count, static_cast<off_t>(offset));
+    if (n <= 0)
+      return false;
+    buf += n;
+    offset += n;
+    count -= n;
+  }
+  return true;
+#endif
+}
+
+bool writeAt(int fd, uint64_t offset, const Exiv2::byte* buf, size_t count) {
+#ifdef _WIN32
+  if (_lseeki64(fd, offset, SEEK_SET) < 0)
+    return false;
+  return _write(fd, buf, static_cast<unsigned>(count)) == static_cast<int>(count);
+#else
+  while (count) {
+    ssize_t n = pwrite(fd, buf, count, static_cast<off_t>(offset));
+    if (n <= 0)
+      return false;
+    buf += n;
+    offset += n;
+    count -= n;
+  }
+  return true;
+#endif
+}
+
+//! Return the number of bytes a file occupies on disk, which is less than its size for sparse files
+uint64_t diskUsage(const fs::path& path) {
+#ifdef _WIN32
+  std::error_code ec;
+  auto size = fs::file_size(path, ec);
+  return ec ? 0 : size;
+#else
+  struct stat st = {};
+  return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_blocks) * 512 : 0;
+#endif
+}
+}  // namespace
+
+namespace Exiv2::Internal {
+BlockCache::BlockCache(const std::string& dir, uint64_t limit, const std::string& url, const std::string& validator,
+                       size_t size, size_t blockSize) :
+    dir_(dir), limit_(limit), blocks_(blockSize ? (size + blockSize - 1) / blockSize : 0), size_(size),
+    blockSize_(blockSize) {
+  std::error_code ec;
+  fs::create_directories(dir_, ec);
+  if (validator.empty() || blocks_ == 0)
+    return;
+
+  const fs::path base = fs::path(dir_) / (hex(fnv1a(url)) + "-" +
+                                         hex(fnv1a(validator + "\n" + std::to_string(size) + "\n" +
+                                                   std::to_string(blockSize))));
+  const fs::path map = fs::path(base).replace_extension(".map");
+  // trim() may remove the version between opening and locking its map, so check
+  // that the locked map is still the one in the directory before using it
+  for (int attempt = 0; attempt < 3 && map_ < 0; ++attempt) {
+    map_ = openFile(map, true);
+    if (map_ < 0)
+      return;
+    if (!lockFile(map_, false, true) || !isFileAt(map_, map)) {
+      closeFile(map_);
+      map_ = -1;
+    }
+  }
+  if (map_ < 0)
+    return;
+  // the data belongs to the map, so it is only opened while the map is locked
+  data_ = openFile(fs::path(base).replace_extension(".dat"), true);
+  if (data_ < 0) {
+    closeFile(map_);
+    map_ = -1;
+    return;
+  }
+  // a new map reads as all blocks missing
+  if (fs::file_size(map, ec) < blocks_ && !ec)
+    fs::resize_file(map, blocks_, ec);
+  // the modification time of the map tells when the version was used last
+  fs::last_write_time(map, fs::file_time_type::clock::now(), ec);
+}
+
+BlockCache::~BlockCache() {
+  closeFile(data_);
+  // trim before the lock on this version is released, so that it is kept
+  if (added_)
+    trim();
+  closeFile(map_);
+}
+
+size_t BlockCache::sizeOf(size_t block) const {
+  return std::min(blockSize_, size_ - block * blockSize_);
+}
+
+bool BlockCache::has(size_t block) const {
+  byte present = 0;
+  return isOpen() && block < blocks_ && readAt(map_, block, &present, 1) && present == 1;
+}
+
+DataBuf BlockCache::get(size_t block) {
+  if (!has(block))
+    return {};
+  DataBuf buf(sizeOf(block));
+  if (!readAt(data_, static_cast<uint64_t>(block) * blockSize_, buf.data(), buf.size()))
+    return {};
+  return buf;
+}
+
+void BlockCache::put(size_t block, const byte* data, size_t size) {
+  if (!isOpen() || block >= blocks_ || size != sizeOf(block) || has(block))
+    return;
+  // mark the block present only after its data is written
+  const byte present = 1;
+  if (writeAt(data_, static_cast<uint64_t>(block) * blockSize_, data, size) && writeAt(map_, block, &present, 1))
+    added_ = true;
+}
+
+void BlockCache::trim() {
+  int lock = openFile(fs::path(dir_) / "lock", true);
+  if (lock < 0 || !lockFile(lock, true, false)) {  // another process is trimming
+    closeFile(lock);
+    return;
+  }
+
+  struct Version {
+    fs::file_time_type used;
+    fs::path map;
+    uint64_t bytes;
+  };
+  std::vector<Version> versions;
+  uint64_t total = 0;
+  std::error_code ec;
+  for (auto&& entry : fs::directory_iterator(dir_, ec)) {
+    if (entry.path().extension() != ".map")
+      continue;
+    const fs::path& map = entry.path();
+    uint64_t bytes = diskUsage(map) + diskUsage(fs::path(map).replace_extension(".dat"));
+    versions.push_back({fs::last_write_time(map, ec), map, bytes});
+    total += bytes;
+  }
+  std::sort(versions.begin(), versions.end(), [](const Version& a, const Version& b) { return a.used < b.used; });
+
+  for (auto&& version : versions) {
+    if (total <= limit_)
+      break;
+    // versions which other processes have open are locked shared
+    int fd = openFile(version.map, false);
+    if (fd < 0 || !lockFile(fd, true, false)) {
+      closeFile(fd);
+      continue;
+    }
+    // processes which still open the map before it is removed find no blocks
+    truncateFile(fd);
+    fs::remove(fs::path(version.map).replace_extension(".dat"), ec);
+#ifdef _WIN32
+    closeFile(fd);  // open files cannot be removed
+    fd = -1;
+#endif
+    fs::remove(version.map, ec);
+    closeFile(fd);
+    total -= version.bytes;
+  }
+  closeFile(lock);
+}
+
+void BlockCache::invalidate(const std::string& dir, const std::string& url) {
+  const std::string prefix = hex(fnv1a(url)) + "-";
+  std::error_code ec;
+  std::vector<fs::path> files;
+  for (auto&& entry : fs::directory_iterator(dir, ec)) {
+    if (entry.path().filename().string().compare(0, prefix.size(), prefix) == 0)
+      files.push_back(entry.path());
+  }
+  for (auto&& file : files)
+    fs::remove(file, ec);
+}
+
+}  // namespace Exiv2::Internal
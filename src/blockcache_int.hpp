@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*!
+  @file    blockcache_int.hpp
+  @brief   Internal on-disk cache of the blocks of remote files, used by RemoteIo
+ */
+#ifndef BLOCKCACHE_INT_HPP_
+#define BLOCKCACHE_INT_HPP_
+
+// *****************************************************************************
+// included header files
+#include "types.hpp"
+
+#include <string>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2::Internal {
+// *****************************************************************************
+// class definitions
+
+/*!
+  @brief Cache of the blocks of one version of a remote file in a directory
+         which is shared by all processes.
+
+  A version of a remote file is identified by its URL, a validator from the server
+  (ETag or Last-Modified), its size and the block size. The blocks of a version are
+  kept in a sparse data file at their offsets, next to a map file with one byte per
+  block which tells whether the block is present. A block is marked present only
+  after it has been written, so other processes never read a partial block.
+
+  The map file of a version is locked shared for as long as the cache is open,
+  and the data file is only opened after the lock was taken on the map which is
+  still in the directory. When the size of the directory grows over its limit, the
+  least recently used versions which no process holds open are emptied and
+  removed, under an exclusive lock on the directory.
+ */
+class BlockCache {
+ public:
+  //! @name Creators
+  //@{
+  /*!
+    @brief Open the cache of one version of a remote file. Use isOpen() to find
+           out if that succeeded; a cache which cannot be opened is simply empty.
+    @param dir       Cache directory, created if it does not exist
+    @param limit     Most number of bytes to keep in the directory
+    @param url       URL of the remote file
+    @param validator ETag or Last-Modified of the remote file
+    @param size      Size of the remote file
+    @param blockSize Size of the blocks
+   */
+  BlockCache(const std::string& dir, uint64_t limit, const std::string& url, const std::string& validator,
+             size_t size, size_t blockSize);
+  //! Destructor. Trims the directory to its limit if blocks were added.
+  ~BlockCache();
+  //@}
+
+  BlockCache(const BlockCache&) = delete;
+  BlockCache& operator=(const BlockCache&) = delete;
+
+  //! @name Manipulators
+  //@{
+  /*!
+    @brief Read a block from the cache.
+    @return The data of the block, empty if the block is not in the cache
+   */
+  DataBuf get(size_t block);
+  //! Add a block to the cache. data must be the whole block.
+  void put(size_t block, const byte* data, size_t size);
+  //! Remove the least recently used versions until the directory is within its limit.
+  void trim();
+  //@}
+
+  //! @name Accessors
+  //@{
+  [[nodiscard]] bool isOpen() const {
+    return map_ >= 0;
+  }
+  //! Return true if the block is in the cache
+  [[nodiscard]] bool has(size_t block) const;
+  //@}
+
+  //! Remove all cached versions of url from dir, e.g. after the remote file was changed
+  static void invalidate(const std::string& dir, const std::string& url);
+
+ private:
+  //! Return the size of a block, which is less than blockSize_ for the last one
+  [[nodiscard]] size_t sizeOf(size_t block) const;
+
+  std::string dir_;
+  uint64_t limit_;
+  size_t blocks_;
+  size_t size_;
+  size_t blockSize_;
+  int map_{-1};   //!< map file descriptor, locked shared
+  int data_{-1};  //!< data file descriptor
+  bool added_{};  //!< whether put() added blocks
+};
+
+}  // namespace Exiv2::Internal
+
+#endif  // BLOCKCACHE_INT_HPP_
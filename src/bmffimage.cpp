@@ -102,6 +102,30 @@ static bool skipBox(uint32_t box) {
   return box == TAG_mdat;  // mdat is where the main image lives and can be huge
 }
 
+static size_t payloadToRead(uint32_t box, size_t size) {
+  // Return how many bytes from the start of the payload of a box of type
+  // box and size bytes boxHandler() parses. Container boxes are read by
+  // their children and Exif, XMP and CMT boxes by parseTiff() and
+  // parseXmp(), so only their headers are needed. Reading the whole
+  // payload of every box copied nested data once per nesting level.
+  switch (box) {
+    case TAG_ftyp:
+    case TAG_infe:
+    case TAG_iloc:
+    case TAG_ispe:
+    case TAG_colr:
+      return size;
+    case TAG_meta:
+    case TAG_iinf:
+      return std::min<size_t>(size, 8);  // version/flags and item count
+    case TAG_thmb:
+    case TAG_prvw:
+      return std::min<size_t>(size, 32);  // version/flags, dimensions and size of the image
+    default:
+      return 0;
+  }
+}
+
 std::string BmffImage::mimeType() const {
   switch (fileType_) {
     case TAG_avif:
@@ -212,10 +236,12 @@ long BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStruc
     return restore + static_cast<long>(buffer_size);
   }
 
-  DataBuf data(buffer_size);
-  const long box_end = restore + static_cast<long>(data.size());
-  io_->read(data.data(), data.size());
-  io_->seek(restore, BasicIo::beg);
+  DataBuf data(payloadToRead(box_type, buffer_size));
+  const long box_end = restore + static_cast<long>(buffer_size);
+  if (!data.empty()) {
+    io_->read(data.data(), data.size());
+    io_->seek(restore, BasicIo::beg);
+  }
 
   size_t skip = 0;  // read position in data.pData_
   uint8_t version = 0;
@@ -252,7 +278,7 @@ long BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStruc
 
       io_->seek(skip, BasicIo::cur);
       while (n-- > 0) {
-        io_->seek(boxHandler(out, option, box_end, depth + 1), BasicIo::beg);
+        io_->seek(nextBox(out, option, box_end, depth + 1), BasicIo::beg);
       }
     } break;
 
@@ -292,7 +318,7 @@ long BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStruc
       }
       io_->seek(skip, BasicIo::cur);
       while (io_->tell() < box_end) {
-        io_->seek(boxHandler(out, option, box_end, depth + 1), BasicIo::beg);
+        io_->seek(nextBox(out, option, box_end, depth + 1), BasicIo::beg);
       }
       // post-process meta box to recover Exif and XMP
       if (box_type == TAG_meta) {
@@ -417,7 +443,7 @@ long BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStruc
           io_->seek(8, BasicIo::cur);
         }
         while (io_->tell() < box_end) {
-          io_->seek(boxHandler(out, option, box_end, depth + 1), BasicIo::beg);
+          io_->seek(nextBox(out, option, box_end, depth + 1), BasicIo::beg);
         }
       } else if (name == "xmp") {
         parseXmp(box_length, io_->tell());
@@ -475,6 +501,25 @@ long BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStruc
   return box_end;
 }
 
+long BmffImage::nextBox(std::ostream& out, Exiv2::PrintStructureOption option, long pbox_end, int depth) {
+  const long address = io_->tell();
+  try {
+    return boxHandler(out, option, pbox_end, depth);
+  } catch (const Error& error) {
+    if (!Internal::collectError(error.code(), address, error.what()))
+      throw;
+  }
+  // continue with the next box if the length of this one is sane, else with the parent's next box
+  byte hdrbuf[2 * sizeof(uint32_t)];
+  io_->seek(address, BasicIo::beg);
+  if (io_->read(hdrbuf, sizeof(hdrbuf)) == sizeof(hdrbuf)) {
+    const uint64_t box_length = getLong(hdrbuf, endian_);
+    if (box_length >= sizeof(hdrbuf) && box_length <= static_cast<uint64_t>(pbox_end - address))
+      return address + static_cast<long>(box_length);
+  }
+  return pbox_end;
+}
+
 void BmffImage::parseTiff(uint32_t root_tag, uint64_t length, uint64_t start) {
   enforce(start <= io_->size(), ErrorCode::kerCorruptedMetadata);
   enforce(length <= io_->size() - start, ErrorCode::kerCorruptedMetadata);
@@ -495,6 +540,7 @@ void BmffImage::parseTiff(uint32_t root_tag, uint64_t length, uint64_t start) {
           punt = static_cast<long>(i);
     }
     if (punt != eof) {
+      Internal::ErrorOffset base(static_cast<size_t>(start) + punt);
       Internal::TiffParserWorker::decode(exifData(), iptcData(), xmpData(), exif.c_data(punt),
                                          static_cast<uint32_t>(exif.size() - punt), root_tag,
                                          Internal::TiffMapping::findDecoder);
@@ -508,6 +554,7 @@ void BmffImage::parseTiff(uint32_t root_tag, uint64_t length) {
     enforce(length - 8 <= io_->size() - io_->tell(), ErrorCode::kerCorruptedMetadata);
     enforce(length - 8 <= std::numeric_limits<uint64_t>::max(), ErrorCode::kerCorruptedMetadata);
     DataBuf data(static_cast<size_t>(length - 8u));
+    Internal::ErrorOffset base(io_->tell());
     const size_t bufRead = io_->read(data.data(), data.size());
 
     if (io_->error())
@@ -604,7 +651,7 @@ void BmffImage::readMetadata() {
   const auto file_end = static_cast<long>(io_->size());
   while (address < file_end) {
     io_->seek(address, BasicIo::beg);
-    address = boxHandler(std::cout, kpsNone, file_end, 0);
+    address = nextBox(std::cout, kpsNone, file_end, 0);
   }
   bReadMetadata_ = true;
 }  // BmffImage::readMetadata
@@ -18,10 +18,12 @@
 
 // + standard includes
 #include <cmath>
+#include <exception>
 #include <iomanip>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 // *****************************************************************************
 // class member definitions
@@ -1883,6 +1885,7 @@ constexpr TagDetails canonCsLensType[] = {{1, "Canon EF 50mm f/1.8"},
                                           {61182, "Canon RF 100-500mm F4.5-7.1L IS USM"},           // 26
                                           {61182, "Canon RF 100-500mm F4.5-7.1L IS USM + RF2x"},    // 27
                                           {65535, "n/a"}};
+const size_t canonCsLensTypeSize = std::size(canonCsLensType);
 
 //! FlashActivity, tag 0x001c
 constexpr TagDetails canonCsFlashActivity[] = {{0, N_("Did not fire")}, {1, N_("Fired")}};
@@ -2517,6 +2520,69 @@ std::ostream& printCsLensFFFF(std::ostream& os, const Value& value, const ExifDa
   return EXV_PRINT_TAG(canonCsLensType)(os, value, metadata);
 }
 
+CanonLensRange parseCanonLensLabel(const char* label) {
+  // regex to extract short and tele focal length, max aperture at short and tele position
+  // and the teleconverter factor from the lens label
+  static const std::regex lens_regex(
+      // anything at the start
+      ".*?"
+      // maybe min focal length and hyphen, surely max focal length e.g.: 24-70mm
+      "(?:([0-9]+)-)?([0-9]+)mm"
+      // anything in-between
+      ".*?"
+      // maybe short focal length max aperture and hyphen, surely at least single max aperture e.g.: f/4.5-5.6
+      // short and tele indicate apertures at the short (focal_length_min) and tele (focal_length_max)
+      // position of the lens
+      "(?:(?:f\\/)|T|F)(?:([0-9]+(?:\\.[0-9]+)?)-)?([0-9]+(?:\\.[0-9])?)"
+      // check if there is a teleconverter pattern e.g. + 1.4x
+      "(?:.*?\\+.*?([0-9.]+)x)?");
+
+  CanonLensRange range;
+  range.label_ = label;
+  std::cmatch base_match;
+  if (!std::regex_search(label, base_match, lens_regex)) {
+    return range;
+  }
+  const auto tc = base_match[5].length() > 0 ? std::stof(base_match[5].str()) : 1.f;
+  range.tc_ = tc;
+  range.flMax_ = static_cast<int>(std::stof(base_match[2].str()) * tc);
+  range.flMin_ = base_match[1].length() > 0 ? static_cast<int>(std::stof(base_match[1].str()) * tc) : range.flMax_;
+  range.aperMaxTele_ = std::stof(base_match[4].str()) * tc;
+  range.aperMaxShort_ = base_match[3].length() > 0 ? std::stof(base_match[3].str()) * tc : range.aperMaxTele_;
+  range.parsed_ = true;
+  return range;
+}
+
+namespace {
+//! Lens range parsed from a label, or the exception parseCanonLensLabel() threw for it
+struct IndexedCanonLens {
+  CanonLensRange range_;
+  std::exception_ptr error_;  //!< Thrown again when the lens is looked up
+};
+
+//! Lens ranges by lens type, in the order of canonCsLensType
+using CanonLensIndex = std::unordered_map<int64_t, std::vector<IndexedCanonLens>>;
+
+//! Return the index of all lens ranges, which is built from canonCsLensType on first use
+const CanonLensIndex& canonLensIndex() {
+  static const CanonLensIndex index = [] {
+    CanonLensIndex idx;
+    for (auto&& [val, label] : canonCsLensType) {
+      IndexedCanonLens lens;
+      lens.range_.label_ = label;
+      try {
+        lens.range_ = parseCanonLensLabel(label);
+      } catch (...) {
+        lens.error_ = std::current_exception();
+      }
+      idx[val].push_back(lens);
+    }
+    return idx;
+  }();
+  return index;
+}
+}  // namespace
+
 std::ostream& printCsLensTypeByMetadata(std::ostream& os, const Value& value, const ExifData* metadata) {
   if (!metadata || value.typeId() != unsignedShort || value.count() == 0)
     return os << value;
@@ -2549,57 +2615,35 @@ std::ostream& printCsLensTypeByMetadata(std::ostream& os, const Value& value, co
 
   auto exifAperMax = fnumber(canonEv(static_cast<int16_t>(pos->value().toInt64(0))));
 
-  // regex to extract short and tele focal length, max aperture at short and tele position
-  // and the teleconverter factor from the lens label
-  std::regex const lens_regex(
-      // anything at the start
-      ".*?"
-      // maybe min focal length and hyphen, surely max focal length e.g.: 24-70mm
-      "(?:([0-9]+)-)?([0-9]+)mm"
-      // anything in-between
-      ".*?"
-      // maybe short focal length max aperture and hyphen, surely at least single max aperture e.g.: f/4.5-5.6
-      // short and tele indicate apertures at the short (focal_length_min) and tele (focal_length_max)
-      // position of the lens
-      "(?:(?:f\\/)|T|F)(?:([0-9]+(?:\\.[0-9]+)?)-)?([0-9]+(?:\\.[0-9])?)"
-      // check if there is a teleconverter pattern e.g. + 1.4x
-      "(?:.*?\\+.*?([0-9.]+)x)?");
-
   bool unmatched = true;
   // we loop over all our lenses to print out all matching lenses
   // if we have multiple possibilities, they are concatenated by "*OR*"
-  for (auto&& [val, label] : canonCsLensType) {
-    if (val != lensType) {
-      continue;
-    }
-
-    std::cmatch base_match;
-    if (!std::regex_search(label, base_match, lens_regex)) {
-      // this should never happen, as it would indicate the lens is specified incorrectly
-      // in the CanonCsLensType array
-      throw Error(ErrorCode::kerErrorMessage, std::string("Lens regex didn't match for: ") + std::string(label));
-    }
-
-    auto tc = base_match[5].length() > 0 ? std::stof(base_match[5].str()) : 1.f;
-
-    int flMax = static_cast<int>(std::stof(base_match[2].str()) * tc);
-    int flMin = base_match[1].length() > 0 ? static_cast<int>(std::stof(base_match[1].str()) * tc) : flMax;
-
-    auto aperMaxTele = std::stof(base_match[4].str()) * tc;
-    auto aperMaxShort = base_match[3].length() > 0 ? std::stof(base_match[3].str()) * tc : aperMaxTele;
-
-    if (flMin != exifFlMin || flMax != exifFlMax || exifAperMax < (aperMaxShort - .1 * tc) ||
-        exifAperMax > (aperMaxTele + .1 * tc)) {
-      continue;
+  const CanonLensIndex& index = canonLensIndex();
+  auto lenses = index.find(lensType);
+  if (lenses != index.end()) {
+    for (auto&& [lens, error] : lenses->second) {
+      if (error)
+        std::rethrow_exception(error);
+      if (!lens.parsed_) {
+        // this should never happen, as it would indicate the lens is specified incorrectly
+        // in the CanonCsLensType array
+        throw Error(ErrorCode::kerErrorMessage, std::string("Lens regex didn't match for: ") + lens.label_);
+      }
+
+      const auto tc = lens.tc_;
+      if (lens.flMin_ != exifFlMin || lens.flMax_ != exifFlMax || exifAperMax < (lens.aperMaxShort_ - .1 * tc) ||
+          exifAperMax > (lens.aperMaxTele_ + .1 * tc)) {
+        continue;
+      }
+
+      if (unmatched) {
+        unmatched = false;
+        os << lens.label_;
+        continue;
+      }
+
+      os << " *OR* " << lens.label_;
     }
-
-    if (unmatched) {
-      unmatched = false;
-      os << label;
-      continue;
-    }
-
-    os << " *OR* " << label;
   }
 
   // if the entire for loop left us with unmatched==false
@@ -2618,8 +2662,9 @@ std::ostream& CanonMakerNote::printCsLensType(std::ostream& os, const Value& val
   // #1034
   const std::string undefined("undefined");
   const std::string section("canon");
-  if (Internal::readExiv2Config(section, value.toString(), undefined) != undefined) {
-    return os << Internal::readExiv2Config(section, value.toString(), undefined);
+  const std::string config = Internal::readExiv2Config(section, value.toString(), undefined);
+  if (config != undefined) {
+    return os << config;
   }
 
   // try our best to determine the lens based on metadata
@@ -18,6 +18,7 @@
 // *****************************************************************************
 // included header files
 #include "tags.hpp"
+#include "tags_int.hpp"
 
 // *****************************************************************************
 // namespace extensions
@@ -199,6 +200,31 @@ class CanonMakerNote {
  */
 float canonEv(int64_t val);
 
+//! Lens types and labels of Exif.CanonCs.LensType, several lenses can share a lens type
+extern const TagDetails canonCsLensType[];
+//! Number of entries of canonCsLensType
+extern const size_t canonCsLensTypeSize;
+
+//! Focal length and maximum aperture ranges of a lens, parsed from its label in canonCsLensType
+struct CanonLensRange {
+  const char* label_;        //!< Lens label
+  bool parsed_{false};       //!< False if the ranges couldn't be extracted from the label
+  int flMin_{0};             //!< Short focal length, including teleconverter
+  int flMax_{0};             //!< Tele focal length, including teleconverter
+  float aperMaxShort_{0.f};  //!< Maximum aperture at the short focal length, including teleconverter
+  float aperMaxTele_{0.f};   //!< Maximum aperture at the tele focal length, including teleconverter
+  float tc_{1.f};            //!< Teleconverter factor
+};
+
+/*!
+  @brief Extract the focal length and maximum aperture ranges and the
+         teleconverter factor from a lens label, e.g. "Canon EF 70-200mm f/4L + 1.4x".
+         The result is not parsed_ if the label doesn't contain them. The
+         exceptions of std::stof() are passed on if a number in it cannot be
+         converted.
+ */
+CanonLensRange parseCanonLensLabel(const char* label);
+
 }  // namespace Exiv2::Internal
 
 #endif  // #ifndef CANONMN_INT_HPP_
@@ -20,6 +20,8 @@
 // + standard includes
 #include <algorithm>
 #include <iomanip>
+#include <unordered_map>
+#include <vector>
 
 #if defined WIN32 && !defined __CYGWIN__
 #include <windows.h>
@@ -52,6 +54,14 @@ bool convertStringCharsetWindows(std::string& str, const char* from, const char*
 // Convert string charset with iconv.
 bool convertStringCharsetIconv(std::string& str, const char* from, const char* to);
 #endif
+/*!
+  @brief Convert string charset without iconv for the common UCS-2, UTF-8,
+         ISO-8859-1 and ASCII conversions. Return false, leaving \em str
+         unchanged, if the conversion is not one of these or the input is
+         not valid, so that the caller falls back to the generic (and
+         diagnosing) conversion.
+ */
+bool convertStringCharsetFast(std::string& str, const char* from, const char* to);
 /*!
   @brief Get the text value of an XmpDatum \em pos.
 
@@ -273,6 +283,31 @@ class Converter {
   bool prepareXmpTarget(const char* to, bool force = false);
   std::string computeExifDigest(bool tiff);
 
+  //! The conversion table with its keys resolved, built once, see plan().
+  struct ConversionPlan {
+    //! Rows of conversion_ by numeric Exif key, (ifdId << 16) | tag.
+    std::unordered_map<uint32_t, std::vector<size_t>> exif_;
+    //! Rows of conversion_ by numeric IPTC key, (record << 16) | dataset.
+    std::unordered_map<uint32_t, std::vector<size_t>> iptc_;
+    //! Rows of conversion_ by XMP key.
+    std::unordered_map<std::string, std::vector<size_t>> xmp_;
+    //! Numeric key of the first key of each row.
+    std::vector<uint32_t> key1_;
+    //! Whether the first key of each row is an Exif tag in the Image group.
+    std::vector<bool> tiff_;
+    //! Rows whose XMP to Exif/IPTC conversion has an effect also if the XMP property does not exist.
+    std::vector<bool> sourceless_;
+  };
+  static const ConversionPlan& plan();
+  //! Numeric Exif key as used by ConversionPlan.
+  static uint32_t exifKey(int ifdId, uint16_t tag) {
+    return (static_cast<uint32_t>(ifdId) << 16) | tag;
+  }
+  //! Numeric IPTC key as used by ConversionPlan.
+  static uint32_t iptcKey(uint16_t record, uint16_t dataset) {
+    return (static_cast<uint32_t>(record) << 16) | dataset;
+  }
+
   // DATA
   static const Conversion conversion_[];  //<! Conversion rules
   bool erase_;
@@ -507,16 +542,82 @@ Converter::Converter(IptcData& iptcData, XmpData& xmpData, const char* iptcChars
     iptcCharset_(iptcCharset) {
 }
 
+const Converter::ConversionPlan& Converter::plan() {
+  static const ConversionPlan plan = [] {
+    ConversionPlan p;
+    const size_t n = std::size(conversion_);
+    p.key1_.resize(n);
+    p.tiff_.resize(n);
+    p.sourceless_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      const Conversion& c = conversion_[i];
+      if (c.metadataId_ == mdExif) {
+        const ExifKey key(c.key1_);
+        p.key1_[i] = exifKey(key.ifdId(), key.tag());
+        p.tiff_[i] = key.groupName() == "Image";
+        p.exif_[p.key1_[i]].push_back(i);
+      } else if (c.metadataId_ == mdIptc) {
+        const IptcKey key(c.key1_);
+        p.key1_[i] = iptcKey(key.record(), key.tag());
+        p.iptc_[p.key1_[i]].push_back(i);
+      }
+      p.xmp_[c.key2_].push_back(i);
+      // These prepare (erase) the target before they look for the source
+      p.sourceless_[i] = c.key2ToKey1_ == &Converter::cnvXmpComment || c.key2ToKey1_ == &Converter::cnvXmpArray;
+    }
+    return p;
+  }();
+  return plan;
+}
+
 void Converter::cnvToXmp() {
-  for (auto&& c : conversion_) {
-    if ((c.metadataId_ == mdExif && exifData_) || (c.metadataId_ == mdIptc && iptcData_)) {
+  // Find the rows that have a source in a single pass over the container, then
+  // convert them in table order. All conversions return early without a source.
+  const ConversionPlan& p = plan();
+  std::vector<bool> active(std::size(conversion_));
+  auto activate = [&](const std::unordered_map<uint32_t, std::vector<size_t>>& rows, uint32_t key) {
+    auto it = rows.find(key);
+    if (it != rows.end())
+      for (auto i : it->second)
+        active[i] = true;
+  };
+  if (exifData_)
+    for (auto&& md : *exifData_)
+      activate(p.exif_, exifKey(md.ifdId(), md.tag()));
+  if (iptcData_)
+    for (auto&& md : *iptcData_)
+      activate(p.iptc_, iptcKey(md.record(), md.tag()));
+
+  for (size_t i = 0; i < std::size(conversion_); ++i) {
+    const Conversion& c = conversion_[i];
+    if (active[i]) {
       EXV_CALL_MEMBER_FN(*this, c.key1ToKey2_)(c.key1_, c.key2_);
     }
   }
 }
 
 void Converter::cnvFromXmp() {
-  for (auto&& c : conversion_) {
+  const ConversionPlan& p = plan();
+  std::vector<bool> active(std::size(conversion_));
+  auto activate = [&](const std::string& key) {
+    auto it = p.xmp_.find(key);
+    if (it != p.xmp_.end())
+      for (auto i : it->second)
+        active[i] = true;
+  };
+  for (auto&& md : *xmpData_) {
+    const std::string key = md.key();
+    activate(key);
+    // Struct fields, like Xmp.exif.Flash/exif:Fired, are the source for their struct
+    auto slash = key.find('/');
+    if (slash != std::string::npos)
+      activate(key.substr(0, slash));
+  }
+
+  for (size_t i = 0; i < std::size(conversion_); ++i) {
+    const Conversion& c = conversion_[i];
+    if (!active[i] && !p.sourceless_[i])
+      continue;
     if ((c.metadataId_ == mdExif && exifData_) || (c.metadataId_ == mdIptc && iptcData_)) {
       EXV_CALL_MEMBER_FN(*this, c.key2ToKey1_)(c.key2_, c.key1_);
     }
@@ -1250,37 +1351,46 @@ void Converter::cnvXmpValueToIptc(const char* from, const char* to) {
 
 #ifdef EXV_HAVE_XMP_TOOLKIT
 std::string Converter::computeExifDigest(bool tiff) {
-  std::ostringstream res;
+  const ConversionPlan& p = plan();
+  // First datum for each key in the table, as findKey() would return it
+  std::unordered_map<uint32_t, const Exifdatum*> data;
+  for (auto&& md : *exifData_) {
+    const uint32_t key = exifKey(md.ifdId(), md.tag());
+    if (p.exif_.find(key) != p.exif_.end())
+      data.emplace(key, &md);
+  }
+
+  std::string res;
   MD5_CTX context;
   unsigned char digest[16];
 
   MD5Init(&context);
-  for (auto&& c : conversion_) {
-    if (c.metadataId_ == mdExif) {
-      Exiv2::ExifKey key(c.key1_);
-      if (tiff && key.groupName() != "Image")
-        continue;
-      if (!tiff && key.groupName() == "Image")
+  for (size_t i = 0; i < std::size(conversion_); ++i) {
+    if (conversion_[i].metadataId_ == mdExif) {
+      if (tiff != p.tiff_[i])
         continue;
 
-      if (!res.str().empty())
-        res << ',';
-      res << key.tag();
-      auto pos = exifData_->findKey(key);
-      if (pos == exifData_->end())
+      if (!res.empty())
+        res += ',';
+      res += std::to_string(p.key1_[i] & 0xffff);
+      auto pos = data.find(p.key1_[i]);
+      if (pos == data.end())
         continue;
-      DataBuf data(pos->size());
-      pos->copy(data.data(), littleEndian /* FIXME ? */);
-      MD5Update(&context, data.c_data(), static_cast<uint32_t>(data.size()));
+      DataBuf buf(pos->second->size());
+      pos->second->copy(buf.data(), littleEndian /* FIXME ? */);
+      MD5Update(&context, buf.c_data(), static_cast<uint32_t>(buf.size()));
     }
   }
   MD5Final(digest, &context);
-  res << ';';
-  res << std::setw(2) << std::setfill('0') << std::hex << std::uppercase;
-  for (auto&& i : digest) {
-    res << static_cast<int>(i);
+  res += ';';
+  // Only the first byte is zero-padded; this is how the digest has always been written
+  constexpr char hex[] = "0123456789ABCDEF";
+  for (size_t i = 0; i < std::size(digest); ++i) {
+    if (i == 0 || digest[i] >= 0x10)
+      res += hex[digest[i] >> 4];
+    res += hex[digest[i] & 0xf];
   }
-  return res.str();
+  return res;
 }
 #else
 std::string Converter::computeExifDigest(bool) {
@@ -1395,6 +1505,8 @@ void moveXmpToIptc(XmpData& xmpData, IptcData& iptcData) {
 bool convertStringCharset(std::string& str, const char* from, const char* to) {
   if (0 == strcmp(from, to))
     return true;  // nothing to do
+  if (convertStringCharsetFast(str, from, to))
+    return true;
   bool ret = false;
 #if defined EXV_HAVE_ICONV
   ret = convertStringCharsetIconv(str, from, to);
@@ -1561,15 +1673,181 @@ bool convertStringCharsetWindows(std::string& str, const char* from, const char*
 }
 
 #endif  // defined WIN32 && !defined __CYGWIN__
+uint16_t getUcs2(const std::string& str, size_t i, bool bigEndian) {
+  const auto b0 = static_cast<uint8_t>(str[i]);
+  const auto b1 = static_cast<uint8_t>(str[i + 1]);
+  return bigEndian ? static_cast<uint16_t>(b0 << 8 | b1) : static_cast<uint16_t>(b1 << 8 | b0);
+}
+
+void appendUcs2(std::string& out, uint16_t c, bool bigEndian) {
+  const char hi = static_cast<char>(c >> 8);
+  const char lo = static_cast<char>(c & 0xff);
+  out += bigEndian ? hi : lo;
+  out += bigEndian ? lo : hi;
+}
+
+bool isSurrogate(uint32_t c) {
+  return c >= 0xd800 && c <= 0xdfff;
+}
+
+bool ucs2ToUtf8(std::string& str, bool bigEndian) {
+  if (str.size() % 2 != 0)
+    return false;
+  std::string out;
+  out.reserve(str.size() + str.size() / 2);
+  for (size_t i = 0; i < str.size(); i += 2) {
+    const uint16_t c = getUcs2(str, i, bigEndian);
+    if (c < 0x80) {
+      out += static_cast<char>(c);
+    } else if (c < 0x800) {
+      out += static_cast<char>(0xc0 | (c >> 6));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    } else if (!isSurrogate(c)) {
+      out += static_cast<char>(0xe0 | (c >> 12));
+      out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+      return false;
+    }
+  }
+  str.swap(out);
+  return true;
+}
+
+bool utf8ToUcs2(std::string& str, bool bigEndian) {
+  std::string out;
+  out.reserve(str.size() * 2);
+  auto cont = [&](size_t i) { return i < str.size() && (static_cast<uint8_t>(str[i]) & 0xc0) == 0x80; };
+  for (size_t i = 0; i < str.size();) {
+    const auto b0 = static_cast<uint8_t>(str[i]);
+    uint32_t c = 0;
+    if (b0 < 0x80) {
+      c = b0;
+      i += 1;
+    } else if (b0 >= 0xc2 && b0 <= 0xdf && cont(i + 1)) {
+      c = (b0 & 0x1fu) << 6 | (static_cast<uint8_t>(str[i + 1]) & 0x3fu);
+      i += 2;
+    } else if (b0 >= 0xe0 && b0 <= 0xef && cont(i + 1) && cont(i + 2)) {
+      c = (b0 & 0x0fu) << 12 | (static_cast<uint8_t>(str[i + 1]) & 0x3fu) << 6 |
+          (static_cast<uint8_t>(str[i + 2]) & 0x3fu);
+      // Overlong forms and surrogates are invalid
+      if (c < 0x800 || isSurrogate(c))
+        return false;
+      i += 3;
+    } else {
+      // Invalid, or outside the range of UCS-2
+      return false;
+    }
+    appendUcs2(out, static_cast<uint16_t>(c), bigEndian);
+  }
+  str.swap(out);
+  return true;
+}
+
+bool swapUcs2(std::string& str, bool bigEndian) {
+  if (str.size() % 2 != 0)
+    return false;
+  for (size_t i = 0; i < str.size(); i += 2) {
+    if (isSurrogate(getUcs2(str, i, bigEndian)))
+      return false;
+  }
+  for (size_t i = 0; i < str.size(); i += 2) {
+    std::swap(str[i], str[i + 1]);
+  }
+  return true;
+}
+
+bool latin1ToUtf8(std::string& str) {
+  auto high = std::find_if(str.begin(), str.end(), [](char c) { return static_cast<uint8_t>(c) >= 0x80; });
+  if (high == str.end())
+    return true;
+  std::string out(str.begin(), high);
+  out.reserve(str.size() * 2);
+  for (auto i = high; i != str.end(); ++i) {
+    const auto c = static_cast<uint8_t>(*i);
+    if (c < 0x80) {
+      out += static_cast<char>(c);
+    } else {
+      out += static_cast<char>(0xc0 | (c >> 6));
+      out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+  }
+  str.swap(out);
+  return true;
+}
+
+bool convertStringCharsetFast(std::string& str, const char* from, const char* to) {
+  const bool toUtf8 = 0 == strcmp(to, "UTF-8");
+  if (toUtf8 && 0 == strcmp(from, "ISO-8859-1"))
+    return latin1ToUtf8(str);
+  if (toUtf8 && 0 == strcmp(from, "ASCII"))
+    return std::all_of(str.begin(), str.end(), [](char c) { return static_cast<uint8_t>(c) < 0x80; });
+  const bool fromLe = 0 == strcmp(from, "UCS-2LE");
+  const bool fromBe = 0 == strcmp(from, "UCS-2BE");
+  const bool toLe = 0 == strcmp(to, "UCS-2LE");
+  const bool toBe = 0 == strcmp(to, "UCS-2BE");
+  if (toUtf8 && (fromLe || fromBe))
+    return ucs2ToUtf8(str, fromBe);
+  if (0 == strcmp(from, "UTF-8") && (toLe || toBe))
+    return utf8ToUcs2(str, toBe);
+  if ((fromLe && toBe) || (fromBe && toLe))
+    return swapUcs2(str, fromBe);
+  return false;
+}
+
 #if defined EXV_HAVE_ICONV
+/*!
+  @brief Per-thread cache of iconv conversion descriptors, so that iconv_open(),
+         which looks up and loads the gconv modules, is not called for every
+         string that is converted.
+ */
+class IconvCache {
+ public:
+  IconvCache() = default;
+  ~IconvCache() {
+    for (auto&& e : entries_)
+      iconv_close(e.cd_);
+  }
+  IconvCache(const IconvCache&) = delete;
+  IconvCache& operator=(const IconvCache&) = delete;
+
+  //! Return a descriptor in its initial state, or (iconv_t)(-1) if iconv_open() fails
+  iconv_t get(const char* from, const char* to) {
+    for (auto&& e : entries_) {
+      if (e.from_ == from && e.to_ == to) {
+        iconv(e.cd_, nullptr, nullptr, nullptr, nullptr);
+        return e.cd_;
+      }
+    }
+    iconv_t cd = iconv_open(to, from);
+    if (cd == reinterpret_cast<iconv_t>(-1))
+      return cd;
+    if (entries_.size() == maxEntries) {
+      iconv_close(entries_.front().cd_);
+      entries_.erase(entries_.begin());
+    }
+    entries_.push_back({from, to, cd});
+    return cd;
+  }
+
+ private:
+  struct Entry {
+    std::string from_;
+    std::string to_;
+    iconv_t cd_;
+  };
+  static constexpr size_t maxEntries = 8;
+  std::vector<Entry> entries_;
+};
+
 bool convertStringCharsetIconv(std::string& str, const char* from, const char* to) {
   if (0 == strcmp(from, to))
     return true;  // nothing to do
 
+  static thread_local IconvCache cache;
   bool ret = true;
-  iconv_t cd;
-  cd = iconv_open(to, from);
-  if (!cd) {
+  iconv_t cd = cache.get(from, to);
+  if (cd == reinterpret_cast<iconv_t>(-1)) {
 #ifndef SUPPRESS_WARNINGS
     EXV_WARNING << "iconv_open: " << strError() << "\n";
 #endif
@@ -1591,10 +1869,7 @@ bool convertStringCharsetIconv(std::string& str, const char* from, const char* t
       ret = false;
       break;
     }
-    outstr.append(std::string(outbuf, outbytesProduced));
-  }
-  if (cd) {
-    iconv_close(cd);
+    outstr.append(outbuf, outbytesProduced);
   }
 
   if (ret)
@@ -761,11 +761,16 @@ void CrwMap::decode0x180e(const CiffComponent& ciffComponent, const CrwMapping*
   ULongValue v;
   v.read(ciffComponent.pData(), 8, byteOrder);
   time_t t = v.value_.at(0);
-  struct tm* tm = std::localtime(&t);
-  if (tm) {
+  struct tm tm = {};
+#ifdef _WIN32
+  const bool converted = localtime_s(&tm, &t) == 0;
+#else
+  const bool converted = localtime_r(&t, &tm) != nullptr;
+#endif
+  if (converted) {
     const size_t m = 20;
     char s[m];
-    std::strftime(s, m, "%Y:%m:%d %H:%M:%S", tm);
+    std::strftime(s, m, "%Y:%m:%d %H:%M:%S", &tm);
 
     ExifKey key(pCrwMapping->tag_, Internal::groupName(pCrwMapping->ifdId_));
     AsciiValue value;
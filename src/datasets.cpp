@@ -13,8 +13,10 @@
 
 #include <array>
 #include <iomanip>
-#include <regex>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 // *****************************************************************************
 // class member definitions
@@ -376,28 +378,94 @@ constexpr const DataSet* IptcDataSets::records_[] = {
     nullptr,
 };
 
+namespace {
+//! Direct index from dataset number to the position in a record list, -1 if unknown
+using DataSetNumberIndex = std::array<int16_t, 256>;
+
+template <size_t N>
+constexpr DataSetNumberIndex makeDataSetNumberIndex(const DataSet (&record)[N]) {
+  DataSetNumberIndex index{};
+  for (auto&& idx : index)
+    idx = -1;
+  // Like the linear search, the first entry wins if a number is listed twice
+  for (size_t i = 0; i < N && record[i].number_ != 0xffff; ++i) {
+    if (record[i].number_ >= index.size())
+      throw std::out_of_range("IIM dataset numbers are 8-bit");
+    if (index[record[i].number_] == -1)
+      index[record[i].number_] = static_cast<int16_t>(i);
+  }
+  return index;
+}
+
+constexpr DataSetNumberIndex envelopeNumberIndex = makeDataSetNumberIndex(envelopeRecord);
+constexpr DataSetNumberIndex application2NumberIndex = makeDataSetNumberIndex(application2Record);
+
+//! Hash index from dataset name to the position in a record list
+using DataSetNameIndex = std::unordered_map<std::string_view, int>;
+
+DataSetNameIndex makeDataSetNameIndex(const DataSet* record) {
+  DataSetNameIndex index;
+  for (int i = 0; record[i].number_ != 0xffff; ++i) {
+    index.emplace(record[i].name_, i);
+  }
+  return index;
+}
+
+const DataSetNameIndex& dataSetNameIndex(uint16_t recordId) {
+  static const DataSetNameIndex envelopeIndex = makeDataSetNameIndex(envelopeRecord);
+  static const DataSetNameIndex application2Index = makeDataSetNameIndex(application2Record);
+  return recordId == IptcDataSets::envelope ? envelopeIndex : application2Index;
+}
+
+//! Returns true if \em c matches the regular expression \w
+constexpr bool isWordChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/*!
+  @brief Split \em key into three non-empty dot-separated parts which
+         consist of word characters only, i.e., match it against the
+         regular expression <tt>(\\w+)(\\.\\w+){2}</tt>.
+  @return The positions of the two dots, or false if the key doesn't match.
+ */
+bool splitIptcKey(const std::string& key, size_t& posDot1, size_t& posDot2) {
+  size_t dots[2];
+  size_t nDots = 0;
+  size_t partSize = 0;
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (key[i] == '.') {
+      if (partSize == 0 || nDots == 2)
+        return false;
+      dots[nDots++] = i;
+      partSize = 0;
+    } else if (isWordChar(key[i])) {
+      ++partSize;
+    } else {
+      return false;
+    }
+  }
+  if (nDots != 2 || partSize == 0)
+    return false;
+  posDot1 = dots[0];
+  posDot2 = dots[1];
+  return true;
+}
+}  // namespace
+
 int IptcDataSets::dataSetIdx(uint16_t number, uint16_t recordId) {
   if (recordId != envelope && recordId != application2)
     return -1;
-  const DataSet* dataSet = records_[recordId];
-  int idx;
-  for (idx = 0; dataSet[idx].number_ != number; ++idx) {
-    if (dataSet[idx].number_ == 0xffff)
-      return -1;
-  }
-  return idx;
+  if (number >= envelopeNumberIndex.size())
+    return -1;
+  return recordId == envelope ? envelopeNumberIndex[number] : application2NumberIndex[number];
 }
 
 int IptcDataSets::dataSetIdx(const std::string& dataSetName, uint16_t recordId) {
   if (recordId != envelope && recordId != application2)
     return -1;
-  const DataSet* dataSet = records_[recordId];
-  int idx;
-  for (idx = 0; dataSet[idx].name_ != dataSetName; ++idx) {
-    if (dataSet[idx].number_ == 0xffff)
-      return -1;
-  }
-  return idx;
+  const DataSetNameIndex& index = dataSetNameIndex(recordId);
+  auto i = index.find(dataSetName);
+  return i == index.end() ? -1 : i->second;
 }
 
 TypeId IptcDataSets::dataSetType(uint16_t number, uint16_t recordId) {
@@ -552,19 +620,15 @@ IptcKey* IptcKey::clone_() const {
 }
 
 void IptcKey::decomposeKey() {
-  // Check that the key has the expected format with RE
-  static const std::regex re(R"((\w+)(\.\w+){2})");
-  std::smatch sm;
-  if (!std::regex_match(key_, sm, re)) {
+  // Check that the key has the expected format and get the family name,
+  // record name and dataSet name parts of the key
+  size_t posDot1 = 0;
+  size_t posDot2 = 0;
+  if (!splitIptcKey(key_, posDot1, posDot2)) {
     throw Error(ErrorCode::kerInvalidKey, key_);
   }
 
-  // Get the family name, record name and dataSet name parts of the key
-  auto posDot1 = key_.find('.');
-  auto posDot2 = key_.find('.', posDot1 + 1);
-
-  const std::string familyName = key_.substr(0, posDot1);
-  if (0 != strcmp(familyName.c_str(), familyName_)) {
+  if (std::string_view(key_.data(), posDot1) != familyName_) {
     throw Error(ErrorCode::kerInvalidKey, key_);
   }
 
@@ -581,7 +645,7 @@ void IptcKey::decomposeKey() {
 
   tag_ = dataSet;
   record_ = recId;
-  key_ = familyName + "." + recordName + "." + dataSetName;
+  key_ = std::string(familyName_) + "." + recordName + "." + dataSetName;
 }
 
 void IptcKey::makeKey() {
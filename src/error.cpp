@@ -7,6 +7,7 @@
 
 // + standard includes
 #include <array>
+#include <cstdio>
 #include <iostream>
 
 namespace {
@@ -93,20 +94,31 @@ constexpr std::array errList{
 static_assert(errList.size() == static_cast<size_t>(Exiv2::ErrorCode::kerErrorCount),
               "errList needs to contain a error msg for every ErrorCode defined in error.hpp");
 
+//! Diagnostics of the calling thread, see Exiv2::Diagnostics
+thread_local Exiv2::Diagnostics* diagnostics = nullptr;
+
 }  // namespace
 
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
-LogMsg::Level LogMsg::level_ = LogMsg::warn;  // Default output level
-LogMsg::Handler LogMsg::handler_ = LogMsg::defaultHandler;
+std::atomic<LogMsg::Level> LogMsg::level_ = LogMsg::warn;  // Default output level
+std::atomic<LogMsg::Handler> LogMsg::handler_ = LogMsg::defaultHandler;
 
 LogMsg::LogMsg(LogMsg::Level msgType) : msgType_(msgType) {
 }
 
 LogMsg::~LogMsg() {
-  if (msgType_ >= level_ && handler_)
-    handler_(msgType_, os_.str().c_str());
+  if (diagnostics) {
+    std::string message = os_.str();
+    while (!message.empty() && message.back() == '\n')
+      message.pop_back();
+    diagnostics->add({msgType_, ErrorCode::kerSuccess, ErrorCollector::noOffset, nullptr, 0, std::move(message)});
+    return;
+  }
+  if (msgType_ >= level())
+    if (auto h = handler())
+      h(msgType_, os_.str().c_str());
 }
 
 std::ostringstream& LogMsg::os() {
@@ -114,19 +126,25 @@ std::ostringstream& LogMsg::os() {
 }
 
 void LogMsg::setLevel(LogMsg::Level level) {
-  level_ = level;
+  level_.store(level, std::memory_order_relaxed);
 }
 
 void LogMsg::setHandler(LogMsg::Handler handler) {
-  handler_ = handler;
+  handler_.store(handler, std::memory_order_relaxed);
 }
 
 LogMsg::Level LogMsg::level() {
-  return level_;
+  return level_.load(std::memory_order_relaxed);
 }
 
 LogMsg::Handler LogMsg::handler() {
-  return handler_;
+  return handler_.load(std::memory_order_relaxed);
+}
+
+bool LogMsg::enabled(Level level) {
+  if (diagnostics)
+    return level >= diagnostics->level();
+  return level >= LogMsg::level() && handler();
 }
 
 void LogMsg::defaultHandler(int level, const char* s) {
@@ -188,4 +206,77 @@ void Error::setMsg(int count) {
   msg_ = msg;
 }
 
+void ErrorCollector::add(ErrorCode code, size_t offset, std::string message) {
+  errors_.push_back({code, offset, std::move(message)});
+}
+
+void ErrorCollector::clear() {
+  errors_.clear();
+}
+
+const std::vector<ErrorCollector::Entry>& ErrorCollector::errors() const {
+  return errors_;
+}
+
+bool ErrorCollector::empty() const {
+  return errors_.empty();
+}
+
+size_t ErrorCollector::count() const {
+  return errors_.size();
+}
+
+std::string Diagnostics::Record::text() const {
+  std::string result;
+  if (group) {
+    result = group;
+    if (tag) {
+      char buf[16];
+      snprintf(buf, sizeof(buf), " tag 0x%04x", tag);
+      result += buf;
+    }
+  }
+  if (offset != ErrorCollector::noOffset)
+    result += (result.empty() ? "offset " : " at offset ") + std::to_string(offset);
+  if (!result.empty())
+    result += ": ";
+  return result + message;
+}
+
+Diagnostics::Diagnostics(LogMsg::Level level) : level_(level), previous_(diagnostics) {
+  diagnostics = this;
+}
+
+Diagnostics::~Diagnostics() {
+  diagnostics = previous_;
+}
+
+void Diagnostics::add(Record record) {
+  if (record.level >= level_)
+    records_.push_back(std::move(record));
+}
+
+void Diagnostics::clear() {
+  records_.clear();
+}
+
+LogMsg::Level Diagnostics::level() const {
+  return level_;
+}
+
+const std::vector<Diagnostics::Record>& Diagnostics::records() const {
+  return records_;
+}
+
+std::string Diagnostics::text() const {
+  std::string result;
+  for (auto&& record : records_)
+    result += record.text() + "\n";
+  return result;
+}
+
+Diagnostics* Diagnostics::current() {
+  return diagnostics;
+}
+
 }  // namespace Exiv2
@@ -158,13 +158,12 @@ Exifdatum::Exifdatum(const ExifKey& key, const Value* pValue) : key_(key.clone()
     value_ = pValue->clone();
 }
 
-Exifdatum::Exifdatum(const Exifdatum& rhs) : Metadatum(rhs) {
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
+Exifdatum::Exifdatum(std::shared_ptr<const ExifKey> key, Value::UniquePtr value) :
+    key_(std::move(key)), value_(std::move(value)) {
 }
 
+Exifdatum::Exifdatum(const Exifdatum& rhs) = default;
+
 std::ostream& Exifdatum::write(std::ostream& os, const ExifData* pMetadata) const {
   if (value().count() == 0)
     return os;
@@ -204,21 +203,7 @@ const Value& Exifdatum::value() const {
   return *value_;
 }
 
-Exifdatum& Exifdatum::operator=(const Exifdatum& rhs) {
-  if (this == &rhs)
-    return *this;
-  Metadatum::operator=(rhs);
-
-  key_.reset();
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-
-  value_.reset();
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
-
-  return *this;
-}  // Exifdatum::operator=
+Exifdatum& Exifdatum::operator=(const Exifdatum& rhs) = default;
 
 Exifdatum& Exifdatum::operator=(const std::string& value) {
   setValue(value);
@@ -265,10 +250,12 @@ int Exifdatum::setValue(const std::string& value) {
     TypeId type = key_->defaultTypeId();
     value_ = Value::create(type);
   }
+  detach(value_);
   return value_->read(value);
 }
 
 int Exifdatum::setDataArea(const byte* buf, size_t len) {
+  detach(value_);
   return value_ ? value_->setDataArea(buf, len) : -1;
 }
 
@@ -340,6 +327,11 @@ std::string Exifdatum::toString(size_t n) const {
   return value_ ? value_->toString(n) : "";
 }
 
+void Exifdatum::appendTo(std::string& out) const {
+  if (value_)
+    value_->appendTo(out);
+}
+
 int64_t Exifdatum::toInt64(size_t n) const {
   return value_ ? value_->toInt64(n) : -1;
 }
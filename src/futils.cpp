@@ -49,20 +49,24 @@ namespace fs = std::filesystem;
 #endif
 
 namespace Exiv2 {
-constexpr std::array<const char*, 2> ENVARDEF{
+constexpr std::array<const char*, 4> ENVARDEF{
     "/exiv2.php",
     "40",
-};  //!< @brief default URL for http exiv2 handler and time-out
-constexpr std::array<const char*, 2> ENVARKEY{
+    "",
+    "256",
+};  //!< @brief default URL for http exiv2 handler, time-out, block cache directory and size in MB
+constexpr std::array<const char*, 4> ENVARKEY{
     "EXIV2_HTTP_POST",
     "EXIV2_TIMEOUT",
-};  //!< @brief request keys for http exiv2 handler and time-out
+    "EXIV2_CACHE_DIR",
+    "EXIV2_CACHE_SIZE",
+};  //!< @brief request keys for http exiv2 handler, time-out, block cache directory and size in MB
 
 // *****************************************************************************
 // free functions
 std::string getEnv(int env_var) {
   // this check is relying on undefined behavior and might not be effective
-  if (env_var < envHTTPPOST || env_var > envTIMEOUT) {
+  if (env_var < envHTTPPOST || env_var > envCACHESIZE) {
     throw std::out_of_range("Unexpected env variable");
   }
   return getenv(ENVARKEY[env_var]) ? getenv(ENVARKEY[env_var]) : ENVARDEF[env_var];
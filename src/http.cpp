@@ -5,11 +5,13 @@
 #if defined(_MSC_VER) || defined(__CYGWIN__) || defined(__MINGW__)
 #define __USE_W32_SOCKETS
 #include <winsock2.h>
+#define poll WSAPoll
 #endif
 
 #include "futils.hpp"
 #include "http.hpp"
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cinttypes>
@@ -29,6 +31,8 @@
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <cerrno>
@@ -131,6 +135,26 @@ static int makeNonBlocking(int sockfd) {
 #endif
 }
 
+//! Return the proxy through which server is reached, or a Uri without Host to connect directly
+static Exiv2::Uri proxyFor(const std::string& server) {
+  const char* proxy = getenv("http_proxy");
+  if (!proxy)
+    proxy = getenv("HTTP_PROXY");
+  if (!proxy)
+    return {};
+
+  // find the dictionary of no_proxy servers
+  const char* no_proxy = getenv("no_proxy");
+  if (!no_proxy)
+    no_proxy = getenv("NO_PROXY");
+  Exiv2::Dictionary noProxy = stringToDict(std::string(no_proxy ? no_proxy : "") + ",localhost,127.0.0.1");
+
+  // if the server is on the no_proxy list ... ignore the proxy!
+  if (noProxy.count(server))
+    return {};
+  return Exiv2::Uri::Parse(proxy);
+}
+
 int Exiv2::http(Exiv2::Dictionary& request, Exiv2::Dictionary& response, std::string& errors) {
   if (!request.count("verb"))
     request["verb"] = "GET";
@@ -163,27 +187,9 @@ int Exiv2::http(Exiv2::Dictionary& request, Exiv2::Dictionary& response, std::st
   const char* port_p = port;
   std::string url = std::string("http://") + request["server"] + request["page"];
 
-  // parse and change server if using a proxy
-  const char* PROXI = "HTTP_PROXY";
-  const char* proxi = "http_proxy";
-  const char* PROXY = getenv(PROXI);
-  const char* proxy = getenv(proxi);
-  bool bProx = PROXY || proxy;
-  const char* prox = bProx ? (proxy ? proxy : PROXY) : "";
-  Exiv2::Uri Proxy = Exiv2::Uri::Parse(prox);
-
-  // find the dictionary of no_proxy servers
-  const char* NO_PROXI = "NO_PROXY";
-  const char* no_proxi = "no_proxy";
-  const char* NO_PROXY = getenv(NO_PROXI);
-  const char* no_proxy = getenv(no_proxi);
-  bool bNoProxy = NO_PROXY || no_proxy;
-  std::string no_prox = std::string(bNoProxy ? (no_proxy ? no_proxy : NO_PROXY) : "");
-  Exiv2::Dictionary noProxy = stringToDict(no_prox + ",localhost,127.0.0.1");
-
-  // if the server is on the no_proxy list ... ignore the proxy!
-  if (noProxy.count(servername))
-    bProx = false;
+  // change server if using a proxy
+  Exiv2::Uri Proxy = proxyFor(request["server"]);
+  bool bProx = !Proxy.Host.empty();
 
   if (bProx) {
     servername_p = Proxy.Host.c_str();
@@ -356,4 +362,400 @@ int Exiv2::http(Exiv2::Dictionary& request, Exiv2::Dictionary& response, std::st
   return result;
 }
 
+////////////////////////////////////////
+// HttpClient
+
+//! Number of requests written to the connection before their responses are read
+static constexpr size_t pipelineDepth = 16;
+
+static bool iequals(const std::string& a, const char* b) {
+  return a.size() == strlen(b) && std::equal(a.begin(), a.end(), b, [](char x, char y) {
+           return tolower(static_cast<unsigned char>(x)) == tolower(static_cast<unsigned char>(y));
+         });
+}
+
+//! Return the value of header name in headers, compared without case, or nullptr
+static const std::string* findHeader(const Exiv2::Dictionary& headers, const char* name) {
+  for (auto&& [key, value] : headers) {
+    if (iequals(key, name))
+      return &value;
+  }
+  return nullptr;
+}
+
+static bool wouldBlock(int err) {
+#if EAGAIN != EWOULDBLOCK
+  if (err == EWOULDBLOCK)
+    return true;
+#endif
+  return err == EAGAIN || err == EINTR || err == WSAEWOULDBLOCK;
+}
+
+//! Wait at most timeout milliseconds for events on sockfd, return false on timeout or error
+static bool waitFor(int sockfd, short events, int timeout) {
+  pollfd pfd = {};
+  pfd.fd = sockfd;
+  pfd.events = events;
+  int n = poll(&pfd, 1, timeout);
+  while (n < 0 && WSAGetLastError() == EINTR)
+    n = poll(&pfd, 1, timeout);
+  return n > 0;
+}
+
+class Exiv2::HttpClient::Impl {
+ public:
+  Impl(const std::string& server, const std::string& port, int timeout);
+  ~Impl();
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+
+  /*!
+    @brief Write requests to the connection, pipelined, and read their responses.
+           Requests without a response are written again on a new connection when
+           the server closes the old one.
+    @return The highest status code of the responses, or -1 if a response is missing
+   */
+  int exchange(const std::vector<std::string>& requests, bool head, std::vector<Exiv2::Dictionary>& responses,
+               std::string& errors);
+  //! Return a request for verb and page
+  [[nodiscard]] std::string format(const std::string& verb, const std::string& page, const std::string& header) const;
+  void disconnect();
+
+  size_t connections_ = 0;
+
+ private:
+  bool connect(std::string& errors);
+  bool write(const std::string& data);
+  //! Receive more data into buffer_. Return 1 on data, 0 if the server closed the connection, -1 on error.
+  int fill();
+  /*!
+    @brief Read one response from the connection.
+    @param started Set to true as soon as any part of the response has arrived
+    @return The status code, or -1 if the connection broke
+   */
+  int read(bool head, Exiv2::Dictionary& response, bool& keepAlive, bool& started);
+  bool readBody(size_t length);
+  bool readChunked(std::string& body);
+
+  std::string server_;  //!< server as named in requests
+  std::string host_;    //!< host to connect to, either the server or a proxy
+  std::string port_;    //!< port to connect to
+  std::string prefix_;  //!< prefix of the request target, "http://server" when using a proxy
+  int timeout_;
+  int socket_ = -1;
+  std::string buffer_;  //!< data received but not yet consumed
+};
+
+Exiv2::HttpClient::Impl::Impl(const std::string& server, const std::string& port, int timeout) :
+    server_(server), host_(server), port_(port.empty() ? "80" : port), timeout_(timeout) {
+#if defined(WIN32) || defined(_MSC_VER) || defined(__MINGW__) || defined(__CYGWIN__)
+  WSADATA wsaData;
+  WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+  if (port_ != "80")
+    server_ += ":" + port_;
+  Exiv2::Uri proxy = proxyFor(server);
+  if (!proxy.Host.empty()) {
+    prefix_ = "http://" + server_;
+    host_ = proxy.Host;
+    port_ = proxy.Port.empty() ? "80" : proxy.Port;
+  }
+}
+
+Exiv2::HttpClient::Impl::~Impl() {
+  disconnect();
+}
+
+std::string Exiv2::HttpClient::Impl::format(const std::string& verb, const std::string& page,
+                                            const std::string& header) const {
+  return verb + " " + prefix_ + page +
+         " HTTP/1.1\r\n"
+         "User-Agent: exiv2http/1.0.0\r\n"
+         "Accept: */*\r\n"
+         "Host: " +
+         server_ + "\r\n" + header + "\r\n";
+}
+
+bool Exiv2::HttpClient::Impl::connect(std::string& errors) {
+  struct sockaddr_in serv_addr = {};
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_port = htons(atoi(port_.c_str()));
+  serv_addr.sin_addr.s_addr = inet_addr(host_.c_str());
+  if (serv_addr.sin_addr.s_addr == static_cast<unsigned long>(INADDR_NONE)) {
+    struct hostent* host = gethostbyname(host_.c_str());
+    if (!host) {
+      error(errors, "no such host", host_.c_str());
+      return false;
+    }
+    memcpy(&serv_addr.sin_addr, host->h_addr, sizeof(serv_addr.sin_addr));
+  }
+
+  socket_ = static_cast<int>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+  if (socket_ < 0) {
+    error(errors, "unable to create socket\n");
+    return false;
+  }
+  makeNonBlocking(socket_);
+  int one = 1;
+  setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+#ifdef SO_NOSIGPIPE
+  setsockopt(socket_, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+  int err = 0;
+  socklen_t len = sizeof(err);
+  if (::connect(socket_, reinterpret_cast<const struct sockaddr*>(&serv_addr), sizeof(serv_addr)) == SOCKET_ERROR &&
+      (WSAGetLastError() != WSAEWOULDBLOCK || !waitFor(socket_, POLLOUT, timeout_) ||
+       getsockopt(socket_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len) == SOCKET_ERROR || err)) {
+    err = err ? err : WSAGetLastError();
+    disconnect();
+    error(errors, "error - unable to connect to server = %s port = %s wsa_error = %d", host_.c_str(), port_.c_str(),
+          err);
+    return false;
+  }
+  buffer_.clear();
+  ++connections_;
+  return true;
+}
+
+void Exiv2::HttpClient::Impl::disconnect() {
+  if (socket_ >= 0)
+    ::closesocket(socket_);
+  socket_ = -1;
+  buffer_.clear();
+}
+
+bool Exiv2::HttpClient::Impl::write(const std::string& data) {
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  size_t sent = 0;
+  while (sent < data.size()) {
+    int n = send(socket_, data.data() + sent, static_cast<int>(data.size() - sent), flags);
+    if (n == SOCKET_ERROR) {
+      int err = WSAGetLastError();
+      if (!wouldBlock(err) || !waitFor(socket_, POLLOUT, timeout_))
+        return false;
+      continue;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+int Exiv2::HttpClient::Impl::fill() {
+  char buffer[64 * 1024];
+  for (;;) {
+    int n = recv(socket_, buffer, sizeof(buffer), 0);
+    if (n > 0) {
+      buffer_.append(buffer, n);
+      return 1;
+    }
+    if (n == 0)
+      return 0;
+    int err = WSAGetLastError();
+    if (!wouldBlock(err) || !waitFor(socket_, POLLIN, timeout_))
+      return -1;
+  }
+}
+
+bool Exiv2::HttpClient::Impl::readBody(size_t length) {
+  while (buffer_.size() < length) {
+    if (fill() <= 0)
+      return false;
+  }
+  return true;
+}
+
+bool Exiv2::HttpClient::Impl::readChunked(std::string& body) {
+  for (;;) {
+    size_t eol = 0;
+    while ((eol = buffer_.find("\r\n")) == std::string::npos) {
+      if (fill() <= 0)
+        return false;
+    }
+    const size_t size = strtoul(buffer_.c_str(), nullptr, 16);
+    buffer_.erase(0, eol + 2);
+    if (size == 0)
+      break;
+    if (!readBody(size + 2))
+      return false;
+    body.append(buffer_, 0, size);
+    buffer_.erase(0, size + 2);
+  }
+  // skip the trailer up to and including the empty line
+  for (;;) {
+    size_t eol = 0;
+    while ((eol = buffer_.find("\r\n")) == std::string::npos) {
+      if (fill() <= 0)
+        return false;
+    }
+    buffer_.erase(0, eol + 2);
+    if (eol == 0)
+      return true;
+  }
+}
+
+int Exiv2::HttpClient::Impl::read(bool head, Exiv2::Dictionary& response, bool& keepAlive, bool& started) {
+  started = !buffer_.empty();
+  int status = 0;
+  do {  // skip informational responses like "100 Continue"
+    response.clear();
+    size_t end = std::string::npos;  // end of the headers
+    size_t body = 0;                 // start of the body
+    while (end == std::string::npos) {
+      for (auto&& line : blankLines) {
+        size_t pos = buffer_.find(line);
+        if (pos < end) {
+          end = pos;
+          body = pos + strlen(line);
+        }
+      }
+      if (end == std::string::npos && fill() <= 0)
+        return -1;
+      started = started || !buffer_.empty();
+    }
+
+    // parse the status line and the response headers
+    size_t eol = buffer_.find('\n');
+    const std::string statusLine = buffer_.substr(0, eol < end ? eol : end);
+    response[""] = statusLine.substr(0, statusLine.find_last_not_of('\r') + 1);
+    const size_t space = statusLine.find(' ');
+    if (statusLine.compare(0, 5, "HTTP/") != 0 || space == std::string::npos)
+      return -1;
+    status = atoi(statusLine.c_str() + space);
+    keepAlive = statusLine.compare(0, 8, "HTTP/1.0") != 0;
+    for (size_t h = eol + 1; eol < end; h = eol + 1) {
+      eol = std::min(buffer_.find('\n', h), end);
+      std::string line = buffer_.substr(h, eol - h);
+      size_t colon = line.find(':');
+      if (colon == std::string::npos)
+        continue;
+      size_t value = line.find_first_not_of(" \t", colon + 1);
+      size_t last = line.find_last_not_of(" \t\r");
+      response[line.substr(0, colon)] = value <= last ? line.substr(value, last + 1 - value) : "";
+    }
+    buffer_.erase(0, body);
+  } while (100 <= status && status < 200);
+
+  if (auto connection = findHeader(response, "Connection"))
+    keepAlive = iequals(*connection, "keep-alive") || (keepAlive && !iequals(*connection, "close"));
+
+  std::string& data = response["body"];
+  if (head || status == 204 || status == 304)
+    return status;
+  auto encoding = findHeader(response, "Transfer-Encoding");
+  if (encoding && !iequals(*encoding, "identity")) {
+    if (!readChunked(data))
+      return -1;
+  } else if (auto length = findHeader(response, "Content-Length")) {
+    const auto size = static_cast<size_t>(strtoull(length->c_str(), nullptr, 10));
+    if (!readBody(size))
+      return -1;
+    data = buffer_.substr(0, size);
+    buffer_.erase(0, size);
+  } else {
+    // the body ends when the server closes the connection
+    int n = 0;
+    while ((n = fill()) > 0) {
+    }
+    if (n < 0)
+      return -1;
+    data.swap(buffer_);
+    keepAlive = false;
+  }
+  return status;
+}
+
+int Exiv2::HttpClient::Impl::exchange(const std::vector<std::string>& requests, bool head,
+                                      std::vector<Exiv2::Dictionary>& responses, std::string& errors) {
+  errors.clear();
+  responses.assign(requests.size(), {});
+  int result = 0;
+  size_t next = 0;       // first request without a response
+  bool retried = false;  // whether the current request was already written again on a new connection
+  while (next < requests.size()) {
+    const bool fresh = socket_ < 0;
+    if (fresh && !connect(errors))
+      return -1;
+
+    std::string batch;
+    const size_t first = next;
+    size_t sent = next;
+    while (sent < requests.size() && sent - next < pipelineDepth)
+      batch += requests[sent++];
+    if (!write(batch)) {
+      disconnect();
+      if (fresh || retried)
+        return error(errors, "error - unable to send to server = %s port = %s wsa_error = %d", host_.c_str(),
+                     port_.c_str(), WSAGetLastError());
+      retried = true;
+      continue;
+    }
+
+    for (size_t i = first; i < sent; ++i) {
+      bool keepAlive = false;
+      bool started = false;
+      int status = read(head, responses[i], keepAlive, started);
+      if (status < 0) {
+        disconnect();
+        // a server may close a persistent connection after any response, try those requests again once
+        if (started || retried || (fresh && i == first))
+          return error(errors, "error - no response from server = %s port = %s wsa_error = %d", host_.c_str(),
+                       port_.c_str(), WSAGetLastError());
+        retried = true;
+        break;
+      }
+      result = std::max(result, status);
+      retried = false;
+      next = i + 1;
+      if (!keepAlive) {
+        disconnect();
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+Exiv2::HttpClient::HttpClient(const std::string& server, const std::string& port, int timeout) :
+    p_(std::make_unique<Impl>(server, port, timeout)) {
+}
+
+Exiv2::HttpClient::~HttpClient() = default;
+
+int Exiv2::HttpClient::request(const std::string& verb, const std::string& page, Dictionary& response,
+                               std::string& errors, const std::string& header) {
+  std::vector<Dictionary> responses;
+  int result = p_->exchange({p_->format(verb, page, header)}, verb == "HEAD", responses, errors);
+  response = std::move(responses.front());
+  return result;
+}
+
+int Exiv2::HttpClient::get(const std::string& page, const std::vector<Range>& ranges, std::vector<std::string>& bodies,
+                           std::string& errors) {
+  std::vector<std::string> requests;
+  for (auto&& [first, last] : ranges) {
+    requests.push_back(
+        p_->format("GET", page, "Range: bytes=" + std::to_string(first) + "-" + std::to_string(last) + "\r\n"));
+  }
+  std::vector<Dictionary> responses;
+  int result = p_->exchange(requests, false, responses, errors);
+  bodies.clear();
+  for (auto&& response : responses)
+    bodies.push_back(std::move(response["body"]));
+  return result;
+}
+
+void Exiv2::HttpClient::close() {
+  p_->disconnect();
+}
+
+size_t Exiv2::HttpClient::connections() const {
+  return p_->connections_;
+}
+
 // That's all Folks
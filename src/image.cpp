@@ -497,6 +497,17 @@ void Image::printTiffStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruc
   }
 }
 
+bool Image::tryReadMetadata(ErrorCollector& errors) {
+  const size_t count = errors.count();
+  Internal::CollectErrors collect(errors);
+  try {
+    readMetadata();
+  } catch (const Error& error) {
+    Internal::collectError(error.code(), ErrorCollector::noOffset, error.what());
+  }
+  return errors.count() == count;
+}
+
 void Image::clearMetadata() {
   clearExifData();
   clearIptcData();
@@ -554,6 +565,15 @@ void Image::setExifData(const ExifData& exifData) {
   exifData_ = exifData;
 }
 
+void Image::setExifData(ExifData&& exifData) {
+  // images which cannot write the metadata reject it in the virtual setter
+  if (!(checkMode(mdExif) & amWrite)) {
+    setExifData(exifData);
+    return;
+  }
+  exifData_ = std::move(exifData);
+}
+
 void Image::clearIptcData() {
   iptcData_.clear();
 }
@@ -562,6 +582,14 @@ void Image::setIptcData(const IptcData& iptcData) {
   iptcData_ = iptcData;
 }
 
+void Image::setIptcData(IptcData&& iptcData) {
+  if (!(checkMode(mdIptc) & amWrite)) {
+    setIptcData(iptcData);
+    return;
+  }
+  iptcData_ = std::move(iptcData);
+}
+
 void Image::clearXmpPacket() {
   xmpPacket_.clear();
   writeXmpFromPacket(true);
@@ -584,6 +612,15 @@ void Image::setXmpData(const XmpData& xmpData) {
   writeXmpFromPacket(false);
 }
 
+void Image::setXmpData(XmpData&& xmpData) {
+  if (!(checkMode(mdXmp) & amWrite)) {
+    setXmpData(xmpData);
+    return;
+  }
+  xmpData_ = std::move(xmpData);
+  writeXmpFromPacket(false);
+}
+
 #ifdef EXV_HAVE_XMP_TOOLKIT
 void Image::writeXmpFromPacket(bool flag) {
   writeXmpFromPacket_ = flag;
@@ -8,6 +8,11 @@
 #include <cstring>
 #include <vector>
 
+namespace {
+thread_local Exiv2::ErrorCollector* collector = nullptr;  //!< collector of tryReadMetadata() in this thread
+thread_local size_t errorBase = 0;                         //!< base of offsets given to collectError()
+}  // namespace
+
 namespace Exiv2::Internal {
 std::string stringFormat(const char* format, ...) {
   std::string result;
@@ -43,4 +48,35 @@ std::string indent(int32_t d) {
   return result;
 }
 
+bool collectError(ErrorCode code, size_t offset, const std::string& message, const char* group, uint16_t tag) {
+  if (offset != ErrorCollector::noOffset)
+    offset += errorBase;
+  if (auto diagnostics = Diagnostics::current())
+    diagnostics->add({LogMsg::error, code, offset, group, tag, message});
+  if (!collector)
+    return false;
+  // the collector keeps the offset separately
+  const Diagnostics::Record record{LogMsg::error, code, ErrorCollector::noOffset, group, tag, message};
+  collector->add(code, offset, record.text());
+  return true;
+}
+
+CollectErrors::CollectErrors(ErrorCollector& errors) : previous_(collector), base_(errorBase) {
+  collector = &errors;
+  errorBase = 0;
+}
+
+CollectErrors::~CollectErrors() {
+  collector = previous_;
+  errorBase = base_;
+}
+
+ErrorOffset::ErrorOffset(size_t base) : previous_(errorBase) {
+  errorBase += base;
+}
+
+ErrorOffset::~ErrorOffset() {
+  errorBase = previous_;
+}
+
 }  // namespace Exiv2::Internal
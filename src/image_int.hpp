@@ -5,6 +5,7 @@
 
 // *****************************************************************************
 // included header files
+#include "error.hpp"  // for ErrorCode, ErrorCollector
 #include "slice.hpp"  // for Slice
 
 #include <cstddef>  // for size_t
@@ -102,6 +103,57 @@ inline binaryToStringHelper<T> binaryToString(const Slice<T> sl) noexcept {
 /// @brief indent output for kpsRecursive in \em printStructure() \em .
 std::string indent(int32_t depth);
 
+/*!
+  @brief Report corrupt data found by a parser: record it in the collector of the
+         Image::tryReadMetadata() which is running in this thread and in the
+         Diagnostics of this thread, if there are any.
+
+  Parsers call this where they find corrupt data. If it returns true, the parser
+  skips the corrupt part and continues with the next entry, IFD, segment or box;
+  otherwise it throws as it always did.
+
+  @param code    Error code
+  @param offset  Offset of the corrupt data, relative to the innermost ErrorOffset
+  @param message Description of the error
+  @param group   Name of the IFD group of a corrupt TIFF entry or directory
+  @param tag     Tag of a corrupt TIFF entry
+  @return true if the error was recorded in a collector
+ */
+bool collectError(ErrorCode code, size_t offset, const std::string& message, const char* group = nullptr,
+                  uint16_t tag = 0);
+
+/*!
+  @brief Scope in which collectError() records errors in a collector. Scopes nest;
+         the innermost one is used.
+ */
+class CollectErrors {
+ public:
+  explicit CollectErrors(ErrorCollector& errors);
+  ~CollectErrors();
+  CollectErrors(const CollectErrors&) = delete;
+  CollectErrors& operator=(const CollectErrors&) = delete;
+
+ private:
+  ErrorCollector* previous_;
+  size_t base_;
+};
+
+/*!
+  @brief Scope in which the offsets given to collectError() are relative to base,
+         e.g. the file offset of a TIFF structure embedded in a JPEG segment.
+         Bases of nested scopes add up.
+ */
+class ErrorOffset {
+ public:
+  explicit ErrorOffset(size_t base);
+  ~ErrorOffset();
+  ErrorOffset(const ErrorOffset&) = delete;
+  ErrorOffset& operator=(const ErrorOffset&) = delete;
+
+ private:
+  size_t previous_;
+};
+
 }  // namespace Exiv2::Internal
 
 #endif  // #ifndef IMAGE_INT_HPP_
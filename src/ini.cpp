@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <utility>
 
 using std::string;
 using namespace Exiv2;
@@ -190,11 +191,27 @@ int INIReader::ParseError() const {
 }
 
 string INIReader::Get(const string& section, const string& name, const string& default_value) {
-  string key = MakeKey(section, name);
-  return _values.count(key) ? _values[key] : default_value;
+  return std::as_const(*this).Get(section, name, default_value);
 }
 
 long INIReader::GetInteger(const string& section, const string& name, long default_value) {
+  return std::as_const(*this).GetInteger(section, name, default_value);
+}
+
+double INIReader::GetReal(const string& section, const string& name, double default_value) {
+  return std::as_const(*this).GetReal(section, name, default_value);
+}
+
+bool INIReader::GetBoolean(const string& section, const string& name, bool default_value) {
+  return std::as_const(*this).GetBoolean(section, name, default_value);
+}
+
+string INIReader::Get(const string& section, const string& name, const string& default_value) const {
+  auto value = _values.find(MakeKey(section, name));
+  return value != _values.end() ? value->second : default_value;
+}
+
+long INIReader::GetInteger(const string& section, const string& name, long default_value) const {
   string valstr = Get(section, name, "");
   const char* value = valstr.c_str();
   char* end;
@@ -203,7 +220,7 @@ long INIReader::GetInteger(const string& section, const string& name, long defau
   return end > value ? n : default_value;
 }
 
-double INIReader::GetReal(const string& section, const string& name, double default_value) {
+double INIReader::GetReal(const string& section, const string& name, double default_value) const {
   string valstr = Get(section, name, "");
   const char* value = valstr.c_str();
   char* end;
@@ -211,7 +228,7 @@ double INIReader::GetReal(const string& section, const string& name, double defa
   return end > value ? n : default_value;
 }
 
-bool INIReader::GetBoolean(const string& section, const string& name, bool default_value) {
+bool INIReader::GetBoolean(const string& section, const string& name, bool default_value) const {
   string valstr = Get(section, name, "");
   // Convert to lower case to make string comparisons case-insensitive
   std::transform(valstr.begin(), valstr.end(), valstr.begin(), ::tolower);
@@ -58,13 +58,12 @@ Iptcdatum::Iptcdatum(const IptcKey& key, const Value* pValue) : key_(key.clone()
     value_ = pValue->clone();
 }
 
-Iptcdatum::Iptcdatum(const Iptcdatum& rhs) : Metadatum(rhs) {
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
+Iptcdatum::Iptcdatum(std::shared_ptr<const IptcKey> key, Value::UniquePtr value) :
+    key_(std::move(key)), value_(std::move(value)) {
 }
 
+Iptcdatum::Iptcdatum(const Iptcdatum& rhs) = default;
+
 size_t Iptcdatum::copy(byte* buf, ByteOrder byteOrder) const {
   return value_ ? value_->copy(buf, byteOrder) : 0;
 }
@@ -133,6 +132,11 @@ std::string Iptcdatum::toString(size_t n) const {
   return value_ ? value_->toString(n) : "";
 }
 
+void Iptcdatum::appendTo(std::string& out) const {
+  if (value_)
+    value_->appendTo(out);
+}
+
 int64_t Iptcdatum::toInt64(size_t n) const {
   return value_ ? value_->toInt64(n) : -1;
 }
@@ -155,21 +159,7 @@ const Value& Iptcdatum::value() const {
   return *value_;
 }
 
-Iptcdatum& Iptcdatum::operator=(const Iptcdatum& rhs) {
-  if (this == &rhs)
-    return *this;
-  Metadatum::operator=(rhs);
-
-  key_.reset();
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-
-  value_.reset();
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
-
-  return *this;
-}  // Iptcdatum::operator=
+Iptcdatum& Iptcdatum::operator=(const Iptcdatum& rhs) = default;
 
 Iptcdatum& Iptcdatum::operator=(const uint16_t& value) {
   auto v = std::make_unique<UShortValue>();
@@ -199,6 +189,7 @@ int Iptcdatum::setValue(const std::string& value) {
     TypeId type = IptcDataSets::dataSetType(tag(), record());
     value_ = Value::create(type);
   }
+  detach(value_);
   return value_->read(value);
 }
 
@@ -146,19 +146,32 @@ void JpegBase::readMetadata() {
   byte marker = advanceToMarker(ErrorCode::kerNotAJpeg);
 
   while (marker != sos_ && marker != eoi_ && search > 0) {
+    const size_t start = io_->tell();  // file offset of buf
     auto [sizebuf, size] = readSegmentSize(marker, *io_);
 
     // Read the rest of the segment.
     DataBuf buf(size);
     /// \todo check if it makes sense to check for size
     if (size > 0) {
-      io_->readOrThrow(buf.data(2), size - 2, ErrorCode::kerFailedToReadImageData);
+      if (io_->read(buf.data(2), size - 2) != size - 2u || io_->error()) {
+        if (!Internal::collectError(ErrorCode::kerFailedToReadImageData, start, "JPEG segment is truncated"))
+          throw Error(ErrorCode::kerFailedToReadImageData);
+        break;
+      }
       std::copy(sizebuf.begin(), sizebuf.end(), buf.begin());
     }
 
     if (!foundExifData && marker == app1_ && size >= 8  // prevent out-of-bounds read in memcmp on next line
         && buf.cmpBytes(2, exifId_, 6) == 0) {
-      ByteOrder bo = ExifParser::decode(exifData_, buf.c_data(8), size - 8);
+      ByteOrder bo = invalidByteOrder;
+      try {
+        Internal::ErrorOffset base(start + 8);
+        bo = ExifParser::decode(exifData_, buf.c_data(8), size - 8);
+      } catch (const Error& error) {
+        // continue with the next segment in best-effort mode
+        if (!Internal::collectError(error.code(), start, error.what()))
+          throw;
+      }
       setByteOrder(bo);
       if (size > 8 && byteOrder() == invalidByteOrder) {
 #ifndef SUPPRESS_WARNINGS
@@ -204,6 +217,7 @@ void JpegBase::readMetadata() {
     } else if (marker == app2_ && size >= 13  // prevent out-of-bounds read in memcmp on next line
                && buf.cmpBytes(2, iccId_, 11) == 0) {
       if (size < 2 + 14 + 4) {
+        Internal::collectError(ErrorCode::kerInvalidIccProfile, start, "ICC profile segment is too small");
         rc = 8;
         break;
       }
@@ -239,6 +253,7 @@ void JpegBase::readMetadata() {
     } else if (pixelHeight_ == 0 && inRange2(marker, sof0_, sof3_, sof5_, sof15_)) {
       // We hit a SOFn (start-of-frame) marker
       if (size < 8) {
+        Internal::collectError(ErrorCode::kerCorruptedMetadata, start, "JPEG frame header is too small");
         rc = 7;
         break;
       }
@@ -252,6 +267,7 @@ void JpegBase::readMetadata() {
     try {
       marker = advanceToMarker(ErrorCode::kerFailedToReadImageData);
     } catch (Error&) {
+      Internal::collectError(ErrorCode::kerFailedToReadImageData, io_->tell(), "JPEG data ends before the image data");
       rc = 5;
       break;
     }
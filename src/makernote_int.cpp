@@ -16,8 +16,12 @@
 
 // + standard includes
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 namespace fs = std::filesystem;
 
@@ -44,6 +48,25 @@ std::string getExifModel(Exiv2::Internal::TiffComponent* pRoot);
 
 //! Nikon en/decryption function
 void ncrypt(Exiv2::byte* pData, uint32_t size, uint32_t count, uint32_t serial);
+
+//! Parsed Exiv2 configuration file. Never modified once it is published.
+struct Exiv2Config {
+  std::string path_;                          //!< Path of the configuration file
+  bool exists_{false};                        //!< True if the file existed when it was read
+  fs::file_time_type mtime_;                  //!< Modification time of the file when it was read
+  std::unique_ptr<Exiv2::INIReader> reader_;  //!< Parsed file, nullptr if it doesn't exist or has errors
+};
+
+//! Interval in which exiv2Config() checks the configuration file at most once
+constexpr auto configCheckInterval =
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)).count();
+
+/*!
+  @brief Return the current configuration. The path and modification time of the
+         file are checked at most once per configCheckInterval, and the file is
+         read again only if they changed.
+ */
+std::shared_ptr<const Exiv2Config> exiv2Config();
 }  // namespace
 
 // *****************************************************************************
@@ -72,21 +95,21 @@ std::string getExiv2ConfigPath() {
     currentPath = buffer;
   }
 #else
-  struct passwd* pw = getpwuid(getuid());
-  currentPath = std::string(pw ? pw->pw_dir : "");
+  // The home directory doesn't change while the process runs, look it up only once
+  static const std::string homeDir = [] {
+    struct passwd* pw = getpwuid(getuid());
+    return std::string(pw ? pw->pw_dir : "");
+  }();
+  currentPath = homeDir;
 #endif
   return (currentPath / inifile).string();
 }
 
 std::string readExiv2Config(const std::string& section, const std::string& value, const std::string& def) {
-  std::string result = def;
-
-  Exiv2::INIReader reader(Exiv2::Internal::getExiv2ConfigPath());
-  if (reader.ParseError() == 0) {
-    result = reader.Get(section, value, def);
-  }
-
-  return result;
+  const auto config = exiv2Config();
+  if (!config->reader_)
+    return def;
+  return config->reader_->Get(section, value, def);
 }
 
 const TiffMnRegistry TiffMnCreator::registry_[] = {
@@ -1023,6 +1046,47 @@ int sonyMisc3cSelector(uint16_t /*tag*/, const byte* /*pData*/, size_t /*size*/,
 // *****************************************************************************
 // local definitions
 namespace {
+std::shared_ptr<const Exiv2Config> exiv2Config() {
+  // Only the latest configuration is kept, readers hold on to the one they use
+  static std::shared_ptr<const Exiv2Config> current;
+  static std::mutex mutex;
+  static std::atomic<std::chrono::steady_clock::rep> checked{0};
+
+  // the file system is asked at most once per interval, the print path only loads the pointer
+  const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  auto config = std::atomic_load_explicit(&current, std::memory_order_acquire);
+  if (config && now - checked.load(std::memory_order_relaxed) < configCheckInterval)
+    return config;
+
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // another thread checks the file right now
+    if (config)
+      return config;
+    lock.lock();
+  }
+  config = std::atomic_load_explicit(&current, std::memory_order_acquire);
+  const std::string path = Exiv2::Internal::getExiv2ConfigPath();
+  std::error_code ec;
+  const auto mtime = fs::last_write_time(path, ec);
+  const bool exists = !ec;
+  if (!config || config->path_ != path || config->exists_ != exists || (exists && config->mtime_ != mtime)) {
+    auto fresh = std::make_unique<Exiv2Config>();
+    fresh->path_ = path;
+    fresh->exists_ = exists;
+    fresh->mtime_ = mtime;
+    if (exists) {
+      auto reader = std::make_unique<Exiv2::INIReader>(path);
+      if (reader->ParseError() == 0)
+        fresh->reader_ = std::move(reader);
+    }
+    config = std::move(fresh);
+    std::atomic_store_explicit(&current, config, std::memory_order_release);
+  }
+  checked.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+  return config;
+}
+
 const Exiv2::Value* getExifValue(Exiv2::Internal::TiffComponent* pRoot, const uint16_t& tag,
                                  const Exiv2::Internal::IfdId& group) {
   Exiv2::Internal::TiffFinder finder(tag, group);
@@ -23,6 +23,10 @@ std::string getExiv2ConfigPath();
 
 /*!
   @brief Read value from Exiv2 configuration file
+
+  The file is parsed only once and shared between threads. It is read again
+  when its path or modification time changes, which is checked at most once
+  a second.
  */
 std::string readExiv2Config(const std::string& section, const std::string& value, const std::string& def);
 
@@ -2,6 +2,11 @@
 
 #include "metadatum.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <regex>
+#include <unordered_set>
+
 namespace Exiv2 {
 Key::UniquePtr Key::clone() const {
   return UniquePtr(clone_());
@@ -13,6 +18,24 @@ std::string Metadatum::print(const ExifData* pMetadata) const {
   return os.str();
 }
 
+void Metadatum::appendTo(std::string& out) const {
+  out += toString();
+}
+
+void Metadatum::detach(std::shared_ptr<Value>& value) {
+  if (!value)
+    return;
+  // A count of one cannot grow behind our back: only this metadatum holds the
+  // value, and modifying it while another thread copies it is a data race anyway.
+  // use_count() is a relaxed load, the fence orders the modification after the
+  // reads of threads which released their copies.
+  if (value.use_count() > 1) {
+    value = value->clone();
+  } else {
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+}
+
 uint32_t Metadatum::toUint32(size_t n) const {
   return static_cast<uint32_t>(toInt64(n));
 }
@@ -25,4 +48,204 @@ bool cmpMetadataByKey(const Metadatum& lhs, const Metadatum& rhs) {
   return lhs.key() < rhs.key();
 }
 
+namespace {
+//! Stands for the '.' wildcard in the text of literal patterns, keys don't contain it
+constexpr char wildcard = '\0';
+
+char toLowerAscii(char c) {
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string toLowerAscii(std::string str) {
+  for (auto&& c : str)
+    c = toLowerAscii(c);
+  return str;
+}
+
+/*!
+  @brief Parse a POSIX basic regular expression which consists of plain text,
+         '.' wildcards, escaped special characters and optional anchors.
+         Return false if \em pattern uses any other feature (or might, in the
+         case of characters which are special only in some contexts).
+ */
+bool parseLiteral(const std::string& pattern, bool ignoreCase, std::string& text, bool& anchorStart,
+                  bool& anchorEnd) {
+  size_t begin = 0;
+  size_t end = pattern.size();
+  anchorStart = end > 0 && pattern[0] == '^';
+  if (anchorStart)
+    ++begin;
+  anchorEnd = false;
+  if (end > begin && pattern[end - 1] == '$') {
+    // A '$' preceded by an odd number of backslashes is escaped
+    size_t backslashes = 0;
+    while (end - 1 - backslashes > begin && pattern[end - 2 - backslashes] == '\\')
+      ++backslashes;
+    if (backslashes % 2 == 0) {
+      anchorEnd = true;
+      --end;
+    }
+  }
+  text.clear();
+  for (size_t i = begin; i < end; ++i) {
+    char c = pattern[i];
+    if (c == '\\') {
+      if (++i == end || std::string_view(".*[]\\^$").find(pattern[i]) == std::string_view::npos)
+        return false;
+      c = pattern[i];
+    } else if (c == '.') {
+      c = wildcard;
+    } else if (c == wildcard || std::string_view("*[]^$+?(){}|").find(c) != std::string_view::npos) {
+      return false;
+    }
+    // Case folding of non-ASCII characters depends on the locale, leave it to std::regex
+    if (ignoreCase && static_cast<unsigned char>(c) >= 0x80)
+      return false;
+    text += ignoreCase ? toLowerAscii(c) : c;
+  }
+  return true;
+}
+
+//! Return true if \em text matches \em key at position \em pos
+bool matchesAt(const std::string& text, const std::string& key, size_t pos) {
+  if (pos + text.size() > key.size())
+    return false;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == wildcard ? key[pos + i] == wildcard : text[i] != key[pos + i])
+      return false;
+  }
+  return true;
+}
+
+//! Trie of literal patterns anchored at the start of the key
+class Trie {
+ public:
+  //! Add \em text, which must match the whole key if \em exact is true, else a prefix of it
+  void add(const std::string& text, bool exact) {
+    size_t node = 0;
+    for (auto&& c : text) {
+      auto next = std::find_if(nodes_[node].next.begin(), nodes_[node].next.end(),
+                               [c](const auto& edge) { return edge.first == c; });
+      if (next != nodes_[node].next.end()) {
+        node = next->second;
+      } else {
+        nodes_[node].next.emplace_back(c, nodes_.size());
+        node = nodes_.size();
+        nodes_.emplace_back();
+      }
+    }
+    (exact ? nodes_[node].exact : nodes_[node].prefix) = true;
+  }
+
+  [[nodiscard]] bool empty() const {
+    return nodes_.size() == 1 && !nodes_[0].exact && !nodes_[0].prefix;
+  }
+
+  [[nodiscard]] bool matches(const std::string& key, size_t pos = 0, size_t node = 0) const {
+    const Node& n = nodes_[node];
+    if (n.prefix || (n.exact && pos == key.size()))
+      return true;
+    if (pos == key.size())
+      return false;
+    for (auto&& [c, next] : n.next) {
+      if ((c == key[pos] || (c == wildcard && key[pos] != wildcard)) && matches(key, pos + 1, next))
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  struct Node {
+    std::vector<std::pair<char, size_t>> next;  //!< Child nodes by character, wildcard for '.'
+    bool prefix{false};                         //!< A pattern "^text" ends here
+    bool exact{false};                          //!< A pattern "^text$" ends here
+  };
+  std::vector<Node> nodes_{1};
+};
+}  // namespace
+
+//! Patterns of a KeyFilter, grouped by how they are matched. The second of each pair is for lower case keys.
+struct KeyFilter::Impl {
+  std::pair<std::unordered_set<std::string>, std::unordered_set<std::string>> keys;  //!< Exact keys
+  std::pair<Trie, Trie> tries;                                                      //!< "^text" and "^text$"
+  std::pair<std::vector<std::string>, std::vector<std::string>> suffixes;           //!< "text$"
+  std::pair<std::vector<std::string>, std::vector<std::string>> infixes;            //!< "text"
+  std::vector<std::regex> regexes;                                                  //!< Everything else
+  bool empty{true};
+};
+
+KeyFilter::KeyFilter() : p_(std::make_unique<Impl>()) {
+}
+
+KeyFilter::~KeyFilter() = default;
+
+KeyFilter::KeyFilter(const KeyFilter& rhs) : p_(std::make_unique<Impl>(*rhs.p_)) {
+}
+
+KeyFilter& KeyFilter::operator=(const KeyFilter& rhs) {
+  if (this != &rhs)
+    *p_ = *rhs.p_;
+  return *this;
+}
+
+void KeyFilter::addKey(const std::string& key) {
+  p_->keys.first.insert(key);
+  p_->empty = false;
+}
+
+void KeyFilter::addPattern(const std::string& pattern, bool ignoreCase) {
+  std::string text;
+  bool anchorStart = false;
+  bool anchorEnd = false;
+  if (!parseLiteral(pattern, ignoreCase, text, anchorStart, anchorEnd)) {
+    auto flags = std::regex::basic | std::regex::optimize | std::regex::nosubs;
+    p_->regexes.emplace_back(pattern, ignoreCase ? flags | std::regex::icase : flags);
+  } else if (anchorStart && anchorEnd && text.find(wildcard) == std::string::npos) {
+    (ignoreCase ? p_->keys.second : p_->keys.first).insert(text);
+  } else if (anchorStart) {
+    (ignoreCase ? p_->tries.second : p_->tries.first).add(text, anchorEnd);
+  } else if (anchorEnd) {
+    (ignoreCase ? p_->suffixes.second : p_->suffixes.first).push_back(text);
+  } else {
+    (ignoreCase ? p_->infixes.second : p_->infixes.first).push_back(text);
+  }
+  p_->empty = false;
+}
+
+bool KeyFilter::empty() const {
+  return p_->empty;
+}
+
+bool KeyFilter::matches(const std::string& key) const {
+  auto matchesLiteral = [](const std::string& k, const auto& keys, const Trie& trie, const auto& suffixes,
+                           const auto& infixes) {
+    if (!keys.empty() && keys.find(k) != keys.end())
+      return true;
+    if (!trie.empty() && trie.matches(k))
+      return true;
+    for (auto&& suffix : suffixes) {
+      if (suffix.size() <= k.size() && matchesAt(suffix, k, k.size() - suffix.size()))
+        return true;
+    }
+    for (auto&& infix : infixes) {
+      for (size_t pos = 0; pos + infix.size() <= k.size(); ++pos) {
+        if (matchesAt(infix, k, pos))
+          return true;
+      }
+    }
+    return false;
+  };
+
+  if (matchesLiteral(key, p_->keys.first, p_->tries.first, p_->suffixes.first, p_->infixes.first))
+    return true;
+  if (!p_->keys.second.empty() || !p_->tries.second.empty() || !p_->suffixes.second.empty() ||
+      !p_->infixes.second.empty()) {
+    if (matchesLiteral(toLowerAscii(key), p_->keys.second, p_->tries.second, p_->suffixes.second,
+                       p_->infixes.second))
+      return true;
+  }
+  return std::any_of(p_->regexes.begin(), p_->regexes.end(),
+                     [&key](const std::regex& re) { return std::regex_search(key, re); });
+}
+
 }  // namespace Exiv2
@@ -1460,7 +1460,7 @@ static bool inRange(long value, long min, long max) {
 }
 
 static std::ostream& resolvedLens(std::ostream& os, long lensID, long index) {
-  const TagDetails* td = find(minoltaSonyLensID, lensID);
+  const TagDetails* td = EXV_FIND_TAG_DETAILS(minoltaSonyLensID)(lensID);
   std::vector<std::string> tokens = split(td[0].label_, "|");
   return os << exvGettext(trim(tokens.at(index - 1)).c_str());
 }
@@ -1640,11 +1640,13 @@ std::ostream& printMinoltaSonyLensID(std::ostream& os, const Value& value, const
   const std::string undefined("undefined");
   const std::string minolta("minolta");
   const std::string sony("sony");
-  if (Internal::readExiv2Config(minolta, value.toString(), undefined) != undefined) {
-    return os << Internal::readExiv2Config(minolta, value.toString(), undefined);
+  const std::string minoltaConfig = Internal::readExiv2Config(minolta, value.toString(), undefined);
+  if (minoltaConfig != undefined) {
+    return os << minoltaConfig;
   }
-  if (Internal::readExiv2Config(sony, value.toString(), undefined) != undefined) {
-    return os << Internal::readExiv2Config(sony, value.toString(), undefined);
+  const std::string sonyConfig = Internal::readExiv2Config(sony, value.toString(), undefined);
+  if (sonyConfig != undefined) {
+    return os << sonyConfig;
   }
 
   // #1145 - respect lenses with shared LensID
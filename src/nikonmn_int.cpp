@@ -1556,8 +1556,9 @@ static bool testConfigFile(std::ostream& os, const Value& value) {
   bool result = false;
   const std::string undefined("undefined");
   const std::string section("nikon");
-  if (Internal::readExiv2Config(section, value.toString(), undefined) != undefined) {
-    os << Internal::readExiv2Config(section, value.toString(), undefined);
+  const std::string config = Internal::readExiv2Config(section, value.toString(), undefined);
+  if (config != undefined) {
+    os << config;
     result = true;
   }
   return result;
@@ -1579,9 +1580,8 @@ std::ostream& Nikon3MakerNote::printLensId4(std::ostream& os, const Value& value
   return testConfigFile(os, value) ? os : printLensId(os, value, metadata, "NikonLd4");
 }
 
-std::ostream& Nikon3MakerNote::printLensId(std::ostream& os, const Value& value, const ExifData* metadata,
-                                           const std::string& group) {
 #ifdef EXV_HAVE_LENSDATA
+const FMntLens* fmountLenses() {
 // 8< - - - 8< do not remove this line >8 - - - >8
 //------------------------------------------------------------------------------
 #ifndef FMOUNTLH
@@ -1663,10 +1663,7 @@ std::ostream& Nikon3MakerNote::printLensId(std::ostream& os, const Value& value,
   // Nikkor lenses by their LensID
   //------------------------------------------------------------------------------
 
-  static const struct FMntLens {
-    unsigned char lid, stps, focs, focl, aps, apl, lfw, ltype, tcinfo, dblid, mid;
-    const char *manuf, *lnumber, *lensname;
-  } fmountlens[] = {
+  static const FMntLens fmountlens[] = {
       {0x01, 0x58, 0x50, 0x50, 0x14, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, "Nikon", "JAA00901", "AF Nikkor 50mm f/1.8"},
       {0x01, 0x58, 0x50, 0x50, 0x14, 0x14, 0x05, 0x00, 0x00, 0x00, 0x00, "Nikon", "JAA00901", "AF Nikkor 50mm f/1.8"},
       {0x02, 0x42, 0x44, 0x5C, 0x2A, 0x34, 0x02, 0x00, 0x00, 0x00, 0x00, "Nikon", "JAA72701",
@@ -2746,29 +2743,47 @@ std::ostream& Nikon3MakerNote::printLensId(std::ostream& os, const Value& value,
 #endif
   // 8< - - - 8< do not remove this line >8 - - - >8
 
+  /* the anonymous struct of fmountlens[] is replaced with FMntLens from
+   * nikonmn_int.hpp
+   *
+   * remember to replace the struct when importing/updating the lens info
+   * from:
+   *
+   * www.rottmerhusen.com/objektives/lensid/files/c-header/fmountlens4.h
+   */
+  return fmountlens;
+}
+#endif  // EXV_HAVE_LENSDATA
+
+std::ostream& Nikon3MakerNote::printLensId(std::ostream& os, const Value& value, const ExifData* metadata,
+                                           const std::string& group) {
+#ifdef EXV_HAVE_LENSDATA
+  // Index of the lenses by their LensIDNumber, each list is in the order of fmountlens[]
+  static const auto lensesById = [] {
+    std::array<std::vector<const FMntLens*>, 256> index;
+    for (const FMntLens* pf = fmountLenses(); pf->lensname; ++pf) {
+      index[pf->lid].push_back(pf);
+    }
+    return index;
+  }();
+
   /* if no meta obj is provided, try to use the value param that *may*
    * be the pre-parsed lensid
    */
   if (!metadata) {
-    const auto vid = static_cast<unsigned char>(value.toInt64(0));
-
-    /* the 'FMntLens' name is added to the anonymous struct for
-     * fmountlens[]
-     *
-     * remember to name the struct when importing/updating the lens info
-     * from:
-     *
-     * www.rottmerhusen.com/objektives/lensid/files/c-header/fmountlens4.h
-     */
-    const struct FMntLens* pf = fmountlens;
-    while (pf->lid && pf->lensname) {
-      if (pf->lid == vid) {
-        break;
+    // Only the entries before the first one with a zero LensIDNumber are considered here
+    static const auto firstLensById = [] {
+      std::array<const FMntLens*, 256> index{};
+      for (const FMntLens* pf = fmountLenses(); pf->lid && pf->lensname; ++pf) {
+        if (!index[pf->lid])
+          index[pf->lid] = pf;
       }
-      ++pf;
-    }
+      return index;
+    }();
 
-    if (!pf->lensname) {
+    const auto vid = static_cast<unsigned char>(value.toInt64(0));
+    const FMntLens* pf = firstLensById[vid];
+    if (!pf) {
       return os << value;
     }
     return os << pf->manuf << " " << pf->lensname;
@@ -2797,25 +2812,27 @@ std::ostream& Nikon3MakerNote::printLensId(std::ostream& os, const Value& value,
   }
   raw[7] = static_cast<byte>(md->toInt64());
 
-  for (int i = 0; fmountlens[i].lensname; ++i) {
-    if (raw[0] == fmountlens[i].lid) {
-      // #1034
-      const std::string undefined("undefined");
-      const std::string section("nikon");
-      std::ostringstream lensIDStream;
-      lensIDStream << static_cast<int>(raw[7]);
-      if (Internal::readExiv2Config(section, lensIDStream.str(), undefined) != undefined) {
-        return os << Internal::readExiv2Config(section, lensIDStream.str(), undefined);
-      }
+  const auto& lenses = lensesById[raw[0]];
+  if (!lenses.empty()) {
+    // #1034
+    const std::string undefined("undefined");
+    const std::string section("nikon");
+    std::ostringstream lensIDStream;
+    lensIDStream << static_cast<int>(raw[7]);
+    const std::string config = Internal::readExiv2Config(section, lensIDStream.str(), undefined);
+    if (config != undefined) {
+      return os << config;
     }
+  }
 
-    if (raw[0] == fmountlens[i].lid
-        // stps varies with focal length for some Sigma zoom lenses.
-        && (raw[1] == fmountlens[i].stps || strcmp(fmountlens[i].manuf, "Sigma") == 0) &&
-        raw[2] == fmountlens[i].focs && raw[3] == fmountlens[i].focl && raw[4] == fmountlens[i].aps &&
-        raw[5] == fmountlens[i].apl && raw[6] == fmountlens[i].lfw && raw[7] == fmountlens[i].ltype) {
+  for (auto&& pf : lenses) {
+    if ((raw[1] == pf->stps
+         // stps varies with focal length for some Sigma zoom lenses.
+         || strcmp(pf->manuf, "Sigma") == 0) &&
+        raw[2] == pf->focs && raw[3] == pf->focl && raw[4] == pf->aps && raw[5] == pf->apl && raw[6] == pf->lfw &&
+        raw[7] == pf->ltype) {
       // Lens found in database
-      return os << fmountlens[i].manuf << " " << fmountlens[i].lensname;
+      return os << pf->manuf << " " << pf->lensname;
     }
   }
   // Lens not found in database
@@ -3231,7 +3248,7 @@ std::ostream& Nikon3MakerNote::print0x009e(std::ostream& os, const Value& value,
     if (l != 0)
       trim = false;
     std::string d = s.empty() ? "" : "; ";
-    const TagDetails* td = find(nikonRetouchHistory, l);
+    const TagDetails* td = EXV_FIND_TAG_DETAILS(nikonRetouchHistory)(l);
     if (td) {
       s = std::string(exvGettext(td->label_)) + d + s;
     } else {
@@ -279,6 +279,17 @@ class Nikon3MakerNote {
 
 };  // class Nikon3MakerNote
 
+#ifdef EXV_HAVE_LENSDATA
+//! Entry of the Nikon F-mount lens database, see Nikon3MakerNote::printLensId()
+struct FMntLens {
+  unsigned char lid, stps, focs, focl, aps, apl, lfw, ltype, tcinfo, dblid, mid;
+  const char *manuf, *lnumber, *lensname;
+};
+
+//! Return the Nikon F-mount lens database by Robert Rottmerhusen, the last entry has no lensname
+const FMntLens* fmountLenses();
+#endif
+
 }  // namespace Exiv2::Internal
 
 #endif  // #ifndef NIKONMN_INT_HPP_
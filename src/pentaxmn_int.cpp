@@ -1090,7 +1090,7 @@ std::ostream& resolveLens0x32c(std::ostream& os, const Value& value, const ExifD
 
     if (index > 0) {
       const unsigned long lensID = 0x32c;
-      const TagDetails* td = find(pentaxLensType, lensID);
+      const TagDetails* td = EXV_FIND_TAG_DETAILS(pentaxLensType)(lensID);
       os << exvGettext(td[index].label_);
       return os;
     }
@@ -1154,7 +1154,7 @@ std::ostream& resolveLens0x3ff(std::ostream& os, const Value& value, const ExifD
 
     if (index > 0) {
       const unsigned long lensID = 0x3ff;
-      const TagDetails* td = find(pentaxLensType, lensID);
+      const TagDetails* td = EXV_FIND_TAG_DETAILS(pentaxLensType)(lensID);
       os << exvGettext(td[index].label_);
       return os;
     }
@@ -1181,7 +1181,7 @@ std::ostream& resolveLens0x8ff(std::ostream& os, const Value& value, const ExifD
 
     if (index > 0) {
       const unsigned long lensID = 0x8ff;
-      const TagDetails* td = find(pentaxLensType, lensID);
+      const TagDetails* td = EXV_FIND_TAG_DETAILS(pentaxLensType)(lensID);
       os << exvGettext(td[index].label_);
       return os;
     }
@@ -1215,7 +1215,7 @@ std::ostream& resolveLens0x319(std::ostream& os, const Value& value, const ExifD
 
     if (index > 0) {
       const unsigned long lensID = 0x319;
-      const TagDetails* td = find(pentaxLensType, lensID);
+      const TagDetails* td = EXV_FIND_TAG_DETAILS(pentaxLensType)(lensID);
       os << exvGettext(td[index].label_);
       return os;
     }
@@ -1252,8 +1252,9 @@ std::ostream& printLensType(std::ostream& os, const Value& value, const ExifData
   // #1034
   const std::string undefined("undefined");
   const std::string section("pentax");
-  if (Internal::readExiv2Config(section, value.toString(), undefined) != undefined) {
-    return os << Internal::readExiv2Config(section, value.toString(), undefined);
+  const std::string config = Internal::readExiv2Config(section, value.toString(), undefined);
+  if (config != undefined) {
+    return os << config;
   }
 
   const auto index = value.toUint32(0) * 256 + value.toUint32(1);
@@ -25,6 +25,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <string>
 
 /*
@@ -346,32 +347,40 @@ std::string PngChunk::makeMetadataChunk(const std::string& metadata, MetadataId
 
 }  // PngChunk::makeMetadataChunk
 
-void PngChunk::zlibUncompress(const byte* compressedText, unsigned int compressedTextSize, DataBuf& arr) {
-  uLongf uncompressedLen = compressedTextSize * 2;  // just a starting point
-  int zlibResult;
-  int dos = 0;
-
-  do {
-    arr.alloc(uncompressedLen);
-    zlibResult = uncompress(arr.data(), &uncompressedLen, compressedText, compressedTextSize);
-    if (zlibResult == Z_OK) {
-      arr.resize(uncompressedLen);
-    } else if (zlibResult == Z_BUF_ERROR) {
-      // the uncompressedArray needs to be larger
-      uncompressedLen *= 2;
-      // DoS protection. can't be bigger than 64k
-      if (uncompressedLen > 131072) {
-        if (++dos > 1)
-          break;
-        uncompressedLen = 131072;
-      }
-    } else {
-      // something bad happened
-      throw Error(ErrorCode::kerFailedToReadImageData);
+bool PngChunk::zlibInflate(const byte* data, size_t size, DataBuf& result, size_t maxSize) {
+  z_stream stream = {};
+  if (size > std::numeric_limits<uInt>::max() || inflateInit(&stream) != Z_OK)
+    return false;
+  stream.next_in = const_cast<byte*>(data);
+  stream.avail_in = static_cast<uInt>(size);
+
+  // Start with room for a compression ratio of 4:1 and double it when full,
+  // allowing one byte more than maxSize to detect an oversized stream
+  const size_t limit = std::min<size_t>(maxSize + 1, std::numeric_limits<uInt>::max());
+  result.alloc(std::min<size_t>(std::max<size_t>(size * 4, 1024), limit));
+  size_t total = 0;
+  int zlibResult = Z_OK;
+  while (zlibResult == Z_OK) {
+    if (total == result.size()) {
+      if (total == limit)
+        break;
+      result.resize(std::min(total * 2, limit));
     }
-  } while (zlibResult == Z_BUF_ERROR);
+    stream.next_out = result.data() + total;
+    stream.avail_out = static_cast<uInt>(result.size() - total);
+    zlibResult = inflate(&stream, Z_NO_FLUSH);
+    total = result.size() - stream.avail_out;
+  }
+  inflateEnd(&stream);
 
-  if (zlibResult != Z_OK) {
+  result.resize(total);
+  return zlibResult == Z_STREAM_END && total <= maxSize;
+}
+
+void PngChunk::zlibUncompress(const byte* compressedText, unsigned int compressedTextSize, DataBuf& arr) {
+  // DoS protection: the text can't be bigger than 128k, or twice the compressed size
+  const size_t maxSize = std::max<size_t>(131072, compressedTextSize * size_t{2});
+  if (!zlibInflate(compressedText, compressedTextSize, arr, maxSize)) {
     throw Error(ErrorCode::kerFailedToReadImageData);
   }
 }  // PngChunk::zlibUncompress
@@ -72,6 +72,18 @@ class PngChunk {
   */
   static std::string makeMetadataChunk(const std::string& metadata, MetadataId type);
 
+  /*!
+    @brief Inflate the zlib stream \em data of \em size bytes into \em result
+           in a single pass, growing the buffer as needed.
+
+    @param data    Compressed data.
+    @param size    Size of the compressed data.
+    @param result  Buffer for the uncompressed data, resized to fit it exactly.
+    @param maxSize Limit of the uncompressed size, to guard against decompression bombs.
+    @return true if the stream is complete and inflates to at most \em maxSize bytes.
+  */
+  static bool zlibInflate(const byte* data, size_t size, DataBuf& result, size_t maxSize);
+
  private:
   /*!
     @brief Parse PNG Text chunk to determine type and extract content.
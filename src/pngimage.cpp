@@ -44,6 +44,146 @@ inline bool compare(std::string_view str, const Exiv2::DataBuf& buf) {
   const auto minlen = std::min(str.size(), buf.size());
   return buf.cmpBytes(0, str.data(), minlen) == 0;
 }
+
+//! Position, data length and type of a PNG chunk
+struct ChunkHeader {
+  size_t offset;    //!< Offset of the chunk (its length field) in the file
+  uint32_t length;  //!< Length of the chunk data
+  char type[5];     //!< Chunk type, nul terminated
+
+  //! Return true if the chunk type is \em chunkType
+  [[nodiscard]] bool is(const char* chunkType) const {
+    return std::memcmp(type, chunkType, 4) == 0;
+  }
+  //! Offset of the chunk data
+  [[nodiscard]] size_t dataOffset() const {
+    return offset + 8;
+  }
+  //! Offset of the next chunk: 4 bytes length, 4 bytes type, data and 4 bytes CRC
+  [[nodiscard]] size_t end() const {
+    return offset + 12 + length;
+  }
+};
+
+/*!
+  @brief Walk the chunks of a PNG file. Reads the file in blocks while the
+         chunks are small, so that the headers of a run of small chunks,
+         typically IDAT image data, come from one read instead of a seek and
+         a read each. After a large chunk only the next header is read, so
+         that large image data is skipped. The chunk data is only read on
+         request.
+ */
+class ChunkWalker {
+ public:
+  //! Walk the chunks of \em io, starting with the one at the current position
+  explicit ChunkWalker(Exiv2::BasicIo& io) : io_(io), size_(io.size()), next_(static_cast<size_t>(io.tell())) {
+  }
+
+  /*!
+    @brief Return the header of the next chunk.
+    @throw Error if the header is truncated or the chunk data doesn't fit in the file
+   */
+  ChunkHeader next() {
+    ChunkHeader header;
+    if (auto error = next(header); error != Exiv2::ErrorCode::kerSuccess)
+      throw Exiv2::Error(error);
+    return header;
+  }
+
+  /*!
+    @brief Read the header of the next chunk into \em header, without throwing.
+    @return kerSuccess, or the error if the header is truncated or the chunk data
+            doesn't fit in the file. header.offset is set in any case.
+   */
+  Exiv2::ErrorCode next(ChunkHeader& header) {
+    header = {next_, 0, {}};
+    Exiv2::byte buf[8];
+    // a block read only pays off if it holds the headers of several chunks
+    const bool refill = previousLength_ < blockCapacity / 4;
+    if (next_ > size_ || read(next_, buf, 8, refill) != 8)
+      return Exiv2::ErrorCode::kerInputDataReadFailed;
+    header.length = Exiv2::getULong(buf, Exiv2::bigEndian);
+    previousLength_ = header.length;
+    if (header.length > 0x7FFFFFFF || header.length > size_ - header.dataOffset())
+      return Exiv2::ErrorCode::kerFailedToReadImageData;
+    std::memcpy(header.type, buf + 4, 4);
+    header.type[4] = '\0';
+    next_ = header.end();
+    return Exiv2::ErrorCode::kerSuccess;
+  }
+
+  //! Read \em count bytes at \em offset into \em buf, return the number of bytes read
+  size_t read(size_t offset, Exiv2::byte* buf, size_t count) {
+    return read(offset, buf, count, true);
+  }
+
+  //! Return the data of chunk \em header
+  Exiv2::DataBuf readData(const ChunkHeader& header) {
+    Exiv2::DataBuf data(header.length);
+    if (header.length > 0 && read(header.dataOffset(), data.data(), data.size()) != data.size())
+      throw Exiv2::Error(Exiv2::ErrorCode::kerInputDataReadFailed);
+    return data;
+  }
+
+  //! Copy \em count bytes at \em offset to \em out in large blocks
+  void copy(size_t offset, size_t count, Exiv2::BasicIo& out) {
+    Exiv2::DataBuf buf(std::min(count, copyCapacity));
+    while (count > 0) {
+      const size_t n = std::min(count, buf.size());
+      if (readIo(offset, buf.data(), n) != n)
+        throw Exiv2::Error(Exiv2::ErrorCode::kerInputDataReadFailed);
+      if (out.write(buf.c_data(), n) != n)
+        throw Exiv2::Error(Exiv2::ErrorCode::kerImageWriteFailed);
+      offset += n;
+      count -= n;
+    }
+  }
+
+ private:
+  static constexpr size_t blockCapacity = 64 * 1024;  //!< Size of the blocks for the headers
+  static constexpr size_t copyCapacity = 1024 * 1024;  //!< Size of the blocks for copying
+
+  /*!
+    @brief Read \em count bytes at \em offset into \em buf from the current block.
+           If they are not in the block, read a new block if \em refill is true,
+           else read only the requested bytes.
+   */
+  size_t read(size_t offset, Exiv2::byte* buf, size_t count, bool refill) {
+    if (count == 0)
+      return 0;
+    if (offset < blockOffset_ || offset + count > blockOffset_ + blockSize_) {
+      if (!refill || count >= blockCapacity)
+        return readIo(offset, buf, count);
+      if (block_.empty())
+        block_.alloc(blockCapacity);
+      blockOffset_ = offset;
+      blockSize_ = readIo(offset, block_.data(), std::min(blockCapacity, size_ - std::min(offset, size_)));
+      count = std::min(count, blockSize_);
+    }
+    if (count > 0)
+      std::memcpy(buf, block_.c_data(offset - blockOffset_), count);
+    return count;
+  }
+
+  size_t readIo(size_t offset, Exiv2::byte* buf, size_t count) {
+    if (offset >= size_)
+      return 0;
+    if (io_.seek(static_cast<int64_t>(offset), Exiv2::BasicIo::beg) != 0)
+      throw Exiv2::Error(Exiv2::ErrorCode::kerFailedToReadImageData);
+    const size_t n = io_.read(buf, count);
+    if (io_.error())
+      throw Exiv2::Error(Exiv2::ErrorCode::kerFailedToReadImageData);
+    return n;
+  }
+
+  Exiv2::BasicIo& io_;
+  const size_t size_;
+  size_t next_;               //!< Offset of the next chunk
+  Exiv2::DataBuf block_;      //!< Current block of the file
+  size_t blockOffset_{0};     //!< Offset of the block in the file
+  size_t blockSize_{0};       //!< Number of valid bytes in the block
+  size_t previousLength_{0};  //!< Data length of the previous chunk
+};
 }  // namespace
 
 // *****************************************************************************
@@ -73,32 +213,8 @@ std::string PngImage::mimeType() const {
 }
 
 static bool zlibToDataBuf(const byte* bytes, long length, DataBuf& result) {
-  uLongf uncompressedLen = length * 2;  // just a starting point
-  int zlibResult = Z_BUF_ERROR;
-
-  do {
-    result.alloc(uncompressedLen);
-    zlibResult = uncompress(result.data(), &uncompressedLen, bytes, length);
-    // if result buffer is large than necessary, redo to fit perfectly.
-    if (zlibResult == Z_OK && uncompressedLen < result.size()) {
-      result.reset();
-
-      result.alloc(uncompressedLen);
-      zlibResult = uncompress(result.data(), &uncompressedLen, bytes, length);
-    }
-    if (zlibResult == Z_BUF_ERROR) {
-      // the uncompressed buffer needs to be larger
-      result.reset();
-
-      // Sanity - never bigger than 16mb
-      if (uncompressedLen > 16 * 1024 * 1024)
-        zlibResult = Z_DATA_ERROR;
-      else
-        uncompressedLen *= 2;
-    }
-  } while (zlibResult == Z_BUF_ERROR);
-
-  return zlibResult == Z_OK;
+  // Sanity - never bigger than 16mb
+  return PngChunk::zlibInflate(bytes, length, result, 16 * 1024 * 1024);
 }
 
 static bool zlibToCompressed(const byte* bytes, long length, DataBuf& result) {
@@ -204,39 +320,20 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
       out << " address | chunk |  length | data                           | checksum" << std::endl;
     }
 
-    const size_t imgSize = io_->size();
-    DataBuf cheaderBuf(8);
-
-    while (!io_->eof() && ::strcmp(chType, "IEND") != 0) {
-      size_t address = io_->tell();
-
-      size_t bufRead = io_->read(cheaderBuf.data(), cheaderBuf.size());
-      if (io_->error())
-        throw Error(ErrorCode::kerFailedToReadImageData);
-      if (bufRead != cheaderBuf.size())
-        throw Error(ErrorCode::kerInputDataReadFailed);
-
-      // Decode chunk data length.
-      const uint32_t dataOffset = cheaderBuf.read_uint32(0, Exiv2::bigEndian);
-      for (int i = 4; i < 8; i++) {
-        chType[i - 4] = cheaderBuf.read_uint8(i);
-      }
-
-      // test that we haven't hit EOF, or wanting to read excessive data
-      long restore = io_->tell();
-      if (restore == -1 || dataOffset > static_cast<uint32_t>(0x7FFFFFFF) || dataOffset > imgSize - restore) {
-        throw Exiv2::Error(ErrorCode::kerFailedToReadImageData);
-      }
+    ChunkWalker walker(*io_);
+    while (::strcmp(chType, "IEND") != 0) {
+      const ChunkHeader header = walker.next();
+      const size_t address = header.offset;
+      const uint32_t dataOffset = header.length;
+      std::memcpy(chType, header.type, 4);
 
-      DataBuf buff(dataOffset);
-      if (dataOffset > 0) {
-        bufRead = io_->read(buff.data(), dataOffset);
-        enforce(bufRead == dataOffset, ErrorCode::kerFailedToReadImageData);
-      }
-      io_->seek(restore, BasicIo::beg);
+      // Only the chunks which may be dumped below are read completely, else the start of the data is enough
+      const int iMax = 30;
+      DataBuf buff(dataOffset > iMax ? iMax : dataOffset);
+      size_t bufRead = walker.read(header.dataOffset(), buff.data(), buff.size());
+      enforce(bufRead == buff.size(), ErrorCode::kerFailedToReadImageData);
 
       // format output
-      const int iMax = 30;
       const uint32_t blen = dataOffset > iMax ? iMax : dataOffset;
       std::string dataString;
       // if blen == 0 => slice construction fails
@@ -250,11 +347,9 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
       dataString = dataString.substr(0, iMax);
 
       if (bPrint) {
-        io_->seek(dataOffset, BasicIo::cur);  // jump to checksum
         byte checksum[4];
-        bufRead = io_->read(checksum, 4);
+        bufRead = walker.read(header.dataOffset() + dataOffset, checksum, 4);
         enforce(bufRead == 4, ErrorCode::kerFailedToReadImageData);
-        io_->seek(restore, BasicIo::beg);  // restore file pointer
 
         out << Internal::stringFormat("%8d | %-5s |%8d | ", static_cast<uint32_t>(address), chType, dataOffset)
             << dataString
@@ -285,9 +380,8 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
         enforce(dataOffset < std::numeric_limits<uint32_t>::max(), ErrorCode::kerFailedToReadImageData);
         DataBuf data(dataOffset + 1ul);
         data.write_uint8(dataOffset, 0);
-        bufRead = io_->read(data.data(), dataOffset);
+        bufRead = walker.read(header.dataOffset(), data.data(), dataOffset);
         enforce(bufRead == dataOffset, ErrorCode::kerFailedToReadImageData);
-        io_->seek(restore, BasicIo::beg);
         size_t name_l = std::strlen(data.c_str()) + 1;  // leading string length
         enforce(name_l < dataOffset, ErrorCode::kerCorruptedMetadata);
 
@@ -342,7 +436,7 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
             std::copy(dataBuf.begin(), dataBuf.end(), s.begin());  // copy in the dataBuf
             s.write_uint8(dataBuf.size(), 0);                      // nul terminate it
             const auto str = s.c_str();                            // give it name
-            out << Internal::indent(depth) << buff.c_str() << ": " << str;
+            out << Internal::indent(depth) << data.c_str() << ": " << str;
             bLF = true;
           }
 
@@ -352,7 +446,7 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
           }
 
           if (bDesc && iTXt) {
-            DataBuf decoded = PngChunk::decodeTXTChunk(buff, PngChunk::iTXt_Chunk);
+            DataBuf decoded = PngChunk::decodeTXTChunk(DataBuf(data.c_data(), dataOffset), PngChunk::iTXt_Chunk);
             out.write(decoded.c_str(), decoded.size());
             bLF = true;
           }
@@ -366,26 +460,10 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, in
             out << std::endl;
         }
       }
-      io_->seek(dataOffset + 4, BasicIo::cur);  // jump past checksum
-      if (io_->error())
-        throw Error(ErrorCode::kerFailedToReadImageData);
     }
   }
 }
 
-void readChunk(DataBuf& buffer, BasicIo& io) {
-#ifdef EXIV2_DEBUG_MESSAGES
-  std::cout << "Exiv2::PngImage::readMetadata: Position: " << io.tell() << std::endl;
-#endif
-  const size_t bufRead = io.read(buffer.data(), buffer.size());
-  if (io.error()) {
-    throw Error(ErrorCode::kerFailedToReadImageData);
-  }
-  if (bufRead != buffer.size()) {
-    throw Error(ErrorCode::kerInputDataReadFailed);
-  }
-}
-
 void PngImage::readMetadata() {
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::PngImage::readMetadata: Reading PNG file " << io_->path() << std::endl;
@@ -399,78 +477,67 @@ void PngImage::readMetadata() {
   }
   clearMetadata();
 
-  const size_t imgSize = io_->size();
-  DataBuf cheaderBuf(8);  // Chunk header: 4 bytes (data size) + 4 bytes (chunk type).
-
-  while (!io_->eof()) {
-    readChunk(cheaderBuf, *io_);  // Read chunk header.
-
-    // Decode chunk data length.
-    uint32_t chunkLength = cheaderBuf.read_uint32(0, Exiv2::bigEndian);
-    long pos = io_->tell();
-    if (pos == -1 || chunkLength > static_cast<uint32_t>(0x7FFFFFFF) || chunkLength > imgSize - pos) {
-      throw Exiv2::Error(ErrorCode::kerFailedToReadImageData);
+  ChunkWalker walker(*io_);
+  while (true) {
+    ChunkHeader header;
+    if (auto error = walker.next(header); error != ErrorCode::kerSuccess) {
+      // keep the metadata of the chunks before a truncated one in best-effort mode
+      if (!Internal::collectError(error, header.offset, "PNG chunk is truncated"))
+        throw Error(error);
+      return;
     }
-
-    std::string chunkType(cheaderBuf.c_str(4), 4);
+    const uint32_t chunkLength = header.length;
+    const std::string chunkType(header.type, 4);
 #ifdef EXIV2_DEBUG_MESSAGES
     std::cout << "Exiv2::PngImage::readMetadata: chunk type: " << chunkType << " length: " << chunkLength << std::endl;
 #endif
 
     /// \todo analyse remaining chunks of the standard
-    // Perform a chunk triage for item that we need.
+    // Perform a chunk triage for item that we need. The data of all other chunks, like the
+    // image data in the IDAT chunks, is never read.
     if (chunkType == "IEND" || chunkType == "IHDR" || chunkType == "tEXt" || chunkType == "zTXt" ||
         chunkType == "eXIf" || chunkType == "iTXt" || chunkType == "iCCP") {
-      DataBuf chunkData(chunkLength);
-      if (chunkLength > 0) {
-        readChunk(chunkData, *io_);  // Extract chunk data.
-      }
+      DataBuf chunkData = walker.readData(header);  // Extract chunk data.
 
       if (chunkType == "IEND") {
         return;  // Last chunk found: we stop parsing.
       }
-      if (chunkType == "IHDR" && chunkData.size() >= 8) {
-        PngChunk::decodeIHDRChunk(chunkData, &pixelWidth_, &pixelHeight_);
-      } else if (chunkType == "tEXt") {
-        PngChunk::decodeTXTChunk(this, chunkData, PngChunk::tEXt_Chunk);
-      } else if (chunkType == "zTXt") {
-        PngChunk::decodeTXTChunk(this, chunkData, PngChunk::zTXt_Chunk);
-      } else if (chunkType == "iTXt") {
-        PngChunk::decodeTXTChunk(this, chunkData, PngChunk::iTXt_Chunk);
-      } else if (chunkType == "eXIf") {
-        ByteOrder bo = TiffParser::decode(exifData(), iptcData(), xmpData(), chunkData.c_data(), chunkData.size());
-        setByteOrder(bo);
-      } else if (chunkType == "iCCP") {
-        // The ICC profile name can vary from 1-79 characters.
-        uint32_t iccOffset = 0;
-        do {
-          enforce(iccOffset < 80 && iccOffset < chunkLength, Exiv2::ErrorCode::kerCorruptedMetadata);
-        } while (chunkData.read_uint8(iccOffset++) != 0x00);
-
-        profileName_ = std::string(chunkData.c_str(), iccOffset - 1);
-        ++iccOffset;  // +1 = 'compressed' flag
-        enforce(iccOffset <= chunkLength, Exiv2::ErrorCode::kerCorruptedMetadata);
-
-        zlibToDataBuf(chunkData.c_data(iccOffset), chunkLength - iccOffset, iccProfile_);
+      try {
+        if (chunkType == "IHDR" && chunkData.size() >= 8) {
+          PngChunk::decodeIHDRChunk(chunkData, &pixelWidth_, &pixelHeight_);
+        } else if (chunkType == "tEXt") {
+          PngChunk::decodeTXTChunk(this, chunkData, PngChunk::tEXt_Chunk);
+        } else if (chunkType == "zTXt") {
+          PngChunk::decodeTXTChunk(this, chunkData, PngChunk::zTXt_Chunk);
+        } else if (chunkType == "iTXt") {
+          PngChunk::decodeTXTChunk(this, chunkData, PngChunk::iTXt_Chunk);
+        } else if (chunkType == "eXIf") {
+          Internal::ErrorOffset base(header.dataOffset());
+          ByteOrder bo = TiffParser::decode(exifData(), iptcData(), xmpData(), chunkData.c_data(), chunkData.size());
+          setByteOrder(bo);
+        } else if (chunkType == "iCCP") {
+          // The ICC profile name can vary from 1-79 characters.
+          uint32_t iccOffset = 0;
+          do {
+            enforce(iccOffset < 80 && iccOffset < chunkLength, Exiv2::ErrorCode::kerCorruptedMetadata);
+          } while (chunkData.read_uint8(iccOffset++) != 0x00);
+
+          profileName_ = std::string(chunkData.c_str(), iccOffset - 1);
+          ++iccOffset;  // +1 = 'compressed' flag
+          enforce(iccOffset <= chunkLength, Exiv2::ErrorCode::kerCorruptedMetadata);
+
+          zlibToDataBuf(chunkData.c_data(iccOffset), chunkLength - iccOffset, iccProfile_);
 #ifdef EXIV2_DEBUG_MESSAGES
-        std::cout << "Exiv2::PngImage::readMetadata: profile name: " << profileName_ << std::endl;
-        std::cout << "Exiv2::PngImage::readMetadata: iccProfile.size_ (uncompressed) : " << iccProfile_.size()
-                  << std::endl;
+          std::cout << "Exiv2::PngImage::readMetadata: profile name: " << profileName_ << std::endl;
+          std::cout << "Exiv2::PngImage::readMetadata: iccProfile.size_ (uncompressed) : " << iccProfile_.size()
+                    << std::endl;
 #endif
+        }
+      } catch (const Error& error) {
+        // continue with the next chunk in best-effort mode
+        if (!Internal::collectError(error.code(), header.offset, error.what()))
+          throw;
       }
-
-      // Set chunkLength to 0 in case we have read a supported chunk type. Otherwise, we need to seek the
-      // file to the next chunk position.
-      chunkLength = 0;
-    }
-
-    // Move to the next chunk: chunk data size + 4 CRC bytes.
-#ifdef EXIV2_DEBUG_MESSAGES
-    std::cout << "Exiv2::PngImage::readMetadata: Seek to offset: " << chunkLength + 4 << std::endl;
-#endif
-    io_->seek(chunkLength + 4, BasicIo::cur);
-    if (io_->error() || io_->eof()) {
-      throw Error(ErrorCode::kerFailedToReadImageData);
     }
   }
 }  // PngImage::readMetadata
@@ -507,43 +574,34 @@ void PngImage::doWriteMetadata(BasicIo& outIo) {
   if (outIo.write(pngSignature, 8) != 8)
     throw Error(ErrorCode::kerImageWriteFailed);
 
-  DataBuf cheaderBuf(8);  // Chunk header : 4 bytes (data size) + 4 bytes (chunk type).
-
-  while (!io_->eof()) {
-    // Read chunk header.
-    size_t bufRead = io_->read(cheaderBuf.data(), 8);
-    if (io_->error())
-      throw Error(ErrorCode::kerFailedToReadImageData);
-    if (bufRead != 8)
-      throw Error(ErrorCode::kerInputDataReadFailed);
-
-    // Decode chunk data length.
-
-    uint32_t dataOffset = cheaderBuf.read_uint32(0, Exiv2::bigEndian);
-    if (dataOffset > 0x7FFFFFFF)
-      throw Exiv2::Error(ErrorCode::kerFailedToReadImageData);
-
-    // Read whole chunk : Chunk header + Chunk data (not fixed size - can be null) + CRC (4 bytes).
-
-    DataBuf chunkBuf(8 + dataOffset + 4);                   // Chunk header (8 bytes) + Chunk data + CRC (4 bytes).
-    std::copy_n(cheaderBuf.begin(), 8, chunkBuf.begin());   // Copy header.
-    bufRead = io_->read(chunkBuf.data(8), dataOffset + 4);  // Extract chunk data + CRC
-    if (io_->error())
-      throw Error(ErrorCode::kerFailedToReadImageData);
-    if (bufRead != dataOffset + 4)
-      throw Error(ErrorCode::kerInputDataReadFailed);
+  // Chunks which are copied unchanged are collected in a range [copyBegin, copyEnd) of the input, so that
+  // runs of them, like the IDAT image data, are copied in large blocks.
+  ChunkWalker walker(*io_);
+  size_t copyBegin = 0;
+  size_t copyEnd = 0;
+  auto flush = [&] {
+    walker.copy(copyBegin, copyEnd - copyBegin, outIo);
+    copyBegin = copyEnd = 0;
+  };
+  auto copyChunk = [&](const ChunkHeader& header) {
+    if (copyEnd != header.offset) {
+      flush();
+      copyBegin = header.offset;
+    }
+    copyEnd = header.end();
+  };
 
-    char szChunk[5];
-    memcpy(szChunk, cheaderBuf.c_data(4), 4);
-    szChunk[4] = 0;
+  while (true) {
+    const ChunkHeader header = walker.next();
+    const char* szChunk = header.type;
 
     if (!strcmp(szChunk, "IEND")) {
       // Last chunk found: we write it and done.
 #ifdef EXIV2_DEBUG_MESSAGES
-      std::cout << "Exiv2::PngImage::doWriteMetadata: Write IEND chunk (length: " << dataOffset << ")\n";
+      std::cout << "Exiv2::PngImage::doWriteMetadata: Write IEND chunk (length: " << header.length << ")\n";
 #endif
-      if (outIo.write(chunkBuf.data(), chunkBuf.size()) != chunkBuf.size())
-        throw Error(ErrorCode::kerImageWriteFailed);
+      copyChunk(header);
+      flush();
       return;
     }
     if (!strcmp(szChunk, "eXIf")) {
@@ -551,10 +609,10 @@ void PngImage::doWriteMetadata(BasicIo& outIo) {
       ;  // as zTXt chunk with signature Raw profile type exif__
     } else if (!strcmp(szChunk, "IHDR")) {
 #ifdef EXIV2_DEBUG_MESSAGES
-      std::cout << "Exiv2::PngImage::doWriteMetadata: Write IHDR chunk (length: " << dataOffset << ")\n";
+      std::cout << "Exiv2::PngImage::doWriteMetadata: Write IHDR chunk (length: " << header.length << ")\n";
 #endif
-      if (outIo.write(chunkBuf.data(), chunkBuf.size()) != chunkBuf.size())
-        throw Error(ErrorCode::kerImageWriteFailed);
+      copyChunk(header);
+      flush();
 
       // Write all updated metadata here, just after IHDR.
       if (!comment_.empty()) {
@@ -638,31 +696,33 @@ void PngImage::doWriteMetadata(BasicIo& outIo) {
       }
     } else if (!strcmp(szChunk, "tEXt") || !strcmp(szChunk, "zTXt") || !strcmp(szChunk, "iTXt") ||
                !strcmp(szChunk, "iCCP")) {
+      // Read whole chunk : Chunk header + Chunk data (not fixed size - can be null) + CRC (4 bytes).
+      DataBuf chunkBuf(header.end() - header.offset);
+      if (walker.read(header.offset, chunkBuf.data(), chunkBuf.size()) != chunkBuf.size())
+        throw Error(ErrorCode::kerInputDataReadFailed);
       DataBuf key = PngChunk::keyTXTChunk(chunkBuf, true);
       if (!key.empty() && (compare("Raw profile type exif", key) || compare("Raw profile type APP1", key) ||
                            compare("Raw profile type iptc", key) || compare("Raw profile type xmp", key) ||
                            compare("XML:com.adobe.xmp", key) || compare("icc", key) ||  // see test/data/imagemagick.png
                            compare("ICC", key) || compare("Description", key))) {
 #ifdef EXIV2_DEBUG_MESSAGES
-        std::cout << "Exiv2::PngImage::doWriteMetadata: strip " << szChunk << " chunk (length: " << dataOffset << ")"
+        std::cout << "Exiv2::PngImage::doWriteMetadata: strip " << szChunk << " chunk (length: " << header.length << ")"
                   << std::endl;
 #endif
       } else {
 #ifdef EXIV2_DEBUG_MESSAGES
-        std::cout << "Exiv2::PngImage::doWriteMetadata: write " << szChunk << " chunk (length: " << dataOffset << ")"
+        std::cout << "Exiv2::PngImage::doWriteMetadata: write " << szChunk << " chunk (length: " << header.length << ")"
                   << std::endl;
 #endif
-        if (outIo.write(chunkBuf.c_data(), chunkBuf.size()) != chunkBuf.size())
-          throw Error(ErrorCode::kerImageWriteFailed);
+        copyChunk(header);
       }
     } else {
       // Write all others chunk as well.
 #ifdef EXIV2_DEBUG_MESSAGES
-      std::cout << "Exiv2::PngImage::doWriteMetadata:  copy " << szChunk << " chunk (length: " << dataOffset << ")"
+      std::cout << "Exiv2::PngImage::doWriteMetadata:  copy " << szChunk << " chunk (length: " << header.length << ")"
                 << std::endl;
 #endif
-      if (outIo.write(chunkBuf.c_data(), chunkBuf.size()) != chunkBuf.size())
-        throw Error(ErrorCode::kerImageWriteFailed);
+      copyChunk(header);
     }
   }
 
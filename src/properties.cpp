@@ -12,6 +12,8 @@
 #include "xmp_exiv2.hpp"
 
 #include <iostream>
+#include <string_view>
+#include <unordered_map>
 
 namespace {
 //! Struct used in the lookup table for pretty print functions
@@ -4863,6 +4865,57 @@ bool XmpPropertyInfo::operator==(const std::string& name) const {
   return n == name;
 }
 
+namespace {
+/*!
+  @brief Hash indices over the built-in tables, built once on first use.
+         They are not constexpr: the property lists are declared extern
+         before xmpNsInfo so that it can point to them, and their contents
+         are not constant expressions where the index would be built.
+ */
+struct XmpBuiltinIndex {
+  using PropertyIndex = std::unordered_map<std::string_view, const XmpPropertyInfo*>;
+
+  XmpBuiltinIndex() {
+    for (auto&& xn : xmpNsInfo) {
+      // Keep the first entry if the tables contain duplicates, like find() does
+      byPrefix_.emplace(xn.prefix_, &xn);
+      byNs_.emplace(xn.ns_, &xn);
+      if (!xn.xmpPropertyInfo_)
+        continue;
+      auto& pi = properties_[xn.xmpPropertyInfo_];
+      for (const XmpPropertyInfo* p = xn.xmpPropertyInfo_; p->name_; ++p) {
+        pi.emplace(p->name_, p);
+      }
+    }
+  }
+
+  const XmpNsInfo* prefix(std::string_view prefix) const {
+    auto i = byPrefix_.find(prefix);
+    return i == byPrefix_.end() ? nullptr : i->second;
+  }
+
+  const XmpNsInfo* ns(std::string_view ns) const {
+    auto i = byNs_.find(ns);
+    return i == byNs_.end() ? nullptr : i->second;
+  }
+
+  //! Returns nullptr if \em list is not one of the built-in property lists
+  const PropertyIndex* properties(const XmpPropertyInfo* list) const {
+    auto i = properties_.find(list);
+    return i == properties_.end() ? nullptr : &i->second;
+  }
+
+  std::unordered_map<std::string_view, const XmpNsInfo*> byPrefix_;
+  std::unordered_map<std::string_view, const XmpNsInfo*> byNs_;
+  std::unordered_map<const XmpPropertyInfo*, PropertyIndex> properties_;
+};
+
+const XmpBuiltinIndex& xmpBuiltinIndex() {
+  static const XmpBuiltinIndex index;
+  return index;
+}
+}  // namespace
+
 XmpProperties::NsRegistry XmpProperties::nsRegistry_;
 std::mutex XmpProperties::mutex_;
 
@@ -4945,7 +4998,7 @@ std::string XmpProperties::prefix(const std::string& ns) {
   if (i != nsRegistry_.end()) {
     p = i->second.prefix_;
   } else {
-    const XmpNsInfo* xn = find(xmpNsInfo, XmpNsInfo::Ns(ns2));
+    const XmpNsInfo* xn = xmpBuiltinIndex().ns(ns2);
     if (xn)
       p = std::string(xn->prefix_);
   }
@@ -4996,6 +5049,10 @@ const XmpPropertyInfo* XmpProperties::propertyInfo(const XmpKey& key) {
   const XmpPropertyInfo* pl = propertyList(prefix);
   if (!pl)
     return nullptr;
+  if (auto index = xmpBuiltinIndex().properties(pl)) {
+    auto j = index->find(property);
+    return j == index->end() ? nullptr : j->second;
+  }
   const XmpPropertyInfo* pi = nullptr;
   for (int j = 0; pl[j].name_; ++j) {
     if (0 == strcmp(pl[j].name_, property.c_str())) {
@@ -5024,7 +5081,7 @@ const XmpNsInfo* XmpProperties::nsInfoUnsafe(const std::string& prefix) {
   const XmpNsInfo::Prefix pf(prefix);
   const XmpNsInfo* xn = lookupNsRegistryUnsafe(pf);
   if (!xn)
-    xn = find(xmpNsInfo, pf);
+    xn = xmpBuiltinIndex().prefix(prefix);
   if (!xn)
     throw Error(ErrorCode::kerNoNamespaceInfoForXmpPrefix, prefix);
   return xn;
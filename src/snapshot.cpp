@@ -0,0 +1,446 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "snapshot.hpp"
+
+#include "enforce.hpp"
+#include "error.hpp"
+#include "exif.hpp"
+#include "image.hpp"
+#include "iptc.hpp"
+#include "properties.hpp"
+#include "tags_int.hpp"
+#include "value.hpp"
+#include "xmp_exiv2.hpp"
+
+#include <cstring>
+#include <map>
+#include <set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using namespace Exiv2;
+
+constexpr char magic[] = {'E', 'x', 'v', '2', 'S', 'n', 'a', 'p'};
+//! Exif keys which cannot be made from their tag and group are stored as strings
+constexpr byte numericKey = 0;
+constexpr byte stringKey = 1;
+
+//! Appends little endian numbers and strings to a snapshot
+class Writer {
+ public:
+  explicit Writer(Blob& blob) : blob_(blob) {
+  }
+
+  void u8(byte b) {
+    blob_.push_back(b);
+  }
+  void u16(uint16_t u) {
+    u8(static_cast<byte>(u));
+    u8(static_cast<byte>(u >> 8));
+  }
+  void u32(uint32_t u) {
+    u16(static_cast<uint16_t>(u));
+    u16(static_cast<uint16_t>(u >> 16));
+  }
+  void bytes(const byte* data, size_t size) {
+    u32(static_cast<uint32_t>(size));
+    blob_.insert(blob_.end(), data, data + size);
+  }
+  void bytes(const std::string& s) {
+    bytes(reinterpret_cast<const byte*>(s.data()), s.size());
+  }
+  //! Write the index of \em s in the string table, adding it if it is not in the table yet
+  void string(const std::string& s) {
+    auto pos = index_.find(s);
+    if (pos == index_.end())
+      pos = index_.emplace(s, static_cast<uint32_t>(index_.size())).first;
+    u32(pos->second);
+  }
+
+  //! Return the string table, in the order of the indexes
+  [[nodiscard]] std::vector<const std::string*> strings() const {
+    std::vector<const std::string*> strings(index_.size());
+    for (auto&& [s, index] : index_)
+      strings[index] = &s;
+    return strings;
+  }
+
+ private:
+  Blob& blob_;
+  std::unordered_map<std::string, uint32_t> index_;
+};
+
+//! Reads little endian numbers and strings from a snapshot, throws if the snapshot ends too early
+class Reader {
+ public:
+  Reader(const byte* data, size_t size) : data_(data), size_(size) {
+  }
+
+  const byte* take(size_t n) {
+    enforce(n <= size_ - pos_, ErrorCode::kerCorruptedMetadata);
+    const byte* p = data_ + pos_;
+    pos_ += n;
+    return p;
+  }
+  byte u8() {
+    return *take(1);
+  }
+  uint16_t u16() {
+    const byte* p = take(2);
+    return static_cast<uint16_t>(p[0] | p[1] << 8);
+  }
+  uint32_t u32() {
+    const byte* p = take(4);
+    return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+  }
+  std::string_view bytes() {
+    const size_t size = u32();
+    return {reinterpret_cast<const char*>(take(size)), size};
+  }
+  //! Read a count of entries which take at least \em minSize bytes each
+  size_t count(size_t minSize) {
+    const size_t n = u32();
+    enforce(n <= (size_ - pos_) / minSize, ErrorCode::kerCorruptedMetadata);
+    return n;
+  }
+  [[nodiscard]] bool atEnd() const {
+    return pos_ == size_;
+  }
+
+  //! Read the string table
+  void readStrings() {
+    strings_.resize(count(4));
+    for (auto&& s : strings_)
+      s = bytes();
+  }
+  //! Read the index of a string in the string table and return the string
+  std::string_view string() {
+    const uint32_t index = u32();
+    enforce(index < strings_.size(), ErrorCode::kerCorruptedMetadata);
+    return strings_[index];
+  }
+
+ private:
+  const byte* data_;
+  size_t size_;
+  size_t pos_{};
+  std::vector<std::string_view> strings_;
+};
+
+/*!
+  @brief Keys of the metadata decoded by a thread, which the metadata of all snapshots
+         share. Making keys is the most expensive part of decoding and most snapshots
+         have the same keys.
+ */
+template <typename Id, typename Key>
+class KeyCache {
+ public:
+  //! Return the key \em id, made by \em make if it is not in the cache
+  template <typename Lookup, typename Make>
+  std::shared_ptr<const Key> get(const Lookup& id, Make make) {
+    auto pos = keys_.find(id);
+    if (pos == keys_.end()) {
+      if (keys_.size() >= maxSize)
+        keys_.clear();
+      pos = keys_.emplace(Id(id), make()).first;
+    }
+    return pos->second;
+  }
+
+ private:
+  static constexpr size_t maxSize = 10000;
+  std::map<Id, std::shared_ptr<const Key>, std::less<>> keys_;
+};
+
+/*!
+  @brief Write a value as the type id which Value::create() makes it from, its bytes
+         in little endian order and its data area.
+ */
+void writeValue(Writer& w, const Metadatum& md) {
+  if (md.typeId() == invalidTypeId) {  // no value
+    w.u32(invalidTypeId);
+    return;
+  }
+  const Value& value = md.value();
+  // comments have the type id undefined, which Value::create() makes a DataValue from
+  w.u32(dynamic_cast<const CommentValue*>(&value) ? comment : value.typeId());
+  Blob buf(value.size());
+  w.bytes(buf.data(), value.copy(buf.data(), littleEndian));
+  const DataBuf area = value.sizeDataArea() ? value.dataArea() : DataBuf();
+  w.bytes(area.c_data(), area.size());
+}
+
+Value::UniquePtr readValue(Reader& r) {
+  const auto typeId = static_cast<TypeId>(r.u32());
+  if (typeId == invalidTypeId)
+    return nullptr;
+  auto value = Value::create(typeId);
+  const std::string_view bytes = r.bytes();
+  value->read(reinterpret_cast<const byte*>(bytes.data()), bytes.size(), littleEndian);
+  const std::string_view area = r.bytes();
+  if (!area.empty())
+    value->setDataArea(reinterpret_cast<const byte*>(area.data()), area.size());
+  return value;
+}
+
+//! Kinds of XMP values. The strings of XmpValues go to the string table, other values are written like Exif values.
+enum XmpKind : byte { otherValue, textValue, arrayValue, langAltValue };
+
+void writeXmpValue(Writer& w, const Xmpdatum& xmp) {
+  const Value* value = xmp.typeId() == invalidTypeId ? nullptr : &xmp.value();
+  const auto text = dynamic_cast<const XmpTextValue*>(value);
+  const auto array = dynamic_cast<const XmpArrayValue*>(value);
+  const auto langAlt = dynamic_cast<const LangAltValue*>(value);
+  if (!text && !array && !langAlt) {
+    w.u8(otherValue);
+    writeValue(w, xmp);
+    return;
+  }
+  const auto xmpValue = static_cast<const XmpValue*>(value);
+  w.u8(text ? textValue : array ? arrayValue : langAltValue);
+  w.u32(value->typeId());
+  w.u8(static_cast<byte>(xmpValue->xmpArrayType()));
+  w.u8(static_cast<byte>(xmpValue->xmpStruct()));
+  if (text) {
+    w.string(text->value_);
+  } else if (array) {
+    w.u32(static_cast<uint32_t>(array->count()));
+    for (size_t i = 0; i < array->count(); ++i)
+      w.string(array->toString(i));
+  } else {
+    w.u32(static_cast<uint32_t>(langAlt->value_.size()));
+    for (auto&& [lang, s] : langAlt->value_) {
+      w.string(lang);
+      w.string(s);
+    }
+  }
+}
+
+Value::UniquePtr readXmpValue(Reader& r) {
+  const auto kind = r.u8();
+  if (kind == otherValue)
+    return readValue(r);
+  enforce(kind <= langAltValue, ErrorCode::kerCorruptedMetadata);
+  const auto typeId = static_cast<TypeId>(r.u32());
+  const auto arrayType = static_cast<XmpValue::XmpArrayType>(r.u8());
+  const auto xmpStruct = static_cast<XmpValue::XmpStruct>(r.u8());
+  enforce(arrayType <= XmpValue::xaSeq && xmpStruct <= XmpValue::xsStruct, ErrorCode::kerCorruptedMetadata);
+
+  std::unique_ptr<XmpValue> value;
+  if (kind == textValue) {
+    auto text = std::make_unique<XmpTextValue>();
+    text->value_ = r.string();
+    value = std::move(text);
+  } else if (kind == arrayValue) {
+    auto array = std::make_unique<XmpArrayValue>(typeId);
+    for (size_t i = r.count(4); i > 0; --i)
+      array->read(std::string(r.string()));
+    value = std::move(array);
+  } else {
+    auto langAlt = std::make_unique<LangAltValue>();
+    for (size_t i = r.count(8); i > 0; --i) {
+      std::string lang(r.string());
+      langAlt->value_[lang] = r.string();
+    }
+    value = std::move(langAlt);
+  }
+  value->setXmpArrayType(arrayType);
+  value->setXmpStruct(xmpStruct);
+  return value;
+}
+
+//! Return true if \em prefix is the prefix of a built-in or registered XMP namespace
+bool isPrefixInUse(const std::string& prefix) {
+  try {
+    XmpProperties::ns(prefix);
+    return true;
+  } catch (const Error&) {
+    return false;
+  }
+}
+}  // namespace
+
+namespace Exiv2 {
+void SnapshotParser::encode(Blob& blob, const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData,
+                            const DataBuf& iccProfile, const std::string& comment) {
+  Blob body;
+  Writer w(body);
+
+  // namespaces of the XMP properties, which may have been registered by the application
+  std::set<std::string> prefixes;
+  for (auto&& xmp : xmpData)
+    prefixes.insert(xmp.groupName());
+  w.u32(static_cast<uint32_t>(prefixes.size()));
+  for (auto&& prefix : prefixes) {
+    w.string(prefix);
+    w.string(XmpProperties::ns(prefix));
+  }
+
+  w.u32(static_cast<uint32_t>(exifData.count()));
+  for (auto&& exif : exifData) {
+    bool numeric = false;
+    try {
+      numeric = ExifKey(exif.tag(), exif.groupName()).key() == exif.key();
+    } catch (const Error&) {
+    }
+    if (numeric) {
+      w.u8(numericKey);
+      w.u16(exif.tag());
+      w.u16(static_cast<uint16_t>(exif.ifdId()));
+    } else {
+      w.u8(stringKey);
+      w.string(exif.key());
+    }
+    w.u32(static_cast<uint32_t>(exif.idx()));
+    writeValue(w, exif);
+  }
+
+  w.u32(static_cast<uint32_t>(iptcData.count()));
+  for (auto&& iptc : iptcData) {
+    w.u16(iptc.record());
+    w.u16(iptc.tag());
+    writeValue(w, iptc);
+  }
+
+  w.u32(static_cast<uint32_t>(xmpData.count()));
+  for (auto&& xmp : xmpData) {
+    w.string(xmp.key());
+    writeXmpValue(w, xmp);
+  }
+
+  w.bytes(iccProfile.c_data(), iccProfile.size());
+  w.bytes(comment);
+
+  // the string table is complete now and goes before the body
+  blob.clear();
+  Writer header(blob);
+  blob.insert(blob.end(), std::begin(magic), std::end(magic));
+  header.u16(version_);
+  header.u16(0);  // reserved
+  const auto strings = w.strings();
+  header.u32(static_cast<uint32_t>(strings.size()));
+  for (auto&& s : strings)
+    header.bytes(*s);
+  blob.insert(blob.end(), body.begin(), body.end());
+}
+
+void SnapshotParser::encode(Blob& blob, const Image& image) {
+  encode(blob, image.exifData(), image.iptcData(), image.xmpData(), image.iccProfile(), image.comment());
+}
+
+void SnapshotParser::decode(ExifData& exifData, IptcData& iptcData, XmpData& xmpData, DataBuf& iccProfile,
+                            std::string& comment, const byte* pData, size_t size) {
+  Reader r(pData, size);
+  enforce(size >= sizeof(magic) && std::memcmp(r.take(sizeof(magic)), magic, sizeof(magic)) == 0,
+          ErrorCode::kerCorruptedMetadata);
+  enforce(r.u16() == version_, ErrorCode::kerCorruptedMetadata);
+  r.u16();  // reserved
+  r.readStrings();
+
+  // namespaces which are not registered yet, registered once the whole snapshot is read
+  std::vector<std::pair<std::string, std::string>> namespaces;
+  for (size_t i = r.count(8); i > 0; --i) {
+    std::string prefix(r.string());
+    std::string ns(r.string());
+    enforce(!prefix.empty() && !ns.empty(), ErrorCode::kerCorruptedMetadata);
+    if (XmpProperties::prefix(ns).empty()) {
+      // don't take a prefix away from another namespace
+      enforce(!isPrefixInUse(prefix), ErrorCode::kerCorruptedMetadata);
+      namespaces.emplace_back(std::move(ns), std::move(prefix));
+    }
+  }
+
+  thread_local KeyCache<uint64_t, ExifKey> exifKeys;
+  thread_local KeyCache<uint32_t, IptcKey> iptcKeys;
+  thread_local KeyCache<std::string, XmpKey> xmpKeys;
+
+  ExifData exif;
+  for (size_t i = r.count(13); i > 0; --i) {
+    const byte kind = r.u8();
+    enforce(kind == numericKey || kind == stringKey, ErrorCode::kerCorruptedMetadata);
+    if (kind == numericKey) {
+      const uint16_t tag = r.u16();
+      const uint16_t ifdId = r.u16();
+      const uint32_t idx = r.u32();
+      exif.add(Exifdatum(exifKeys.get(static_cast<uint64_t>(tag) << 48 | static_cast<uint64_t>(ifdId) << 32 | idx,
+                                       [=] {
+                                         auto key = std::make_shared<ExifKey>(
+                                             tag, Internal::groupName(static_cast<Internal::IfdId>(ifdId)));
+                                         key->setIdx(static_cast<int>(idx));
+                                         return key;
+                                       }),
+                         readValue(r)));
+    } else {
+      auto key = std::make_shared<ExifKey>(std::string(r.string()));
+      key->setIdx(static_cast<int>(r.u32()));
+      exif.add(Exifdatum(std::move(key), readValue(r)));
+    }
+  }
+
+  IptcData iptc;
+  for (size_t i = r.count(8); i > 0; --i) {
+    const uint16_t record = r.u16();
+    const uint16_t dataset = r.u16();
+    iptc.add(Iptcdatum(iptcKeys.get(static_cast<uint32_t>(record) << 16 | dataset,
+                                    [=] { return std::make_shared<IptcKey>(dataset, record); }),
+                       readValue(r)));
+  }
+
+  // XMP keys need the namespaces of their prefixes
+  std::vector<std::pair<std::string_view, Value::UniquePtr>> xmpValues(r.count(5));
+  for (auto&& [name, value] : xmpValues) {
+    name = r.string();
+    value = readXmpValue(r);
+  }
+
+  const std::string_view icc = r.bytes();
+  const std::string_view text = r.bytes();
+  enforce(r.atEnd(), ErrorCode::kerCorruptedMetadata);
+
+  for (auto&& [ns, prefix] : namespaces)
+    XmpProperties::registerNs(ns, prefix);
+  XmpData xmp;
+  try {
+    for (auto&& [name, value] : xmpValues) {
+      xmp.add(Xmpdatum(xmpKeys.get(name, [name = name] { return std::make_shared<XmpKey>(std::string(name)); }),
+                       std::move(value)));
+    }
+  } catch (const Error&) {
+    for (auto&& ns : namespaces)
+      XmpProperties::unregisterNs(ns.first);
+    throw;
+  }
+
+  exifData = std::move(exif);
+  iptcData = std::move(iptc);
+  xmpData = std::move(xmp);
+  iccProfile = DataBuf(reinterpret_cast<const byte*>(icc.data()), icc.size());
+  comment = text;
+}
+
+void SnapshotParser::decode(Image& image, const byte* pData, size_t size) {
+  ExifData exifData;
+  IptcData iptcData;
+  XmpData xmpData;
+  DataBuf iccProfile;
+  std::string comment;
+  decode(exifData, iptcData, xmpData, iccProfile, comment, pData, size);
+
+  if (image.checkMode(mdExif) & amWrite)
+    image.setExifData(std::move(exifData));
+  if (image.checkMode(mdIptc) & amWrite)
+    image.setIptcData(std::move(iptcData));
+  if (image.checkMode(mdIccProfile) & amWrite) {
+    if (iccProfile.empty())
+      image.clearIccProfile();
+    else
+      image.setIccProfile(std::move(iccProfile), false);
+  }
+  if (image.checkMode(mdXmp) & amWrite)
+    image.setXmpData(std::move(xmpData));
+  if (image.checkMode(mdComment) & amWrite)
+    image.setComment(comment);
+}
+}  // namespace Exiv2
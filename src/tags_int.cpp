@@ -2411,6 +2411,16 @@ const char* groupName(IfdId ifdId) {
   return ii->groupName_;
 }
 
+std::string_view vocabularyKey(const Value& value, std::string& buf) {
+  // XmpTextValue::write() only adds to the text if there is an array type or struct
+  const auto v = dynamic_cast<const XmpTextValue*>(&value);
+  if (v && v->xmpArrayType() == XmpValue::xaNone && v->xmpStruct() == XmpValue::xsNone) {
+    return v->value_;
+  }
+  buf = value.toString();
+  return buf;
+}
+
 std::ostream& printValue(std::ostream& os, const Value& value, const ExifData*) {
   return os << value;
 }
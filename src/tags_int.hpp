@@ -7,6 +7,10 @@
 // included header files
 #include "tags.hpp"
 
+#include <algorithm>
+#include <array>
+#include <string_view>
+
 // *****************************************************************************
 // namespace extensions
 
@@ -236,13 +240,166 @@ struct TagVocabulary {
   bool operator==(const std::string& key) const;
 };  // struct TagDetails
 
+//! Tables up to this size are searched linearly, larger ones through a sorted index
+constexpr int tagLookupLinearMax = 16;
+
+/*!
+  @brief Index of a TagDetails table, sorted by tag value at compile time.
+
+  Entries with the same value keep their order in the table, so that a
+  binary search finds the same entry as the linear find().
+ */
+template <int N>
+struct TagDetailsIndex {
+  std::array<int64_t, N> val_{};   //!< Tag values in ascending order
+  std::array<uint16_t, N> pos_{};  //!< Position of each value in the table
+};
+
+/*!
+  @brief Sort \em keys in ascending order and move the table positions in
+         \em pos along. A bottom-up merge sort, stable and O(N log N), so
+         that the largest tables stay well within the constexpr evaluation
+         limits of the compilers.
+ */
+template <typename Key, size_t N>
+constexpr void sortTableIndex(std::array<Key, N>& keys, std::array<uint16_t, N>& pos) {
+  std::array<Key, N> keysTmp{};
+  std::array<uint16_t, N> posTmp{};
+  for (size_t width = 1; width < N; width *= 2) {
+    for (size_t lo = 0; lo < N; lo += 2 * width) {
+      const size_t mid = std::min(lo + width, N);
+      const size_t hi = std::min(lo + 2 * width, N);
+      size_t i = lo;
+      size_t j = mid;
+      for (size_t k = lo; k < hi; ++k) {
+        // Take from the left run unless the right one is strictly smaller
+        const bool left = j == hi || (i < mid && !(keys[j] < keys[i]));
+        const size_t from = left ? i++ : j++;
+        keysTmp[k] = keys[from];
+        posTmp[k] = pos[from];
+      }
+    }
+    keys = keysTmp;
+    pos = posTmp;
+  }
+}
+
+//! Build the sorted index for a TagDetails table
+template <int N>
+constexpr TagDetailsIndex<N> makeTagDetailsIndex(const TagDetails (&array)[N]) {
+  static_assert(N <= 0xffff, "TagDetails table is too large for the index");
+  TagDetailsIndex<N> index{};
+  for (int i = 0; i < N; ++i) {
+    index.val_[i] = array[i].val_;
+    index.pos_[i] = static_cast<uint16_t>(i);
+  }
+  sortTableIndex(index.val_, index.pos_);
+  return index;
+}
+
+/*!
+  @brief Return the first entry with tag value \em value in a TagDetails
+         table, or nullptr. Same result as find(), but uses a binary search
+         for larger tables.
+ */
+template <int N, const TagDetails (&array)[N]>
+const TagDetails* findTagDetails(int64_t value) {
+  if constexpr (N <= tagLookupLinearMax) {
+    return find(array, value);
+  } else {
+    static constexpr auto index = makeTagDetailsIndex(array);
+    auto it = std::lower_bound(index.val_.begin(), index.val_.end(), value);
+    if (it == index.val_.end() || *it != value)
+      return nullptr;
+    return &array[index.pos_[it - index.val_.begin()]];
+  }
+}
+
+//! Shortcut for the findTagDetails template which requires typing the array name only once.
+#define EXV_FIND_TAG_DETAILS(array) findTagDetails<std::size(array), array>
+
+/*!
+  @brief Index of a TagVocabulary table, sorted by vocabulary string at
+         compile time. Entries with the same string keep their order in the
+         table. The index also lists the distinct lengths of the vocabulary
+         strings, as lookups match a vocabulary string against the end of
+         the key.
+ */
+template <int N>
+struct TagVocabularyIndex {
+  std::array<std::string_view, N> voc_{};  //!< Vocabulary strings in ascending order
+  std::array<uint16_t, N> pos_{};          //!< Position of each string in the table
+  std::array<size_t, N> lengths_{};        //!< Distinct lengths of the vocabulary strings
+  int numLengths_{0};                      //!< Number of valid entries in lengths_
+};
+
+//! Build the sorted index for a TagVocabulary table
+template <int N>
+constexpr TagVocabularyIndex<N> makeTagVocabularyIndex(const TagVocabulary (&array)[N]) {
+  static_assert(N <= 0xffff, "TagVocabulary table is too large for the index");
+  TagVocabularyIndex<N> index{};
+  for (int i = 0; i < N; ++i) {
+    const std::string_view voc(array[i].voc_);
+    index.voc_[i] = voc;
+    index.pos_[i] = static_cast<uint16_t>(i);
+
+    bool known = false;
+    for (int k = 0; k < index.numLengths_; ++k)
+      known = known || index.lengths_[k] == voc.size();
+    if (!known)
+      index.lengths_[index.numLengths_++] = voc.size();
+  }
+  sortTableIndex(index.voc_, index.pos_);
+  return index;
+}
+
+/*!
+  @brief Return the first entry of a TagVocabulary table whose vocabulary
+         string matches the end of \em key, or nullptr. Same result as
+         find() with TagVocabulary::operator==, but uses a binary search
+         for larger tables.
+ */
+template <int N, const TagVocabulary (&array)[N]>
+const TagVocabulary* findTagVocabulary(std::string_view key) {
+  if constexpr (N <= tagLookupLinearMax) {
+    for (auto&& td : array) {
+      const std::string_view voc(td.voc_);
+      if (voc.size() <= key.size() && key.substr(key.size() - voc.size()) == voc)
+        return &td;
+    }
+    return nullptr;
+  } else {
+    static constexpr auto index = makeTagVocabularyIndex(array);
+    // Try each suffix of the key which has the length of a vocabulary string and
+    // return the match which comes first in the table
+    int best = N;
+    for (int k = 0; k < index.numLengths_; ++k) {
+      const size_t len = index.lengths_[k];
+      if (len > key.size())
+        continue;
+      const auto suffix = key.substr(key.size() - len);
+      auto it = std::lower_bound(index.voc_.begin(), index.voc_.end(), suffix);
+      if (it != index.voc_.end() && *it == suffix)
+        best = std::min(best, static_cast<int>(index.pos_[it - index.voc_.begin()]));
+    }
+    return best == N ? nullptr : &array[best];
+  }
+}
+
+/*!
+  @brief Return the string value of \em value, for use as the key of a
+         vocabulary lookup. Avoids a copy for plain XMP text values, else
+         the string is stored in \em buf.
+ */
+std::string_view vocabularyKey(const Value& value, std::string& buf);
+
 /*!
   @brief Generic pretty-print function to translate a long value to a description
          by looking up a reference table.
  */
 template <int N, const TagDetails (&array)[N]>
 std::ostream& printTag(std::ostream& os, const int64_t value, const ExifData*) {
-  const TagDetails* td = find(array, value);
+  const TagDetails* td = findTagDetails<N, array>(value);
   if (td) {
     os << exvGettext(td->label_);
   } else {
@@ -301,7 +458,8 @@ std::ostream& printTagBitmask(std::ostream& os, const Value& value, const ExifDa
  */
 template <int N, const TagVocabulary (&array)[N]>
 std::ostream& printTagVocabulary(std::ostream& os, const Value& value, const ExifData*) {
-  const TagVocabulary* td = find(array, value.toString());
+  std::string buf;
+  const TagVocabulary* td = findTagVocabulary<N, array>(vocabularyKey(value, buf));
   if (td) {
     os << exvGettext(td->label_);
   } else {
@@ -323,7 +481,7 @@ std::ostream& printTagVocabularyMulti(std::ostream& os, const Value& value, cons
   for (size_t i = 0; i < value.count(); i++) {
     if (i != 0)
       os << ", ";
-    const TagVocabulary* td = find(array, value.toString(i));
+    const TagVocabulary* td = findTagVocabulary<N, array>(value.toString(i));
     if (td) {
       os << exvGettext(td->label_);
     } else {
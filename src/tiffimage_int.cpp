@@ -3,6 +3,7 @@
 #include "tiffimage_int.hpp"
 #include "error.hpp"
 #include "i18n.h"  // NLS support.
+#include "image_int.hpp"
 #include "makernote_int.hpp"
 #include "sonymn_int.hpp"
 #include "tags_int.hpp"
@@ -1915,7 +1916,9 @@ TiffComponent::UniquePtr TiffParserWorker::parse(const byte* pData, size_t size,
   if (!pData || size == 0)
     return nullptr;
   if (!pHeader->read(pData, size) || pHeader->offset() >= size) {
-    throw Error(ErrorCode::kerNotAnImage, "TIFF");
+    if (!collectError(ErrorCode::kerNotAnImage, 0, "Invalid TIFF header"))
+      throw Error(ErrorCode::kerNotAnImage, "TIFF");
+    return nullptr;
   }
   auto rootDir = TiffCreator::create(root, ifdIdNotSet);
   if (rootDir) {
@@ -5,6 +5,7 @@
 
 #include "enforce.hpp"
 #include "exif.hpp"
+#include "image_int.hpp"
 #include "iptc.hpp"
 #include "jpgimage.hpp"
 #include "makernote_int.hpp"
@@ -374,7 +375,7 @@ void TiffDecoder::decodeCanonAFInfo(const TiffEntryBase* object) {
   int nStart = 0;
 
   using record = std::tuple<uint16_t, uint16_t, bool>;
-  static const auto records = std::array{
+  const auto records = std::array{
       record(0x2600, 1, true),        // AFInfoSize
       record(0x2601, 1, true),        // AFAreaMode
       record(0x2602, 1, true),        // AFNumPoints
@@ -1029,6 +1030,11 @@ uint32_t TiffReader::baseOffset() const {
   return pState_->baseOffset();
 }
 
+bool TiffReader::corrupt(const byte* p, IfdId group, uint16_t tag, const char* what, ErrorCode code) const {
+  return collectError(code, p >= pData_ && p <= pLast_ ? p - pData_ : ErrorCollector::noOffset, what, groupName(group),
+                      tag);
+}
+
 void TiffReader::readDataEntryBase(TiffDataEntryBase* object) {
   readTiffEntry(object);
   TiffFinder finder(object->szTag(), object->szGroup());
@@ -1065,9 +1071,11 @@ bool TiffReader::circularReference(const byte* start, IfdId group) {
   auto pos = dirList_.find(start);
   if (pos != dirList_.end()) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << groupName(group) << " pointer references previously read " << groupName(pos->second)
-              << " directory; ignored.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << groupName(group) << " pointer references previously read " << groupName(pos->second)
+                << " directory; ignored.\n";
 #endif
+    corrupt(start, group, 0, "pointer references a previously read directory");
     return true;
   }
   dirList_[start] = group;
@@ -1096,8 +1104,11 @@ void TiffReader::visitDirectory(TiffDirectory* object) {
 
   if (p + 2 > pLast_) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << "Directory " << groupName(object->group()) << ": IFD exceeds data buffer, cannot read entry count.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << "Directory " << groupName(object->group())
+                << ": IFD exceeds data buffer, cannot read entry count.\n";
 #endif
+    corrupt(p, object->group(), 0, "directory exceeds the data buffer");
     return;
   }
   const uint16_t n = getUShort(p, byteOrder());
@@ -1105,17 +1116,21 @@ void TiffReader::visitDirectory(TiffDirectory* object) {
   // Sanity check with an "unreasonably" large number
   if (n > 256) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << "Directory " << groupName(object->group()) << " with " << n
-              << " entries considered invalid; not read.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << "Directory " << groupName(object->group()) << " with " << n
+                << " entries considered invalid; not read.\n";
 #endif
+    corrupt(object->start(), object->group(), 0, "directory has too many entries");
     return;
   }
   for (uint16_t i = 0; i < n; ++i) {
     if (p + 12 > pLast_) {
 #ifndef SUPPRESS_WARNINGS
-      EXV_ERROR << "Directory " << groupName(object->group()) << ": IFD entry " << i
-                << " lies outside of the data buffer.\n";
+      if (!Diagnostics::current())
+        EXV_ERROR << "Directory " << groupName(object->group()) << ": IFD entry " << i
+                  << " lies outside of the data buffer.\n";
 #endif
+      corrupt(p, object->group(), 0, "directory is truncated");
       return;
     }
     uint16_t tag = getUShort(p, byteOrder());
@@ -1134,9 +1149,11 @@ void TiffReader::visitDirectory(TiffDirectory* object) {
   if (object->hasNext()) {
     if (p + 4 > pLast_) {
 #ifndef SUPPRESS_WARNINGS
-      EXV_ERROR << "Directory " << groupName(object->group())
-                << ": IFD exceeds data buffer, cannot read next pointer.\n";
+      if (!Diagnostics::current())
+        EXV_ERROR << "Directory " << groupName(object->group())
+                  << ": IFD exceeds data buffer, cannot read next pointer.\n";
 #endif
+      corrupt(p, object->group(), 0, "directory has no next pointer");
       return;
     }
     TiffComponent::UniquePtr tc;
@@ -1152,8 +1169,10 @@ void TiffReader::visitDirectory(TiffDirectory* object) {
     if (tc) {
       if (baseOffset() + next > size_) {
 #ifndef SUPPRESS_WARNINGS
-        EXV_ERROR << "Directory " << groupName(object->group()) << ": Next pointer is out of bounds; ignored.\n";
+        if (!Diagnostics::current())
+          EXV_ERROR << "Directory " << groupName(object->group()) << ": Next pointer is out of bounds; ignored.\n";
 #endif
+        corrupt(p, object->group(), 0, "next pointer is out of bounds");
         return;
       }
       tc->setStart(pData_ + baseOffset() + next);
@@ -1175,9 +1194,11 @@ void TiffReader::visitSubIfd(TiffSubIfd* object) {
       uint32_t offset = getLong(object->pData() + 4 * i, byteOrder());
       if (baseOffset() + offset > size_) {
 #ifndef SUPPRESS_WARNINGS
-        EXV_ERROR << "Directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
-                  << std::hex << object->tag() << " Sub-IFD pointer " << i << " is out of bounds; ignoring it.\n";
+        if (!Diagnostics::current())
+          EXV_ERROR << "Directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
+                    << std::hex << object->tag() << " Sub-IFD pointer " << i << " is out of bounds; ignoring it.\n";
 #endif
+        corrupt(object->start(), object->group(), object->tag(), "sub-IFD pointer is out of bounds");
         return;
       }
       if (i >= maxi) {
@@ -1225,13 +1246,15 @@ void TiffReader::visitIfdMakernote(TiffIfdMakernote* object) {
 
   if (!object->readHeader(object->start(), pLast_ - object->start(), byteOrder())) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << "Failed to read " << groupName(object->ifd_.group()) << " IFD Makernote header.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << "Failed to read " << groupName(object->ifd_.group()) << " IFD Makernote header.\n";
 #ifdef EXIV2_DEBUG_MESSAGES
     if (pLast_ - object->start() >= 16u) {
       hexdump(std::cerr, object->start(), 16u);
     }
 #endif  // EXIV2_DEBUG_MESSAGES
 #endif  // SUPPRESS_WARNINGS
+    corrupt(object->start(), object->ifd_.group(), 0, "failed to read the makernote header");
     setGo(geKnownMakernote, false);
     return;
   }
@@ -1255,10 +1278,12 @@ void TiffReader::readTiffEntry(TiffEntryBase* object) {
 
   if (p + 12 > pLast_) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << "Entry in directory " << groupName(object->group())
-              << "requests access to memory beyond the data buffer. "
-              << "Skipping entry.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << "Entry in directory " << groupName(object->group())
+                << "requests access to memory beyond the data buffer. "
+                << "Skipping entry.\n";
 #endif
+    corrupt(p, object->group(), object->tag(), "entry is truncated");
     return;
   }
   // Component already has tag
@@ -1278,16 +1303,21 @@ void TiffReader::readTiffEntry(TiffEntryBase* object) {
   uint32_t count = getULong(p, byteOrder());
   if (count >= 0x10000000) {
 #ifndef SUPPRESS_WARNINGS
-    EXV_ERROR << "Directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
-              << std::hex << object->tag() << " has invalid size " << std::dec << count << "*" << typeSize
-              << "; skipping entry.\n";
+    if (!Diagnostics::current())
+      EXV_ERROR << "Directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
+                << std::hex << object->tag() << " has invalid size " << std::dec << count << "*" << typeSize
+                << "; skipping entry.\n";
 #endif
+    corrupt(object->start(), object->group(), object->tag(), "entry has an invalid count");
     return;
   }
   p += 4;
 
   if (count > std::numeric_limits<uint32_t>::max() / typeSize) {
-    throw Error(ErrorCode::kerArithmeticOverflow);
+    if (!corrupt(object->start(), object->group(), object->tag(), "size of the entry overflows",
+                 ErrorCode::kerArithmeticOverflow))
+      throw Error(ErrorCode::kerArithmeticOverflow);
+    return;
   }
   size_t size = typeSize * count;
   uint32_t offset = getLong(p, byteOrder());
@@ -1310,11 +1340,13 @@ void TiffReader::readTiffEntry(TiffEntryBase* object) {
       size = 0;
     } else {
 #ifndef SUPPRESS_WARNINGS
-      EXV_ERROR << "Offset of directory " << groupName(object->group()) << ", entry 0x" << std::setw(4)
-                << std::setfill('0') << std::hex << object->tag() << " is out of bounds: "
-                << "Offset = 0x" << std::setw(8) << std::setfill('0') << std::hex << offset
-                << "; truncating the entry\n";
+      if (!Diagnostics::current())
+        EXV_ERROR << "Offset of directory " << groupName(object->group()) << ", entry 0x" << std::setw(4)
+                  << std::setfill('0') << std::hex << object->tag() << " is out of bounds: "
+                  << "Offset = 0x" << std::setw(8) << std::setfill('0') << std::hex << offset
+                  << "; truncating the entry\n";
 #endif
+      corrupt(object->start(), object->group(), object->tag(), "offset of the entry is out of bounds");
     }
     size = 0;
   }
@@ -1325,25 +1357,31 @@ void TiffReader::readTiffEntry(TiffEntryBase* object) {
          std::numeric_limits<uintptr_t>::max() - static_cast<uintptr_t>(offset)) ||
         (static_cast<uintptr_t>(baseOffset() + offset) >
          std::numeric_limits<uintptr_t>::max() - reinterpret_cast<uintptr_t>(pData_))) {
-      throw Error(ErrorCode::kerCorruptedMetadata);  // #562 don't throw kerArithmeticOverflow
+      if (!corrupt(object->start(), object->group(), object->tag(), "offset of the entry overflows"))
+        throw Error(ErrorCode::kerCorruptedMetadata);  // #562 don't throw kerArithmeticOverflow
+      return;
     }
     if (pData_ + static_cast<uintptr_t>(baseOffset()) + static_cast<uintptr_t>(offset) > pLast_) {
-      throw Error(ErrorCode::kerCorruptedMetadata);
+      if (!corrupt(object->start(), object->group(), object->tag(), "offset of the entry is out of bounds"))
+        throw Error(ErrorCode::kerCorruptedMetadata);
+      return;
     }
     pData = const_cast<byte*>(pData_) + baseOffset() + offset;
 
     // check for size being invalid
     if (size > static_cast<size_t>(pLast_ - pData)) {
 #ifndef SUPPRESS_WARNINGS
-      EXV_ERROR << "Upper boundary of data for "
-                << "directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
-                << std::hex << object->tag() << " is out of bounds: "
-                << "Offset = 0x" << std::setw(8) << std::setfill('0') << std::hex << offset << ", size = " << std::dec
-                << size
-                << ", exceeds buffer size by "
-                // cast to make MSVC happy
-                << static_cast<uint32_t>(pData + size - pLast_) << " Bytes; truncating the entry\n";
+      if (!Diagnostics::current())
+        EXV_ERROR << "Upper boundary of data for "
+                  << "directory " << groupName(object->group()) << ", entry 0x" << std::setw(4) << std::setfill('0')
+                  << std::hex << object->tag() << " is out of bounds: "
+                  << "Offset = 0x" << std::setw(8) << std::setfill('0') << std::hex << offset
+                  << ", size = " << std::dec << size
+                  << ", exceeds buffer size by "
+                  // cast to make MSVC happy
+                  << static_cast<uint32_t>(pData + size - pLast_) << " Bytes; truncating the entry\n";
 #endif
+      corrupt(object->start(), object->group(), object->tag(), "data of the entry is out of bounds");
       size = 0;
     }
   }
@@ -651,6 +651,14 @@ class TiffReader : public TiffVisitor {
   [[nodiscard]] ByteOrder byteOrder() const;
   //! Return the base offset. See class TiffRwState for details
   [[nodiscard]] uint32_t baseOffset() const;
+  /*!
+    @brief Report corrupt data at \em p, in directory \em group or its entry \em tag,
+           with collectError().
+    @return true if the error was recorded and the corrupt data is to be skipped
+            instead of throwing
+   */
+  bool corrupt(const byte* p, IfdId group, uint16_t tag, const char* what,
+               ErrorCode code = ErrorCode::kerCorruptedMetadata) const;
   //@}
 
  private:
@@ -9,13 +9,141 @@
 #include "types.hpp"
 
 // + standard includes
-#include <regex>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iomanip>
 #include <sstream>
+#include <string_view>
+
+// *****************************************************************************
+// local definitions
+namespace {
+/*!
+  @brief Output buffer for the Value::format() implementations. Appends as
+         much as fits into the caller's buffer and keeps count of the
+         complete length, like snprintf().
+ */
+class FormatBuffer {
+ public:
+  FormatBuffer(char* buf, size_t n) : buf_(buf), n_(n) {
+  }
+
+  void append(std::string_view s) {
+    if (len_ + 1 < n_)
+      std::memcpy(buf_ + len_, s.data(), std::min(s.size(), n_ - 1 - len_));
+    len_ += s.size();
+  }
+
+  void append(char c) {
+    if (len_ + 1 < n_)
+      buf_[len_] = c;
+    ++len_;
+  }
+
+  template <typename I>
+  void appendInt(I value) {
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    append(std::string_view(tmp, end - tmp));
+  }
+
+  //! Append an integer right aligned in a field of \em width characters, filled with '0' (std::setfill('0'))
+  void appendPadded(int value, int width) {
+    char tmp[24];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), value);
+    for (auto len = end - tmp; len < width; ++len)
+      append('0');
+    append(std::string_view(tmp, end - tmp));
+  }
+
+  //! Append a floating point number as an output stream with std::setprecision(15) does
+  void appendFloat(double value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    char tmp[32];
+    auto [end, ec] = std::to_chars(tmp, tmp + sizeof(tmp), value, std::chars_format::general, 15);
+    append(std::string_view(tmp, end - tmp));
+#else
+    std::ostringstream os;
+    os << std::setprecision(15) << value;
+    append(os.str());
+#endif
+  }
+
+  void appendValue(uint16_t value) {
+    appendInt(value);
+  }
+  void appendValue(uint32_t value) {
+    appendInt(value);
+  }
+  void appendValue(int16_t value) {
+    appendInt(value);
+  }
+  void appendValue(int32_t value) {
+    appendInt(value);
+  }
+  void appendValue(const Exiv2::URational& value) {
+    appendInt(value.first);
+    append('/');
+    appendInt(value.second);
+  }
+  void appendValue(const Exiv2::Rational& value) {
+    appendInt(value.first);
+    append('/');
+    appendInt(value.second);
+  }
+  void appendValue(float value) {
+    appendFloat(value);
+  }
+  void appendValue(double value) {
+    appendFloat(value);
+  }
+
+  //! Terminate the output and return its complete length
+  size_t finish() {
+    if (n_ > 0)
+      buf_[std::min(len_, n_ - 1)] = '\0';
+    return len_;
+  }
+
+ private:
+  char* buf_;
+  size_t n_;
+  size_t len_{0};
+};
+
+//! Format a list of values separated by spaces, as ValueType<T>::write() does
+template <typename T>
+size_t formatValueList(char* buf, size_t n, const std::vector<T>& values) {
+  FormatBuffer fb(buf, n);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0)
+      fb.append(' ');
+    fb.appendValue(values[i]);
+  }
+  return fb.finish();
+}
+
+size_t formatString(char* buf, size_t n, std::string_view s) {
+  FormatBuffer fb(buf, n);
+  fb.append(s);
+  return fb.finish();
+}
+}  // namespace
 
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
-Value::Value(TypeId typeId) : ok_(true), type_(typeId) {
+Value::Value(TypeId typeId) : type_(typeId) {
+}
+
+Value::Value(const Value& rhs) : ok_(rhs.ok_.load()), type_(rhs.type_) {
+}
+
+Value& Value::operator=(const Value& rhs) {
+  ok_ = rhs.ok_.load();
+  type_ = rhs.type_;
+  return *this;
 }
 
 Value::UniquePtr Value::create(TypeId typeId) {
@@ -92,10 +220,30 @@ int Value::setDataArea(const byte* /*buf*/, size_t /*len*/) {
 }
 
 std::string Value::toString() const {
+  std::string s;
+  appendTo(s);
+  return s;
+}
+
+size_t Value::format(char* buf, size_t n) const {
   std::ostringstream os;
   write(os);
   ok_ = !os.fail();
-  return os.str();
+  return formatString(buf, n, os.str());
+}
+
+void Value::appendTo(std::string& out) const {
+  // Most values are short, try a stack buffer first
+  char buf[128];
+  const size_t len = format(buf, sizeof(buf));
+  if (len < sizeof(buf)) {
+    out.append(buf, len);
+    return;
+  }
+  const size_t pos = out.size();
+  out.resize(pos + len + 1);
+  format(out.data() + pos, len + 1);
+  out.resize(pos + len);
 }
 
 std::string Value::toString(size_t /*n*/) const {
@@ -164,6 +312,17 @@ std::ostream& DataValue::write(std::ostream& os) const {
   return os;
 }
 
+size_t DataValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  for (size_t i = 0; i < value_.size(); ++i) {
+    if (i > 0)
+      fb.append(' ');
+    fb.appendInt(static_cast<int>(value_[i]));
+  }
+  return fb.finish();
+}
+
 std::string DataValue::toString(size_t n) const {
   std::ostringstream os;
   os << static_cast<int>(value_.at(n));
@@ -237,6 +396,11 @@ std::ostream& StringValueBase::write(std::ostream& os) const {
   return os << value_;
 }
 
+size_t StringValueBase::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatString(buf, n, value_);
+}
+
 int64_t StringValueBase::toInt64(size_t n) const {
   ok_ = true;
   return value_.at(n);
@@ -294,6 +458,11 @@ std::ostream& AsciiValue::write(std::ostream& os) const {
   return os << value_.substr(0, pos);
 }
 
+size_t AsciiValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatString(buf, n, std::string_view(value_).substr(0, value_.find('\0')));
+}
+
 constexpr CommentValue::CharsetTable::CharsetTable(CharsetId charsetId, const char* name, const char* code) :
     charsetId_(charsetId), name_(name), code_(code) {
 }
@@ -397,6 +566,19 @@ std::ostream& CommentValue::write(std::ostream& os) const {
   return os << comment();
 }
 
+size_t CommentValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  CharsetId csId = charsetId();
+  if (csId != undefined) {
+    fb.append("charset=");
+    fb.append(CharsetInfo::name(csId));
+    fb.append(' ');
+  }
+  fb.append(comment());
+  return fb.finish();
+}
+
 std::string CommentValue::comment(const char* encoding) const {
   std::string c;
   if (value_.length() < 8) {
@@ -589,20 +771,39 @@ std::ostream& XmpTextValue::write(std::ostream& os) const {
   return os << value_;
 }
 
+size_t XmpTextValue::format(char* buf, size_t n) const {
+  if (xmpArrayType() != XmpValue::xaNone || xmpStruct() != XmpValue::xsNone)
+    return Value::format(buf, n);
+  ok_ = true;
+  return formatString(buf, n, value_);
+}
+
 int64_t XmpTextValue::toInt64(size_t /*n*/) const {
-  return parseInt64(value_, ok_);
+  bool ok = false;
+  auto result = parseInt64(value_, ok);
+  ok_ = ok;
+  return result;
 }
 
 uint32_t XmpTextValue::toUint32(size_t /*n*/) const {
-  return parseUint32(value_, ok_);
+  bool ok = false;
+  auto result = parseUint32(value_, ok);
+  ok_ = ok;
+  return result;
 }
 
 float XmpTextValue::toFloat(size_t /*n*/) const {
-  return parseFloat(value_, ok_);
+  bool ok = false;
+  auto result = parseFloat(value_, ok);
+  ok_ = ok;
+  return result;
 }
 
 Rational XmpTextValue::toRational(size_t /*n*/) const {
-  return parseRational(value_, ok_);
+  bool ok = false;
+  auto result = parseRational(value_, ok);
+  ok_ = ok;
+  return result;
 }
 
 XmpTextValue* XmpTextValue::clone_() const {
@@ -636,25 +837,48 @@ std::ostream& XmpArrayValue::write(std::ostream& os) const {
   return os;
 }
 
+size_t XmpArrayValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  for (auto i = value_.begin(); i != value_.end(); ++i) {
+    if (i != value_.begin())
+      fb.append(", ");
+    fb.append(*i);
+  }
+  return fb.finish();
+}
+
 std::string XmpArrayValue::toString(size_t n) const {
   ok_ = true;
   return value_.at(n);
 }
 
 int64_t XmpArrayValue::toInt64(size_t n) const {
-  return parseInt64(value_.at(n), ok_);
+  bool ok = false;
+  auto result = parseInt64(value_.at(n), ok);
+  ok_ = ok;
+  return result;
 }
 
 uint32_t XmpArrayValue::toUint32(size_t n) const {
-  return parseUint32(value_.at(n), ok_);
+  bool ok = false;
+  auto result = parseUint32(value_.at(n), ok);
+  ok_ = ok;
+  return result;
 }
 
 float XmpArrayValue::toFloat(size_t n) const {
-  return parseFloat(value_.at(n), ok_);
+  bool ok = false;
+  auto result = parseFloat(value_.at(n), ok);
+  ok_ = ok;
+  return result;
 }
 
 Rational XmpArrayValue::toRational(size_t n) const {
-  return parseRational(value_.at(n), ok_);
+  bool ok = false;
+  auto result = parseRational(value_.at(n), ok);
+  ok_ = ok;
+  return result;
 }
 
 XmpArrayValue* XmpArrayValue::clone_() const {
@@ -744,6 +968,36 @@ std::ostream& LangAltValue::write(std::ostream& os) const {
   return os;
 }
 
+size_t LangAltValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  bool first = true;
+
+  // Write the default entry first
+  auto i = value_.find(x_default);
+  if (i != value_.end()) {
+    fb.append("lang=\"");
+    fb.append(i->first);
+    fb.append("\" ");
+    fb.append(i->second);
+    first = false;
+  }
+
+  // Write the others
+  for (auto&& [lang, s] : value_) {
+    if (lang != x_default) {
+      if (!first)
+        fb.append(", ");
+      fb.append("lang=\"");
+      fb.append(lang);
+      fb.append("\" ");
+      fb.append(s);
+      first = false;
+    }
+  }
+  return fb.finish();
+}
+
 std::string LangAltValue::toString(size_t /*n*/) const {
   return toString(x_default);
 }
@@ -782,6 +1036,147 @@ LangAltValue* LangAltValue::clone_() const {
   return new LangAltValue(*this);
 }
 
+namespace {
+//! Returns true if \em c is a decimal digit
+constexpr bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+//! Read the \em n decimal digits at \em pos of \em str into \em value, returns false if there are fewer
+bool readDigits(std::string_view str, size_t pos, size_t n, int& value) {
+  if (pos + n > str.size())
+    return false;
+  int v = 0;
+  for (size_t i = pos; i < pos + n; ++i) {
+    if (!isDigit(str[i]))
+      return false;
+    v = v * 10 + (str[i] - '0');
+  }
+  value = v;
+  return true;
+}
+
+//! Read two digits in the range [0, \em max] at \em pos of \em str
+bool readDigits2(std::string_view str, size_t pos, int max, int& value) {
+  int v = 0;
+  if (!readDigits(str, pos, 2, v) || v > max)
+    return false;
+  value = v;
+  return true;
+}
+
+//! Returns true if \em str has the character \em c at \em pos
+bool hasChar(std::string_view str, size_t pos, char c) {
+  return pos < str.size() && str[pos] == c;
+}
+
+/*!
+  @brief Match the ISO 8601 date at the beginning of \em str: either
+         YYYY-MM-DD (extended format) or YYYYMMDD (basic format).
+ */
+bool matchIsoDate(std::string_view str, int& year, int& month, int& day) {
+  if (readDigits(str, 0, 4, year) && hasChar(str, 4, '-') && readDigits(str, 5, 2, month) && hasChar(str, 7, '-') &&
+      readDigits(str, 8, 2, day))
+    return true;
+  return readDigits(str, 0, 4, year) && readDigits(str, 4, 2, month) && readDigits(str, 6, 2, day);
+}
+
+/*!
+  @brief Match the complete string \em str against the ISO 8601 time
+         formats supported by TimeValue:
+         <tt>hh[:][mm][:][ss]</tt> and <tt>hh[:]mm[:]ss(Z|(+|-)hh[[:]mm])</tt>.
+
+  Optional parts are tried in the same order a backtracking regex engine
+  would try them, so that e.g. "12:30" yields minutes, not seconds.
+
+  @param tz Set to the time zone designator, empty if there is none.
+ */
+bool matchIsoTime(std::string_view str, Exiv2::TimeValue::Time& time, std::string_view& tz) {
+  int hour = 0;
+  if (!readDigits(str, 0, 2, hour) || hour > 23)
+    return false;
+  tz = std::string_view();
+
+  // Reduced formats without time zone designator, all parts after the hour are optional
+  for (bool colon1 : {true, false}) {
+    for (bool hasMinute : {true, false}) {
+      for (bool colon2 : {true, false}) {
+        for (bool hasSecond : {true, false}) {
+          size_t pos = 2;
+          int minute = 0;
+          int second = 0;
+          if (colon1) {
+            if (!hasChar(str, pos, ':'))
+              continue;
+            ++pos;
+          }
+          if (hasMinute) {
+            if (!readDigits2(str, pos, 59, minute))
+              continue;
+            pos += 2;
+          }
+          if (colon2) {
+            if (!hasChar(str, pos, ':'))
+              continue;
+            ++pos;
+          }
+          if (hasSecond) {
+            if (!readDigits2(str, pos, 59, second))
+              continue;
+            pos += 2;
+          }
+          if (pos != str.size())
+            continue;
+          time.hour = hour;
+          time.minute = minute;
+          time.second = second;
+          return true;
+        }
+      }
+    }
+  }
+
+  // Complete formats with time zone designator
+  size_t pos = 2;
+  int minute = 0;
+  int second = 0;
+  if (hasChar(str, pos, ':'))
+    ++pos;
+  if (!readDigits2(str, pos, 59, minute))
+    return false;
+  pos += 2;
+  if (hasChar(str, pos, ':'))
+    ++pos;
+  if (!readDigits2(str, pos, 59, second))
+    return false;
+  pos += 2;
+  const size_t tzPos = pos;
+  if (hasChar(str, pos, 'Z')) {
+    ++pos;
+  } else if (hasChar(str, pos, '+') || hasChar(str, pos, '-')) {
+    int tzHour = 0;
+    int tzMinute = 0;
+    if (!readDigits2(str, pos + 1, 23, tzHour))
+      return false;
+    pos += 3;
+    if (readDigits2(str, pos, 59, tzMinute)) {
+      pos += 2;
+    } else if (hasChar(str, pos, ':') && readDigits2(str, pos + 1, 59, tzMinute)) {
+      pos += 3;
+    }
+  } else {
+    return false;
+  }
+  if (pos != str.size())
+    return false;
+  time.hour = hour;
+  time.minute = minute;
+  time.second = second;
+  tz = str.substr(tzPos);
+  return true;
+}
+}  // namespace
+
 DateValue::DateValue() : Value(date) {
 }
 
@@ -799,27 +1194,26 @@ int DateValue::read(const byte* buf, size_t len, ByteOrder /*byteOrder*/) {
 int DateValue::read(const std::string& buf) {
   // ISO 8601 date formats:
   // https://web.archive.org/web/20171020084445/https://www.loc.gov/standards/datetime/ISO_DIS%208601-1.pdf
-  static const std::regex reExtended(R"(^(\d{4})-(\d{2})-(\d{2}))");
-  static const std::regex reBasic(R"(^(\d{4})(\d{2})(\d{2}))");
-  std::smatch sm;
-
   auto printWarning = [] {
 #ifndef SUPPRESS_WARNINGS
     EXV_WARNING << Error(ErrorCode::kerUnsupportedDateFormat) << "\n";
 #endif
   };
 
-  // Note: We use here regex_search instead of regex_match, because the string can be longer than expected and
+  // Note: Only the beginning of the string is matched, because the string can be longer than expected and
   // also contain the time
-  if (std::regex_search(buf, sm, reExtended) || std::regex_search(buf, sm, reBasic)) {
-    date_.year = std::stoi(sm[1].str());
-    date_.month = std::stoi(sm[2].str());
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (matchIsoDate(buf, year, month, day)) {
+    date_.year = year;
+    date_.month = month;
     if (date_.month > 12) {
       date_.month = 0;
       printWarning();
       return 1;
     }
-    date_.day = std::stoi(sm[3].str());
+    date_.day = day;
     if (date_.day > 31) {
       date_.day = 0;
       printWarning();
@@ -873,6 +1267,17 @@ std::ostream& DateValue::write(std::ostream& os) const {
   return os;
 }
 
+size_t DateValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  fb.appendPadded(date_.year, 4);
+  fb.append('-');
+  fb.appendPadded(date_.month, 2);
+  fb.append('-');
+  fb.appendPadded(date_.day, 2);
+  return fb.finish();
+}
+
 int64_t DateValue::toInt64(size_t /*n*/) const {
   // Range of tm struct is limited to about 1970 to 2038
   // This will return -1 if outside that range
@@ -922,31 +1327,19 @@ int TimeValue::read(const std::string& buf) {
   // https://web.archive.org/web/20171020084445/https://www.loc.gov/standards/datetime/ISO_DIS%208601-1.pdf
   // Not supported formats:
   // 4.2.2.4 Representations with decimal fraction: 232050,5
-  static const std::regex re(R"(^(2[0-3]|[01][0-9]):?([0-5][0-9])?:?([0-5][0-9])?$)");
-  static const std::regex reExt(
-      R"(^(2[0-3]|[01][0-9]):?([0-5][0-9]):?([0-5][0-9])(Z|[+-](?:2[0-3]|[01][0-9])(?::?(?:[0-5][0-9]))?)$)");
-
-  std::smatch sm;
-  if (std::regex_match(buf, sm, re) || std::regex_match(buf, sm, reExt)) {
-    time_.hour = sm.length(1) ? std::stoi(sm[1].str()) : 0;
-    time_.minute = sm.length(2) ? std::stoi(sm[2].str()) : 0;
-    time_.second = sm.length(3) ? std::stoi(sm[3].str()) : 0;
-    if (sm.size() > 4) {
-      std::string str = sm[4].str();
-      const auto strSize = str.size();
-      auto posColon = str.find(':');
-
-      if (posColon == std::string::npos) {
-        // Extended format
-        time_.tzHour = std::stoi(str.substr(0, 3));
-        if (strSize > 3) {
-          int minute = std::stoi(str.substr(3));
-          time_.tzMinute = time_.tzHour < 0 ? -minute : minute;
-        }
-      } else {
-        // Basic format
-        time_.tzHour = std::stoi(str.substr(0, posColon));
-        int minute = std::stoi(str.substr(posColon + 1));
+  std::string_view tz;
+  if (matchIsoTime(buf, time_, tz)) {
+    if (tz == "Z") {
+      time_.tzHour = 0;
+      time_.tzMinute = 0;
+    } else if (!tz.empty()) {
+      // The sign applies to both the hours and the minutes
+      int hour = 0;
+      readDigits(tz, 1, 2, hour);
+      time_.tzHour = tz[0] == '-' ? -hour : hour;
+      const size_t posMinute = hasChar(tz, 3, ':') ? 4 : 3;
+      int minute = 0;
+      if (readDigits(tz, posMinute, 2, minute)) {
         time_.tzMinute = time_.tzHour < 0 ? -minute : minute;
       }
     }
@@ -1011,6 +1404,21 @@ std::ostream& TimeValue::write(std::ostream& os) const {
   return os;
 }
 
+size_t TimeValue::format(char* buf, size_t n) const {
+  ok_ = true;
+  FormatBuffer fb(buf, n);
+  fb.appendPadded(time_.hour, 2);
+  fb.append(':');
+  fb.appendPadded(time_.minute, 2);
+  fb.append(':');
+  fb.appendPadded(time_.second, 2);
+  fb.append(time_.tzHour < 0 || time_.tzMinute < 0 ? '-' : '+');
+  fb.appendPadded(abs(time_.tzHour), 2);
+  fb.append(':');
+  fb.appendPadded(abs(time_.tzMinute), 2);
+  return fb.finish();
+}
+
 int64_t TimeValue::toInt64(size_t /*n*/) const {
   // Returns number of seconds in the day in UTC.
   int64_t result = (time_.hour - time_.tzHour) * 60 * 60;
@@ -1039,4 +1447,154 @@ Rational TimeValue::toRational(size_t n) const {
   return {static_cast<int32_t>(toInt64(n)), 1};
 }
 
+bool parseTimestamp(const std::string& str, Timestamp& ts) {
+  ts = Timestamp();
+  const std::string_view s(str);
+
+  // Date: YYYY[(-|:)MM[(-|:)DD]] or YYYYMMDD
+  int year = 0;
+  int month = 1;
+  int day = 1;
+  if (!readDigits(s, 0, 4, year))
+    return false;
+  size_t pos = 4;
+  if (hasChar(s, pos, '-') || hasChar(s, pos, ':')) {
+    const char sep = s[pos];
+    if (!readDigits(s, pos + 1, 2, month))
+      return false;
+    pos += 3;
+    if (hasChar(s, pos, sep)) {
+      if (!readDigits(s, pos + 1, 2, day))
+        return false;
+      pos += 3;
+    }
+  } else if (readDigits(s, pos, 2, month)) {
+    if (!readDigits(s, pos + 2, 2, day))
+      return false;
+    pos += 4;
+  }
+  if (month < 1 || month > 12 || day < 1 || day > 31)
+    return false;
+
+  // Optional time: (T| )hh[:]mm[[:]ss[(.|,)s+]] or (T| )hhmmss
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  if (pos < s.size()) {
+    if (s[pos] != 'T' && s[pos] != ' ')
+      return false;
+    ++pos;
+    if (!readDigits(s, pos, 2, hour))
+      return false;
+    pos += 2;
+    const bool extended = hasChar(s, pos, ':');
+    if (extended)
+      ++pos;
+    if (!readDigits(s, pos, 2, minute))
+      return false;
+    pos += 2;
+    if (!extended || hasChar(s, pos, ':')) {
+      if (extended)
+        ++pos;
+      if (readDigits(s, pos, 2, second)) {
+        pos += 2;
+      } else if (extended) {
+        return false;
+      }
+    }
+    if (hasChar(s, pos, '.') || hasChar(s, pos, ',')) {
+      ++pos;
+      if (pos >= s.size() || !isDigit(s[pos]))
+        return false;
+      while (pos < s.size() && isDigit(s[pos]))
+        ++pos;
+    }
+    if (hour > 23 || minute > 59 || second > 60)
+      return false;
+    ts.hasTime = true;
+
+    // Optional time zone designator: Z or (+|-)hh[[:]mm]
+    if (hasChar(s, pos, 'Z')) {
+      ++pos;
+      ts.hasTimeZone = true;
+    } else if (hasChar(s, pos, '+') || hasChar(s, pos, '-')) {
+      const bool negative = s[pos] == '-';
+      int tzHour = 0;
+      int tzMinute = 0;
+      if (!readDigits(s, pos + 1, 2, tzHour))
+        return false;
+      pos += 3;
+      if (hasChar(s, pos, ':'))
+        ++pos;
+      if (readDigits(s, pos, 2, tzMinute))
+        pos += 2;
+      if (tzHour > 23 || tzMinute > 59)
+        return false;
+      const int offset = tzHour * 60 + tzMinute;
+      ts.tzOffset = static_cast<int16_t>(negative ? -offset : offset);
+      ts.hasTimeZone = true;
+    }
+    if (pos != s.size())
+      return false;
+  }
+
+  ts.year = year;
+  ts.month = static_cast<uint8_t>(month);
+  ts.day = static_cast<uint8_t>(day);
+  ts.hour = static_cast<uint8_t>(hour);
+  ts.minute = static_cast<uint8_t>(minute);
+  ts.second = static_cast<uint8_t>(second);
+  ts.ok = true;
+  return true;
+}
+
+template <>
+size_t ValueType<uint16_t>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<uint32_t>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<int16_t>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<int32_t>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<URational>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<Rational>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<float>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+template <>
+size_t ValueType<double>::format(char* buf, size_t n) const {
+  ok_ = true;
+  return formatValueList(buf, n, value_);
+}
+
+std::vector<Timestamp> parseTimestamps(const std::vector<std::string>& strs) {
+  std::vector<Timestamp> result(strs.size());
+  for (size_t i = 0; i < strs.size(); ++i) {
+    parseTimestamp(strs[i], result[i]);
+  }
+  return result;
+}
+
 }  // namespace Exiv2
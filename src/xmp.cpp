@@ -257,13 +257,13 @@ namespace Exiv2 {
 //! Internal Pimpl structure of class Xmpdatum.
 struct Xmpdatum::Impl {
   Impl(const XmpKey& key, const Value* pValue);  //!< Constructor
-  Impl(const Impl& rhs);                         //!< Copy constructor
-  Impl& operator=(const Impl& rhs);              //!< Assignment
-  ~Impl() = default;
+  //! Constructor which shares \em key and takes over \em value
+  Impl(std::shared_ptr<const XmpKey> key, Value::UniquePtr value) : key_(std::move(key)), value_(std::move(value)) {
+  }
 
   // DATA
-  XmpKey::UniquePtr key_;   //!< Key
-  Value::UniquePtr value_;  //!< Value
+  std::shared_ptr<const XmpKey> key_;  //!< Key, shared with copies
+  std::shared_ptr<Value> value_;       //!< Value, shared with copies until it is modified
 };
 
 Xmpdatum::Impl::Impl(const XmpKey& key, const Value* pValue) : key_(key.clone()) {
@@ -271,26 +271,11 @@ Xmpdatum::Impl::Impl(const XmpKey& key, const Value* pValue) : key_(key.clone())
     value_ = pValue->clone();
 }
 
-Xmpdatum::Impl::Impl(const Impl& rhs) {
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
-}
-
-Xmpdatum::Impl& Xmpdatum::Impl::operator=(const Impl& rhs) {
-  if (this == &rhs)
-    return *this;
-  key_.reset();
-  if (rhs.key_)
-    key_ = rhs.key_->clone();  // deep copy
-  value_.reset();
-  if (rhs.value_)
-    value_ = rhs.value_->clone();  // deep copy
-  return *this;
+Xmpdatum::Xmpdatum(const XmpKey& key, const Value* pValue) : p_(std::make_unique<Impl>(key, pValue)) {
 }
 
-Xmpdatum::Xmpdatum(const XmpKey& key, const Value* pValue) : p_(std::make_unique<Impl>(key, pValue)) {
+Xmpdatum::Xmpdatum(std::shared_ptr<const XmpKey> key, Value::UniquePtr value) :
+    p_(std::make_unique<Impl>(std::move(key), std::move(value))) {
 }
 
 Xmpdatum::Xmpdatum(const Xmpdatum& rhs) : Metadatum(rhs), p_(std::make_unique<Impl>(*rhs.p_)) {
@@ -358,6 +343,11 @@ std::string Xmpdatum::toString(size_t n) const {
   return p_->value_ ? p_->value_->toString(n) : "";
 }
 
+void Xmpdatum::appendTo(std::string& out) const {
+  if (p_->value_)
+    p_->value_->appendTo(out);
+}
+
 int64_t Xmpdatum::toInt64(size_t n) const {
   return p_->value_ ? p_->value_->toInt64(n) : -1;
 }
@@ -413,6 +403,7 @@ int Xmpdatum::setValue(const std::string& value) {
     }
     p_->value_ = Value::create(type);
   }
+  detach(p_->value_);
   return p_->value_->read(value);
 }
 
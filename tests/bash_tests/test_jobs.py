@@ -0,0 +1,67 @@
+# -*- coding: utf-8 -*-
+
+import system_tests
+
+images = [
+    "exiv2-canon-eos-300d.jpg",
+    "exiv2-fujifilm-finepix-s2pro.jpg",
+    "exiv2-nikon-d70.jpg",
+    "exiv2-olympus-c8080wz.jpg",
+    "exiv2-panasonic-dmc-fz5.jpg",
+    "exiv2-sony-dsc-w7.jpg",
+    "Reagan.jpg",
+]
+files = " ".join("$data_path/" + image for image in images)
+copies = " ".join("$data_path/" + image.replace(".jpg", "_copy.jpg") for image in images)
+timestamps = "-Pkv -K Exif.Image.DateTime -K Exif.Photo.DateTimeOriginal "
+
+
+@system_tests.CopyFiles(*("$data_path/" + image for image in images))
+class ParallelJobsMatchSequentialRun(metaclass=system_tests.CaseMeta):
+    """
+    Files processed with -j are printed in the order of the command line, so
+    the output must be that of a sequential run. Timestamps adjusted in
+    parallel must not pick up those of other files.
+    """
+
+    commands = [
+        "$exiv2 -pt " + files,
+        "$exiv2 -j 4 -pt " + files,
+        "$exiv2 -v -pa " + files,
+        "$exiv2 -j 4 -v -pa " + files,
+        "$exiv2 " + timestamps + copies,
+        "$exiv2 -a 01:30 " + copies,
+        "$exiv2 " + timestamps + copies,
+        "$exiv2 -j 4 -a -01:30 " + copies,
+        "$exiv2 " + timestamps + copies,
+        "$exiv2 -j 4 -a 01:30 " + copies,
+        "$exiv2 " + timestamps + copies,
+    ]
+    #: index of the command whose output each command must reproduce
+    same_output = {1: 0, 3: 2, 8: 4, 10: 6}
+
+    stdout = [""] * len(commands)
+    stderr = [""] * len(commands)
+    retval = [0] * len(commands)
+
+    def compare_stderr(self, i, command, got_stderr, expected_stderr):
+        if i == 0:
+            self.errors = {}
+        self.errors[i] = got_stderr
+        if i in self.same_output:
+            self.assertMultiLineEqual(self.errors[self.same_output[i]], got_stderr)
+        elif i not in (0, 2):
+            self.assertMultiLineEqual(expected_stderr, got_stderr)
+
+    def compare_stdout(self, i, command, got_stdout, expected_stdout):
+        if i == 0:
+            self.outputs = {}
+        self.outputs[i] = got_stdout
+        if i in self.same_output:
+            self.assertMultiLineEqual(self.outputs[self.same_output[i]], got_stdout)
+        elif i in (5, 7, 9):
+            self.assertMultiLineEqual(expected_stdout, got_stdout)
+        else:
+            self.assertNotEqual("", got_stdout)
+        if i == 6:
+            self.assertNotEqual(self.outputs[4], got_stdout)
@@ -0,0 +1,61 @@
+# -*- coding: utf-8 -*-
+
+import system_tests
+
+
+@system_tests.CopyFiles("$data_path/exiv2-canon-eos-300d.jpg")
+@system_tests.DeleteFiles("$data_path/exiv2-json-empty.jpg")
+class PrintJsonEscapesValues(metaclass=system_tests.CaseMeta):
+    """
+    -pJ prints one JSON line per file: quotes, backslashes and control
+    characters are escaped, non-ASCII characters are written as UTF-8.
+    Files which cannot be read print no JSON, only the usual error.
+    """
+
+    def setUp(self):
+        open(self.expand_variables("$empty"), "wb").close()
+
+    filename = "$data_path/exiv2-canon-eos-300d_copy.jpg"
+    empty = "$data_path/exiv2-json-empty.jpg"
+    missing = "$data_path/exiv2-json-missing.jpg"
+    keys = "-K Exif.Image.Orientation -K Iptc.Application2.Caption -K Xmp.dc.source"
+
+    commands = [
+        "$exiv2 -m - $filename",
+        "$exiv2 -pJ $keys $filename",
+        "$exiv2 -pJ -K Exif.Image.Artist $filename",
+        "$exiv2 -pJ $empty",
+        "$exiv2 -pJ $missing",
+    ]
+    stdin = [
+        'set Iptc.Application2.Caption Line\x01end\n'
+        'set Xmp.dc.source Tab\there "quoted" back\\slash Café €\n',
+        None,
+        None,
+        None,
+        None,
+    ]
+    stdout = [
+        "",
+        '{"file":"$filename","metadata":['
+        '{"key":"Exif.Image.Orientation","type":"Short","count":1,"value":"6","text":"right, top"},'
+        '{"key":"Iptc.Application2.Caption","type":"String","count":8,'
+        '"value":"Line\\u0001end","text":"Line\\u0001end"},'
+        '{"key":"Xmp.dc.source","type":"XmpText","count":38,'
+        '"value":"Tab\\there \\"quoted\\" back\\\\slash Café €","text":"Tab\\there \\"quoted\\" back\\\\slash Café €"}'
+        ']}\n',
+        '{"file":"$filename","metadata":[]}\n',
+        "",
+        "",
+    ]
+    stderr = [
+        "",
+        "",
+        "",
+        """Exiv2 exception in print action for file $empty:
+Failed to read input data
+""",
+        """$missing: Failed to open the file
+""",
+    ]
+    retval = [0, 0, 1, 1, 255]
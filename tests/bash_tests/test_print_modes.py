@@ -0,0 +1,56 @@
+# -*- coding: utf-8 -*-
+
+import system_tests
+
+
+class PrintModesAreCombinedInOrder(metaclass=system_tests.CaseMeta):
+    """
+    Several -p modes print their output in command-line order. -K adds a tag
+    list after the other modes unless a mode already prints tags, wherever
+    it is given, and only one mode can print tags.
+    """
+
+    filename = "$data_path/exiv2-canon-eos-300d.jpg"
+    model = "-K Exif.Image.Model"
+
+    commands = [
+        "$exiv2 -pc -pp -pa $model $filename",
+        "$exiv2 -pp -pc $filename",
+        "$exiv2 $model -pS $filename",
+        "$exiv2 -pS $model $filename",
+        "$exiv2 -pa -pt $model $filename",
+    ]
+
+    structure = (
+        "STRUCTURE OF JPEG FILE: $filename\n"
+        " address | marker       |  length | data\n"
+        "       0 | 0xffd8 SOI  \n"
+        "       2 | 0xffe0 APP0  |      16 | JFIF.....H.H.\n"
+        "      20 | 0xffe1 APP1  |   12286 | Exif..II*...............z......\n"
+        "   12308 | 0xffdb DQT   |      67 \n"
+        "   12377 | 0xffdb DQT   |      67 \n"
+        "   12446 | 0xffc0 SOF0  |      17 \n"
+        "   12465 | 0xffc4 DHT   |      28 \n"
+        "   12495 | 0xffc4 DHT   |      60 \n"
+        "   12557 | 0xffc4 DHT   |      26 \n"
+        "   12585 | 0xffc4 DHT   |      37 \n"
+        "   12624 | 0xffda SOS  \n"
+    )
+    model_list = "Exif.Image.Model                             Ascii      23  Canon EOS 300D DIGITAL\n"
+    preview = "Preview 1: image/jpeg, 160x120 pixels, 9728 bytes\n"
+
+    stdout = [
+        "\n" + preview + model_list,
+        preview + "\n",
+        structure + model_list,
+        structure + model_list,
+        model_list,
+    ]
+    stderr = [
+        "",
+        "",
+        "",
+        "",
+        "exiv2: Ignoring surplus option -pt\n",
+    ]
+    retval = [0] * len(commands)
@@ -0,0 +1,46 @@
+# -*- coding: utf-8 -*-
+
+import system_tests
+
+
+@system_tests.CopyFiles("$data_path/exiv2-canon-eos-300d.jpg")
+class ServeRunsEachLineAsACommand(metaclass=system_tests.CaseMeta):
+    """
+    exiv2 --serve answers each command line with "rc nout nerr", followed by
+    the output and the error messages of the command. Empty lines are
+    skipped, commands using stdin are rejected and a modification is seen by
+    the following commands.
+    """
+
+    filename = "exiv2-canon-eos-300d_copy.jpg"
+    commands = ["cd $data_path && $exiv2 --serve"]
+    stdin = [
+        """-K Exif.Image.Model $filename
+
+-M"set Exif.Image.Artist 'Jane Doe'" $filename
+-Pkv -K Exif.Image.Artist -K Exif.Image.Model $filename
+-pa -
+-K "Exif.Image.Model $filename
+-pJ -K Exif.Image.Model $filename
+"""
+    ]
+    stdout = [
+        """0 83 0
+Exif.Image.Model                             Ascii      23  Canon EOS 300D DIGITAL
+0 0 0
+0 124 0
+Exif.Image.Model                              Canon EOS 300D DIGITAL
+Exif.Image.Artist                             Jane Doe
+1 88 54
+Usage: exiv2 [ option [ arg ] ]+ [ action ] file ...
+
+Image metadata manipulation tool.
+exiv2: stdin and stdout cannot be used in server mode
+1 0 47
+exiv2: Unterminated quote or escape in command
+0 172 0
+{"file":"$filename","metadata":[{"key":"Exif.Image.Model","type":"Ascii","count":23,"value":"Canon EOS 300D DIGITAL","text":"Canon EOS 300D DIGITAL"}]}
+"""
+    ]
+    stderr = [""]
+    retval = [0]
@@ -1,11 +1,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "error.hpp"
 #include "value.hpp"
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
 #include <array>
+#include <random>
+#include <regex>
 #include <sstream>
 
 using namespace Exiv2;
@@ -187,3 +190,56 @@ TEST(ADateValue, toRational)
     ASSERT_EQ(1, val.second);
 }
 */
+
+namespace {
+// The regular expression based implementation which DateValue::read used to have
+int readDateWithRegex(const std::string& buf, DateValue::Date& date) {
+  static const std::regex reExtended(R"(^(\d{4})-(\d{2})-(\d{2}))");
+  static const std::regex reBasic(R"(^(\d{4})(\d{2})(\d{2}))");
+  std::smatch sm;
+  if (std::regex_search(buf, sm, reExtended) || std::regex_search(buf, sm, reBasic)) {
+    date.year = std::stoi(sm[1].str());
+    date.month = std::stoi(sm[2].str());
+    if (date.month > 12) {
+      date.month = 0;
+      return 1;
+    }
+    date.day = std::stoi(sm[3].str());
+    if (date.day > 31) {
+      date.day = 0;
+      return 1;
+    }
+    return 0;
+  }
+  return 1;
+}
+}  // namespace
+
+TEST(ADateValue, isReadLikeTheRegexBasedImplementation) {
+  const auto level = LogMsg::level();
+  LogMsg::setLevel(LogMsg::mute);
+
+  std::mt19937 rng(20221019);
+  const std::string alphabet = "012345678901234567890123456789--T:\n";
+  std::uniform_int_distribution<size_t> length(0, 14);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  size_t accepted = 0;
+  for (int i = 0; i < 200000; ++i) {
+    std::string str;
+    const size_t n = length(rng);
+    for (size_t j = 0; j < n; ++j)
+      str += alphabet[pick(rng)];
+
+    DateValue value(1, 2, 3);
+    DateValue::Date expected = value.getDate();
+    const int rc = readDateWithRegex(str, expected);
+    ASSERT_EQ(rc, value.read(str)) << "'" << str << "'";
+    ASSERT_EQ(expected.year, value.getDate().year) << "'" << str << "'";
+    ASSERT_EQ(expected.month, value.getDate().month) << "'" << str << "'";
+    ASSERT_EQ(expected.day, value.getDate().day) << "'" << str << "'";
+    accepted += rc == 0;
+  }
+  ASSERT_GT(accepted, 1000U);
+
+  LogMsg::setLevel(level);
+}
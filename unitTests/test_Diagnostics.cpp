@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/error.hpp>
+#include <exiv2/exif.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace Exiv2;
+
+namespace {
+std::vector<std::string> handled;
+
+void testHandler(int /*level*/, const char* s) {
+  handled.emplace_back(s);
+}
+
+//! Install testHandler as the global log message handler for the lifetime of the object
+class GlobalHandler {
+ public:
+  GlobalHandler() : handler_(LogMsg::handler()), level_(LogMsg::level()) {
+    LogMsg::setHandler(testHandler);
+    LogMsg::setLevel(LogMsg::warn);
+    handled.clear();
+  }
+  ~GlobalHandler() {
+    LogMsg::setHandler(handler_);
+    LogMsg::setLevel(level_);
+  }
+  GlobalHandler(const GlobalHandler&) = delete;
+  GlobalHandler& operator=(const GlobalHandler&) = delete;
+
+ private:
+  LogMsg::Handler handler_;
+  LogMsg::Level level_;
+};
+}  // namespace
+
+TEST(Diagnostics, capturesLogMessagesOfItsThread) {
+  GlobalHandler global;
+  {
+    Diagnostics diagnostics(LogMsg::info);
+    ASSERT_EQ(&diagnostics, Diagnostics::current());
+    ASSERT_TRUE(LogMsg::enabled(LogMsg::info));
+    ASSERT_FALSE(LogMsg::enabled(LogMsg::debug));
+    EXV_INFO << "info " << 1 << "\n";
+    EXV_DEBUG << "not formatted\n";
+    EXV_ERROR << "error\n";
+    std::thread([] { EXV_WARNING << "other thread\n"; }).join();
+
+    ASSERT_EQ(2u, diagnostics.records().size());
+    ASSERT_EQ(LogMsg::info, diagnostics.records()[0].level);
+    ASSERT_EQ(ErrorCode::kerSuccess, diagnostics.records()[0].code);
+    ASSERT_EQ("info 1", diagnostics.records()[0].message);
+    ASSERT_EQ("info 1\nerror\n", diagnostics.text());
+  }
+  ASSERT_EQ(nullptr, Diagnostics::current());
+  EXV_WARNING << "after\n";
+  ASSERT_EQ((std::vector<std::string>{"other thread\n", "after\n"}), handled);
+}
+
+TEST(Diagnostics, nests) {
+  GlobalHandler global;
+  Diagnostics outer(LogMsg::warn);
+  {
+    Diagnostics inner(LogMsg::error);
+    EXV_WARNING << "suppressed\n";
+    EXV_ERROR << "inner\n";
+    ASSERT_EQ(1u, inner.records().size());
+  }
+  EXV_WARNING << "outer\n";
+  ASSERT_EQ("outer\n", outer.text());
+  ASSERT_TRUE(handled.empty());
+}
+
+TEST(Diagnostics, leavesTheGlobalSettingsToOtherThreads) {
+  GlobalHandler global;
+  {
+    Diagnostics diagnostics(LogMsg::info);
+    // saving and restoring the settings must not install the thread's sink
+    ASSERT_EQ(testHandler, LogMsg::handler());
+    ASSERT_EQ(LogMsg::warn, LogMsg::level());
+    LogMsg::setHandler(LogMsg::handler());
+    LogMsg::setLevel(LogMsg::level());
+    std::thread([] {
+      EXV_INFO << "suppressed\n";
+      EXV_WARNING << "other thread\n";
+    }).join();
+    EXV_INFO << "captured\n";
+    ASSERT_EQ("captured\n", diagnostics.text());
+  }
+  ASSERT_EQ(std::vector<std::string>{"other thread\n"}, handled);
+}
+
+TEST(Diagnostics, recordsCorruptTiffEntries) {
+  // IFD0 with Make "Can" and an ImageDescription whose data lies beyond the end
+  const byte tiff[] = {
+      'I',  'I',  0x2a, 0x00, 0x08, 0x00, 0x00, 0x00, 0x02, 0x00,                                      //
+      0x0f, 0x01, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 'C',  'a',  'n',  0x00,                          //
+      0x0e, 0x01, 0x02, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  //
+  };
+  GlobalHandler global;
+  Diagnostics diagnostics;
+  ExifData exifData;
+  ExifParser::decode(exifData, tiff, sizeof(tiff));
+  ASSERT_EQ("Can", exifData["Exif.Image.Make"].toString());
+
+  // one structured record instead of the log message
+  ASSERT_EQ(1u, diagnostics.records().size());
+  const Diagnostics::Record& record = diagnostics.records()[0];
+  ASSERT_EQ(LogMsg::error, record.level);
+  ASSERT_EQ(ErrorCode::kerCorruptedMetadata, record.code);
+  ASSERT_EQ(22u, record.offset);
+  ASSERT_STREQ("Image", record.group);
+  ASSERT_EQ(0x010e, record.tag);
+  ASSERT_EQ("Image tag 0x010e at offset 22: offset of the entry is out of bounds", record.text());
+  ASSERT_TRUE(handled.empty());
+}
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/basicio.hpp>
+#include <exiv2/error.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/futils.hpp>
+#include <exiv2/image.hpp>
+#include <exiv2/jpgimage.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace Exiv2;
+
+namespace {
+/*!
+  A JPEG with an Exif segment with one good entry and one entry with its data out of bounds,
+  a comment and a segment which is cut off by the end of the file.
+ */
+std::vector<byte> corruptJpeg() {
+  return {
+      0xff, 0xd8,                                // SOI
+      0xff, 0xe1, 0x00, 0x2e,                    // APP1, size 46
+      'E',  'x',  'i',  'f',  0x00, 0x00,        // Exif header, TIFF data at file offset 12
+      'I',  'I',  0x2a, 0x00, 0x08, 0x00, 0x00, 0x00,  // TIFF header
+      0x02, 0x00,                                // IFD0 with 2 entries
+      0x0f, 0x01, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 'C', 'a', 'n', 0x00,  // Make "Can"
+      0x0e, 0x01, 0x02, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,  // ImageDescription at 0x1000
+      0x00, 0x00, 0x00, 0x00,                    // no next IFD
+      0xff, 0xfe, 0x00, 0x07, 'h',  'e',  'l',  'l',  'o',  // COM
+      0xff, 0xe2, 0x04, 0x00, 0x01, 0x02, 0x03,  // APP2, size 1024, truncated
+  };
+}
+}  // namespace
+
+TEST(ErrorCollector, collectsErrorsInOrder) {
+  ErrorCollector errors;
+  ASSERT_TRUE(errors.empty());
+  errors.add(ErrorCode::kerCorruptedMetadata, 10, "first");
+  errors.add(ErrorCode::kerFailedToReadImageData, ErrorCollector::noOffset, "second");
+  ASSERT_EQ(2u, errors.count());
+  ASSERT_EQ(ErrorCode::kerCorruptedMetadata, errors.errors()[0].code);
+  ASSERT_EQ(10u, errors.errors()[0].offset);
+  ASSERT_EQ("second", errors.errors()[1].message);
+  errors.clear();
+  ASSERT_TRUE(errors.empty());
+}
+
+TEST(ErrorCollector, readsIntactFilesLikeReadMetadata) {
+  const std::string path = std::string(TESTDATA_PATH) + "/exiv2-canon-powershot-s40.jpg";
+  auto image = ImageFactory::open(path);
+  image->readMetadata();
+  auto tried = ImageFactory::open(path);
+  ErrorCollector errors;
+  ASSERT_TRUE(tried->tryReadMetadata(errors));
+  ASSERT_TRUE(errors.empty());
+  ASSERT_EQ(image->exifData().count(), tried->exifData().count());
+}
+
+TEST(ErrorCollector, keepsMetadataOfCorruptJpeg) {
+  const std::vector<byte> jpeg = corruptJpeg();
+  auto image = ImageFactory::open(jpeg.data(), jpeg.size());
+  ASSERT_THROW(image->readMetadata(), Error);
+
+  ErrorCollector errors;
+  ASSERT_FALSE(image->tryReadMetadata(errors));
+  ASSERT_EQ(2u, errors.count());
+  // the entry which points out of bounds, at its offset in the file
+  ASSERT_EQ(ErrorCode::kerCorruptedMetadata, errors.errors()[0].code);
+  ASSERT_EQ(34u, errors.errors()[0].offset);
+  // the truncated segment, at its size field
+  ASSERT_EQ(ErrorCode::kerFailedToReadImageData, errors.errors()[1].code);
+  ASSERT_EQ(61u, errors.errors()[1].offset);
+
+  ASSERT_EQ("Can", image->exifData()["Exif.Image.Make"].toString());
+  ASSERT_EQ("hello", image->comment());
+}
+
+TEST(ErrorCollector, keepsMetadataOfTruncatedPng) {
+  DataBuf file = readFile(std::string(TESTDATA_PATH) + "/imagemagick.png");
+  auto image = ImageFactory::open(file.c_data(), file.size());
+  ErrorCollector intact;
+  image->tryReadMetadata(intact);  // the file has a corrupt makernote
+  const size_t count = image->xmpData().count() + image->exifData().count() + image->iptcData().count();
+  ASSERT_NE(0u, count);
+
+  // cut the file in the first IDAT chunk, which follows the metadata
+  const byte idat[] = {'I', 'D', 'A', 'T'};
+  const size_t pos = std::search(file.begin(), file.end(), std::begin(idat), std::end(idat)) - file.begin();
+  ASSERT_LT(pos, file.size());
+  auto truncated = ImageFactory::open(file.c_data(), pos + 10);
+  ASSERT_THROW(truncated->readMetadata(), Error);
+
+  ErrorCollector errors;
+  ASSERT_FALSE(truncated->tryReadMetadata(errors));
+  ASSERT_EQ(intact.count() + 1, errors.count());
+  ASSERT_EQ(ErrorCode::kerFailedToReadImageData, errors.errors().back().code);
+  ASSERT_EQ(pos - 4, errors.errors().back().offset);
+  ASSERT_EQ(count, truncated->xmpData().count() + truncated->exifData().count() + truncated->iptcData().count());
+}
+
+TEST(ErrorCollector, recordsErrorsWhichPreventReading) {
+  const byte notAJpeg[] = {0x00, 0x01, 0x02, 0x03};
+  JpegImage image(std::make_unique<MemIo>(notAJpeg, sizeof(notAJpeg)), false);
+  ErrorCollector errors;
+  ASSERT_FALSE(image.tryReadMetadata(errors));
+  ASSERT_EQ(1u, errors.count());
+  ASSERT_EQ(ErrorCode::kerNotAJpeg, errors.errors()[0].code);
+  ASSERT_EQ(ErrorCollector::noOffset, errors.errors()[0].offset);
+}
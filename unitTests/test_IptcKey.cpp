@@ -101,3 +101,29 @@ TEST(IptcKey, record) {
   IptcKey key("Iptc.Envelope.ModelVersion");
   ASSERT_EQ(IptcDataSets::envelope, key.record());
 }
+
+TEST(IptcKey, creationWithMalformedKeysThrows) {
+  for (auto&& key : {"", ".", "..", "Iptc", "Iptc.Envelope", "Iptc.Envelope.", ".Envelope.ModelVersion",
+                     "Iptc..ModelVersion", "Iptc.Envelope.ModelVersion.", "Iptc.Envelope.Model-Version",
+                     "Iptc.Envelope.Model Version", "Iptc.Envelope.ModelVersion.Extra"}) {
+    try {
+      IptcKey k(key);
+      FAIL() << key;
+    } catch (const Exiv2::Error& e) {
+      ASSERT_EQ(ErrorCode::kerInvalidKey, e.code()) << key;
+    }
+  }
+}
+
+TEST(IptcKey, hexRecordAndDatasetNamesAreTranslated) {
+  IptcKey key("Iptc.0x0002.0x0019");
+  ASSERT_EQ("Iptc.Application2.Keywords", key.key());
+  ASSERT_EQ(IptcDataSets::Keywords, key.tag());
+  ASSERT_EQ(IptcDataSets::application2, key.record());
+}
+
+TEST(IptcKey, unknownHexDatasetKeepsHexName) {
+  IptcKey key("Iptc.Application2.0x00ff");
+  ASSERT_EQ("Iptc.Application2.0x00ff", key.key());
+  ASSERT_EQ(0xff, key.tag());
+}
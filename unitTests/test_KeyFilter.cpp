@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <exiv2/metadatum.hpp>
+
+#include <random>
+#include <regex>
+
+using namespace Exiv2;
+
+namespace {
+const std::string keys[] = {
+    "Exif.Image.Make",      "Exif.Image.Model",        "Exif.Photo.DateTimeOriginal", "Exif.Photo.ExposureTime",
+    "Exif.Canon.ModelID",   "Exif.Nikon3.Lens",        "Iptc.Application2.Caption",   "Iptc.Envelope.ModelVersion",
+    "Xmp.dc.title",         "Xmp.exif.DateTimeOriginal", "Xmp.xmpMM.History[1]/stEvt:action", "Exif.Image.0x9999",
+    "Xmp.photoshop.City",   "Xmp.dc.subject",          "a$b",                         "a.b*c",
+};
+}  // namespace
+
+TEST(KeyFilter, isEmptyUntilSomethingIsAdded) {
+  KeyFilter filter;
+  ASSERT_TRUE(filter.empty());
+  ASSERT_FALSE(filter.matches("Exif.Image.Make"));
+  filter.addKey("Exif.Image.Make");
+  ASSERT_FALSE(filter.empty());
+}
+
+TEST(KeyFilter, matchesKeysExactly) {
+  KeyFilter filter;
+  filter.addKey("Exif.Image.Make");
+  filter.addKey("Xmp.dc.title");
+  ASSERT_TRUE(filter.matches("Exif.Image.Make"));
+  ASSERT_TRUE(filter.matches("Xmp.dc.title"));
+  ASSERT_FALSE(filter.matches("Exif.Image.Model"));
+  ASSERT_FALSE(filter.matches("exif.image.make"));
+  ASSERT_FALSE(filter.matches("Exif.Image.Mak"));
+}
+
+TEST(KeyFilter, matchesPatternsLikeRegexSearch) {
+  KeyFilter filter;
+  filter.addPattern("Model");
+  filter.addPattern("^Xmp\\.dc\\.");
+  filter.addPattern("Original$");
+  filter.addPattern("^Exif.Nikon3.Lens$");
+  filter.addPattern("stEvt:act", true);
+  ASSERT_TRUE(filter.matches("Exif.Image.Model"));
+  ASSERT_TRUE(filter.matches("Iptc.Envelope.ModelVersion"));
+  ASSERT_TRUE(filter.matches("Xmp.dc.subject"));
+  ASSERT_FALSE(filter.matches("Xmp.dcx.subject"));
+  ASSERT_TRUE(filter.matches("Exif.Photo.DateTimeOriginal"));
+  ASSERT_TRUE(filter.matches("Exif.Nikon3.Lens"));
+  ASSERT_FALSE(filter.matches("Exif.Nikon3.LensType"));
+  ASSERT_TRUE(filter.matches("Xmp.xmpMM.History[1]/STEVT:ACTION"));
+  ASSERT_FALSE(filter.matches("Exif.Image.Make"));
+}
+
+TEST(KeyFilter, throwsOnInvalidRegex) {
+  KeyFilter filter;
+  ASSERT_THROW(filter.addPattern("[abc"), std::regex_error);
+}
+
+TEST(KeyFilter, copiesAreIndependent) {
+  KeyFilter filter;
+  filter.addPattern("Make");
+  KeyFilter copy(filter);
+  copy.addPattern("Model");
+  ASSERT_TRUE(copy.matches("Exif.Image.Model"));
+  ASSERT_FALSE(filter.matches("Exif.Image.Model"));
+  filter = copy;
+  ASSERT_TRUE(filter.matches("Exif.Image.Model"));
+}
+
+TEST(KeyFilter, agreesWithStdRegex) {
+  // Random patterns from pieces of keys and regex syntax, some of them plain text, some not
+  const std::string pieces[] = {"Exif", "Xmp",  "Image", "Model", "model", "Date", ".",  "\\.", "^",  "$",
+                                "*",    "\\*",  "\\$",   "[a-z]", "e",     "o",    "x",  "a",   "b",  "Ma",
+                                "\\\\", "\\^",  "\\[",   "\\]",   "1",     ":",    "/",  "+",   "?",  "M.de"};
+  std::mt19937 rng(4711);
+  std::uniform_int_distribution<size_t> len(0, 5);
+  std::uniform_int_distribution<size_t> pick(0, std::size(pieces) - 1);
+  std::uniform_int_distribution<int> coin(0, 1);
+  for (int i = 0; i < 2000; ++i) {
+    std::string pattern;
+    for (size_t n = len(rng); n > 0; --n)
+      pattern += pieces[pick(rng)];
+    const bool ignoreCase = coin(rng);
+    auto flags = std::regex::basic | std::regex::nosubs;
+    std::regex re;
+    try {
+      re = std::regex(pattern, ignoreCase ? flags | std::regex::icase : flags);
+    } catch (const std::regex_error&) {
+      continue;
+    }
+    KeyFilter filter;
+    filter.addPattern(pattern, ignoreCase);
+    for (auto&& key : keys) {
+      ASSERT_EQ(std::regex_search(key, re), filter.matches(key))
+          << "pattern \"" << pattern << "\"" << (ignoreCase ? "/i" : "") << ", key " << key;
+    }
+  }
+}
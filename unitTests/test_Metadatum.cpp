@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/bmpimage.hpp>
+#include <exiv2/error.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/image.hpp>
+#include <exiv2/iptc.hpp>
+#include <exiv2/xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+#include <new>
+#include <thread>
+
+using namespace Exiv2;
+
+TEST(Metadatum, copiesShareTheValueUntilItIsModified) {
+  Exifdatum exif(ExifKey("Exif.Image.Make"));
+  exif.setValue("Canon");
+  Exifdatum copy(exif);
+  ASSERT_EQ(&exif.value(), &copy.value());
+
+  copy.setValue("Nikon");
+  ASSERT_NE(&exif.value(), &copy.value());
+  ASSERT_EQ("Canon", exif.toString());
+  ASSERT_EQ("Nikon", copy.toString());
+
+  // the only owner is modified in place
+  const Value* value = &copy.value();
+  copy.setValue("Sony");
+  ASSERT_EQ(value, &copy.value());
+
+  Exifdatum offset(ExifKey("Exif.Thumbnail.JPEGInterchangeFormat"));
+  offset = static_cast<uint32_t>(0);
+  Exifdatum assigned(ExifKey("Exif.Image.Model"));
+  assigned = offset;
+  ASSERT_EQ(&offset.value(), &assigned.value());
+  const byte data[] = {1, 2, 3};
+  assigned.setDataArea(data, sizeof(data));
+  ASSERT_EQ(0u, offset.sizeDataArea());
+  ASSERT_EQ(3u, assigned.sizeDataArea());
+}
+
+TEST(Metadatum, iptcAndXmpCopiesShareTheValueUntilItIsModified) {
+  Iptcdatum iptc(IptcKey("Iptc.Application2.City"));
+  iptc.setValue("Berlin");
+  Iptcdatum iptcCopy(iptc);
+  ASSERT_EQ(&iptc.value(), &iptcCopy.value());
+  iptcCopy.setValue("Paris");
+  ASSERT_EQ("Berlin", iptc.toString());
+  ASSERT_EQ("Paris", iptcCopy.toString());
+
+  Xmpdatum xmp(XmpKey("Xmp.dc.format"));
+  xmp.setValue("image/jpeg");
+  Xmpdatum xmpCopy(xmp);
+  ASSERT_EQ(&xmp.value(), &xmpCopy.value());
+  xmpCopy.setValue("image/png");
+  ASSERT_EQ("image/jpeg", xmp.toString());
+  ASSERT_EQ("image/png", xmpCopy.toString());
+}
+
+TEST(Metadatum, setMetadataSharesTheValuesOfTheSource) {
+  auto master = ImageFactory::create(ImageType::jpeg);
+  master->exifData()["Exif.Image.Make"] = "Canon";
+  master->iptcData()["Iptc.Application2.City"] = "Berlin";
+  master->xmpData()["Xmp.dc.format"] = "image/jpeg";
+
+  auto derived = ImageFactory::create(ImageType::jpeg);
+  derived->setMetadata(*master);
+  ASSERT_EQ(&master->exifData().begin()->value(), &derived->exifData().begin()->value());
+  ASSERT_EQ(&master->iptcData().begin()->value(), &derived->iptcData().begin()->value());
+  ASSERT_EQ(&master->xmpData().begin()->value(), &derived->xmpData().begin()->value());
+
+  derived->exifData()["Exif.Image.Make"].setValue("Nikon");
+  ASSERT_EQ("Canon", master->exifData()["Exif.Image.Make"].toString());
+  ASSERT_EQ("Nikon", derived->exifData()["Exif.Image.Make"].toString());
+}
+
+TEST(Metadatum, copiesCanBeReadFromDifferentThreads) {
+  auto master = ImageFactory::create(ImageType::jpeg);
+  master->exifData()["Exif.Photo.ExposureTime"] = "1/0 1/100";
+  auto first = ImageFactory::create(ImageType::jpeg);
+  auto second = ImageFactory::create(ImageType::jpeg);
+  first->setMetadata(*master);
+  second->setMetadata(*master);
+  const Exifdatum& exposure1 = *first->exifData().begin();
+  const Exifdatum& exposure2 = *second->exifData().begin();
+  ASSERT_EQ(&exposure1.value(), &exposure2.value());
+
+  // threads can convert the shared value at the same time
+  auto convert = [](const Exifdatum& exposure, size_t n, bool ok) {
+    bool failed = false;
+    for (int i = 0; i < 10000; ++i) {
+      const float value = exposure.toFloat(n);
+      failed |= (value != 0.0F) != ok;
+    }
+    return !failed;
+  };
+  bool ok1 = false;
+  bool ok2 = false;
+  std::thread thread([&] { ok1 = convert(exposure1, 0, false); });
+  ok2 = convert(exposure2, 1, true);
+  thread.join();
+  ASSERT_TRUE(ok1);
+  ASSERT_TRUE(ok2);
+
+  // a failed conversion is still reported after converting another value
+  ASSERT_EQ(0.0F, exposure1.toFloat(0));
+  Exifdatum other(ExifKey("Exif.Photo.FNumber"));
+  other.setValue("28/10");
+  ASSERT_FLOAT_EQ(2.8F, other.toFloat());
+  ASSERT_TRUE(other.value().ok());
+  ASSERT_FALSE(exposure1.value().ok());
+}
+
+TEST(Metadatum, conversionStatusBelongsToTheValue) {
+  // every value keeps its status, however many other conversions failed
+  std::vector<std::unique_ptr<Value>> values;
+  for (int i = 0; i < 32; ++i) {
+    values.push_back(Value::create(unsignedRational));
+    values.back()->read("1/0");
+    ASSERT_EQ(0.0F, values.back()->toFloat());
+  }
+  for (auto&& value : values)
+    ASSERT_FALSE(value->ok());
+
+  // a new value at the address of a destroyed one starts with a successful status
+  alignas(URationalValue) unsigned char storage[sizeof(URationalValue)];
+  auto failed = new (storage) URationalValue;
+  failed->read("1/0");
+  ASSERT_EQ(0.0F, failed->toFloat());
+  ASSERT_FALSE(failed->ok());
+  failed->~URationalValue();
+  auto reused = new (storage) URationalValue;
+  ASSERT_TRUE(reused->ok());
+  reused->read("1/2");
+  ASSERT_FLOAT_EQ(0.5F, reused->toFloat());
+  ASSERT_TRUE(reused->ok());
+  reused->~URationalValue();
+}
+
+TEST(Metadatum, rvalueSettersMoveTheMetadata) {
+  ExifData exifData;
+  exifData["Exif.Image.Make"] = "Canon";
+  const Exifdatum* datum = &*exifData.begin();
+
+  auto image = ImageFactory::create(ImageType::jpeg);
+  image->setExifData(std::move(exifData));
+  ASSERT_EQ(datum, &*image->exifData().begin());
+
+  XmpData xmpData;
+  xmpData["Xmp.dc.format"] = "image/jpeg";
+  image->writeXmpFromPacket(true);
+  image->setXmpData(std::move(xmpData));
+  ASSERT_FALSE(image->writeXmpFromPacket());
+  ASSERT_EQ(1, image->xmpData().count());
+
+  // images which cannot write the metadata still reject it
+  std::unique_ptr<Image> bmp = std::make_unique<BmpImage>(std::make_unique<MemIo>());
+  ASSERT_THROW(bmp->setIptcData(IptcData()), Error);
+}
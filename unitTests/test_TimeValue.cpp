@@ -1,7 +1,11 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <gtest/gtest.h>
+#include "error.hpp"
 #include "value.hpp"
+
+#include <random>
+#include <regex>
 using namespace Exiv2;
 
 TEST(ATimeValue, isDefaultConstructed) {
@@ -158,3 +162,86 @@ TEST(ATimeValue, isCopiedToBuffer) {
     ASSERT_EQ(expectedDate[i], buffer[i]) << "i: " << i;
   }
 }
+
+TEST(ATimeValue, readsUtcDesignatorAsZeroOffset) {
+  TimeValue value(10, 0, 0, 2, 30);
+  ASSERT_EQ(0, value.read("10:20:30Z"));
+  ASSERT_EQ(10, value.getTime().hour);
+  ASSERT_EQ(20, value.getTime().minute);
+  ASSERT_EQ(30, value.getTime().second);
+  ASSERT_EQ(0, value.getTime().tzHour);
+  ASSERT_EQ(0, value.getTime().tzMinute);
+}
+
+namespace {
+// The regular expression based implementation which TimeValue::read used
+// to have. It throws for the "Z" time zone designator, which is reported
+// as an offset of zero here.
+int readTimeWithRegex(const std::string& buf, TimeValue::Time& time) {
+  static const std::regex re(R"(^(2[0-3]|[01][0-9]):?([0-5][0-9])?:?([0-5][0-9])?$)");
+  static const std::regex reExt(
+      R"(^(2[0-3]|[01][0-9]):?([0-5][0-9]):?([0-5][0-9])(Z|[+-](?:2[0-3]|[01][0-9])(?::?(?:[0-5][0-9]))?)$)");
+
+  std::smatch sm;
+  if (std::regex_match(buf, sm, re) || std::regex_match(buf, sm, reExt)) {
+    time.hour = sm.length(1) ? std::stoi(sm[1].str()) : 0;
+    time.minute = sm.length(2) ? std::stoi(sm[2].str()) : 0;
+    time.second = sm.length(3) ? std::stoi(sm[3].str()) : 0;
+    if (sm.size() > 4) {
+      std::string str = sm[4].str();
+      if (str == "Z") {
+        time.tzHour = 0;
+        time.tzMinute = 0;
+        return 0;
+      }
+      auto posColon = str.find(':');
+      if (posColon == std::string::npos) {
+        time.tzHour = std::stoi(str.substr(0, 3));
+        if (str.size() > 3) {
+          int minute = std::stoi(str.substr(3));
+          time.tzMinute = time.tzHour < 0 ? -minute : minute;
+        }
+      } else {
+        time.tzHour = std::stoi(str.substr(0, posColon));
+        int minute = std::stoi(str.substr(posColon + 1));
+        time.tzMinute = time.tzHour < 0 ? -minute : minute;
+      }
+    }
+    return 0;
+  }
+  return 1;
+}
+}  // namespace
+
+TEST(ATimeValue, isReadLikeTheRegexBasedImplementation) {
+  const auto level = LogMsg::level();
+  LogMsg::setLevel(LogMsg::mute);
+
+  std::mt19937 rng(20221019);
+  const std::string alphabet = "0123456789012345:::+-Z ";
+  std::uniform_int_distribution<size_t> length(0, 14);
+  std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+  size_t accepted = 0;
+  for (int i = 0; i < 200000; ++i) {
+    std::string str;
+    const size_t n = length(rng);
+    for (size_t j = 0; j < n; ++j)
+      str += alphabet[pick(rng)];
+
+    // Start from the same non-zero state, the parsers only update what they read
+    TimeValue value(1, 2, 3, 4, 5);
+    TimeValue::Time expected = value.getTime();
+    const int rc = readTimeWithRegex(str, expected);
+    ASSERT_EQ(rc, value.read(str)) << "'" << str << "'";
+    ASSERT_EQ(expected.hour, value.getTime().hour) << "'" << str << "'";
+    ASSERT_EQ(expected.minute, value.getTime().minute) << "'" << str << "'";
+    ASSERT_EQ(expected.second, value.getTime().second) << "'" << str << "'";
+    ASSERT_EQ(expected.tzHour, value.getTime().tzHour) << "'" << str << "'";
+    ASSERT_EQ(expected.tzMinute, value.getTime().tzMinute) << "'" << str << "'";
+    accepted += rc == 0;
+  }
+  // Make sure that the comparison isn't dominated by rejected strings
+  ASSERT_GT(accepted, 1000U);
+
+  LogMsg::setLevel(level);
+}
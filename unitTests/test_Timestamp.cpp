@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "value.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace {
+void expectTimestamp(const Timestamp& ts, int year, int month, int day, int hour, int minute, int second) {
+  EXPECT_TRUE(ts.ok);
+  EXPECT_EQ(year, ts.year);
+  EXPECT_EQ(month, ts.month);
+  EXPECT_EQ(day, ts.day);
+  EXPECT_EQ(hour, ts.hour);
+  EXPECT_EQ(minute, ts.minute);
+  EXPECT_EQ(second, ts.second);
+}
+}  // namespace
+
+TEST(parseTimestamp, readsExifDateTime) {
+  Timestamp ts;
+  ASSERT_TRUE(parseTimestamp("2018:04:02 12:01:44", ts));
+  expectTimestamp(ts, 2018, 4, 2, 12, 1, 44);
+  ASSERT_TRUE(ts.hasTime);
+  ASSERT_FALSE(ts.hasTimeZone);
+}
+
+TEST(parseTimestamp, readsXmpDatesWithReducedPrecision) {
+  Timestamp ts;
+  ASSERT_TRUE(parseTimestamp("2018", ts));
+  expectTimestamp(ts, 2018, 1, 1, 0, 0, 0);
+  ASSERT_FALSE(ts.hasTime);
+  ASSERT_TRUE(parseTimestamp("2018-04", ts));
+  expectTimestamp(ts, 2018, 4, 1, 0, 0, 0);
+  ASSERT_TRUE(parseTimestamp("2018-04-02", ts));
+  expectTimestamp(ts, 2018, 4, 2, 0, 0, 0);
+  ASSERT_TRUE(parseTimestamp("2018-04-02T12:01", ts));
+  expectTimestamp(ts, 2018, 4, 2, 12, 1, 0);
+  ASSERT_TRUE(ts.hasTime);
+}
+
+TEST(parseTimestamp, readsXmpDateTimeWithTimeZone) {
+  Timestamp ts;
+  ASSERT_TRUE(parseTimestamp("2018-04-02T12:01:44.999+02:30", ts));
+  expectTimestamp(ts, 2018, 4, 2, 12, 1, 44);
+  ASSERT_TRUE(ts.hasTimeZone);
+  ASSERT_EQ(150, ts.tzOffset);
+  ASSERT_TRUE(parseTimestamp("2018-04-02T12:01:44-05:00", ts));
+  ASSERT_EQ(-300, ts.tzOffset);
+  ASSERT_TRUE(parseTimestamp("2018-04-02T12:01:44Z", ts));
+  ASSERT_TRUE(ts.hasTimeZone);
+  ASSERT_EQ(0, ts.tzOffset);
+}
+
+TEST(parseTimestamp, readsIptcBasicFormat) {
+  Timestamp ts;
+  ASSERT_TRUE(parseTimestamp("20180402", ts));
+  expectTimestamp(ts, 2018, 4, 2, 0, 0, 0);
+  ASSERT_TRUE(parseTimestamp("20180402T120144-0130", ts));
+  expectTimestamp(ts, 2018, 4, 2, 12, 1, 44);
+  ASSERT_EQ(-90, ts.tzOffset);
+}
+
+TEST(parseTimestamp, rejectsInvalidStrings) {
+  Timestamp ts;
+  for (auto&& str : {"", "201", "2018-13-01", "2018-04-32", "0000:00:00 00:00:00", "2018-04-02T25:00",
+                     "2018-04-02T12:61", "2018-04-02 12:01:44 ", "2018-04-02X", "2018:04-02", "2018-04-02T12:01:44+",
+                     "2018-04-02T12:01:44.", "abcd"}) {
+    EXPECT_FALSE(parseTimestamp(str, ts)) << str;
+    EXPECT_FALSE(ts.ok) << str;
+  }
+}
+
+TEST(parseTimestamps, parsesEachStringInOrder) {
+  const auto result = parseTimestamps({"2018:04:02 12:01:44", "invalid", "2019-05-06"});
+  ASSERT_EQ(3U, result.size());
+  expectTimestamp(result[0], 2018, 4, 2, 12, 1, 44);
+  ASSERT_FALSE(result[1].ok);
+  expectTimestamp(result[2], 2019, 5, 6, 0, 0, 0);
+}
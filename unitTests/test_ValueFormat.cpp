@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <exiv2/exif.hpp>
+#include <exiv2/value.hpp>
+
+#include <limits>
+#include <sstream>
+
+using namespace Exiv2;
+
+namespace {
+std::string streamed(const Value& value) {
+  std::ostringstream os;
+  value.write(os);
+  return os.str();
+}
+
+std::string formatted(const Value& value) {
+  std::string s;
+  value.appendTo(s);
+  return s;
+}
+
+void expectSameAsWrite(const Value& value) {
+  EXPECT_EQ(streamed(value), formatted(value));
+  EXPECT_EQ(streamed(value), value.toString());
+}
+}  // namespace
+
+TEST(ValueFormat, integersAreFormattedLikeWrite) {
+  expectSameAsWrite(UShortValue());
+  UShortValue us;
+  us.read("0 1 65535 42");
+  expectSameAsWrite(us);
+  ULongValue ul;
+  ul.read("4294967295 0 17");
+  expectSameAsWrite(ul);
+  ShortValue ss;
+  ss.read("-32768 32767 -1");
+  expectSameAsWrite(ss);
+  LongValue sl;
+  sl.read("-2147483648 2147483647 0");
+  expectSameAsWrite(sl);
+}
+
+TEST(ValueFormat, rationalsAreFormattedLikeWrite) {
+  URationalValue ur;
+  ur.value_ = {{1, 3}, {4294967295U, 1}, {0, 0}};
+  expectSameAsWrite(ur);
+  RationalValue r;
+  r.value_ = {{-1, 3}, {std::numeric_limits<int32_t>::min(), -1}, {7, 0}};
+  expectSameAsWrite(r);
+  ASSERT_EQ("-1/3 -2147483648/-1 7/0", formatted(r));
+}
+
+TEST(ValueFormat, floatsAreFormattedLikeWrite) {
+  FloatValue f;
+  f.value_ = {0.1f,
+              1.0f / 3.0f,
+              -2.5f,
+              1e20f,
+              1e-7f,
+              0.0f,
+              -0.0f,
+              123456.0f,
+              std::numeric_limits<float>::max(),
+              std::numeric_limits<float>::denorm_min(),
+              std::numeric_limits<float>::infinity(),
+              -std::numeric_limits<float>::infinity()};
+  expectSameAsWrite(f);
+  DoubleValue d;
+  d.value_ = {0.1, 1.0 / 3.0, 1e100, -1e-300, 123456789012345678.0, 100000000000000.0, 1000000000000000.0,
+              std::numeric_limits<double>::min(), std::numeric_limits<double>::quiet_NaN()};
+  expectSameAsWrite(d);
+}
+
+TEST(ValueFormat, bytesAndStringsAreFormattedLikeWrite) {
+  const byte bytes[] = {0, 1, 127, 128, 255};
+  DataValue data(bytes, sizeof(bytes));
+  expectSameAsWrite(data);
+
+  AsciiValue ascii(std::string("abc\0def", 7));
+  expectSameAsWrite(ascii);
+  ASSERT_EQ("abc", formatted(ascii));
+
+  StringValue str("a string");
+  expectSameAsWrite(str);
+
+  CommentValue comment("charset=Ascii An ascii comment");
+  expectSameAsWrite(comment);
+  CommentValue plain("Without charset");
+  expectSameAsWrite(plain);
+}
+
+TEST(ValueFormat, xmpValuesAreFormattedLikeWrite) {
+  XmpTextValue text("some text");
+  expectSameAsWrite(text);
+  XmpTextValue bag;
+  bag.read("type=Bag");
+  expectSameAsWrite(bag);
+
+  XmpArrayValue array(xmpSeq);
+  array.read("first");
+  array.read("second");
+  expectSameAsWrite(array);
+
+  LangAltValue langAlt;
+  langAlt.read("lang=de-DE Hallo");
+  langAlt.read("lang=x-default Hello");
+  langAlt.read("lang=fr-FR Bonjour");
+  expectSameAsWrite(langAlt);
+}
+
+TEST(ValueFormat, datesAndTimesAreFormattedLikeWrite) {
+  expectSameAsWrite(DateValue(2021, 3, 7));
+  expectSameAsWrite(DateValue(5, 12, 31));
+  expectSameAsWrite(DateValue(-5, 1, 1));
+  expectSameAsWrite(DateValue(12345, 1, 1));
+
+  expectSameAsWrite(TimeValue(1, 2, 3, 4, 5));
+  expectSameAsWrite(TimeValue(23, 59, 59, -11, -30));
+  expectSameAsWrite(TimeValue(0, 0, 0, 0, -30));
+}
+
+TEST(ValueFormat, truncatesLikeSnprintf) {
+  ULongValue ul;
+  ul.read("123456 7");
+  char buf[8] = "xxxxxxx";
+  ASSERT_EQ(8u, ul.format(buf, sizeof(buf)));
+  ASSERT_STREQ("123456 ", buf);
+
+  ASSERT_EQ(8u, ul.format(buf, 1));
+  ASSERT_STREQ("", buf);
+
+  buf[0] = 'x';
+  ASSERT_EQ(8u, ul.format(buf, 0));
+  ASSERT_EQ('x', buf[0]);
+
+  char exact[9];
+  ASSERT_EQ(8u, ul.format(exact, sizeof(exact)));
+  ASSERT_STREQ("123456 7", exact);
+}
+
+TEST(ValueFormat, appendsLongValues) {
+  UShortValue us;
+  std::string expected;
+  for (int i = 0; i < 500; ++i) {
+    us.value_.push_back(static_cast<uint16_t>(i * 97));
+    expected += (i ? " " : "") + std::to_string(static_cast<uint16_t>(i * 97));
+  }
+  std::string s = "prefix ";
+  us.appendTo(s);
+  ASSERT_EQ("prefix " + expected, s);
+  ASSERT_EQ(expected, static_cast<const Value&>(us).toString());
+}
+
+TEST(ValueFormat, metadatumAppendsItsValue) {
+  Exifdatum md(ExifKey("Exif.Photo.ExposureTime"));
+  std::string s = "x";
+  md.appendTo(s);
+  ASSERT_EQ("x", s);
+
+  md.setValue("1/250");
+  md.appendTo(s);
+  ASSERT_EQ("x1/250", s);
+}
@@ -77,3 +77,32 @@ TEST_F(AXmpKey, throwsWithNotRegisteredPrefix) {
 TEST_F(AXmpKey, throwsWithBadFormedKey) {
   ASSERT_THROW(XmpKey key(expectedProperty), std::exception);  // It should have the format ns.prefix.key
 }
+
+TEST(XmpProperties, findsBuiltinNamespacesAndProperties) {
+  ASSERT_EQ("http://purl.org/dc/elements/1.1/", XmpProperties::ns("dc"));
+  ASSERT_EQ("dc", XmpProperties::prefix("http://purl.org/dc/elements/1.1/"));
+  ASSERT_EQ("dc", XmpProperties::prefix("http://purl.org/dc/elements/1.1"));
+  ASSERT_TRUE(XmpProperties::prefix("http://unknown.org/ns/").empty());
+
+  const XmpPropertyInfo* pi = XmpProperties::propertyInfo(XmpKey("Xmp.dc.subject"));
+  ASSERT_NE(nullptr, pi);
+  ASSERT_STREQ("subject", pi->name_);
+  ASSERT_EQ(xmpBag, XmpProperties::propertyType(XmpKey("Xmp.dc.subject")));
+  ASSERT_EQ(nullptr, XmpProperties::propertyInfo(XmpKey("Xmp.dc.noSuchProperty")));
+  ASSERT_EQ(xmpText, XmpProperties::propertyType(XmpKey("Xmp.dc.noSuchProperty")));
+}
+
+TEST(XmpProperties, findsInnermostElementOfNestedProperty) {
+  const XmpPropertyInfo* pi = XmpProperties::propertyInfo(XmpKey("Xmp.MP.RegionInfo/MPRI:Regions"));
+  ASSERT_NE(nullptr, pi);
+  ASSERT_STREQ("Regions", pi->name_);
+}
+
+TEST(XmpProperties, registeredNamespaceOverridesBuiltinPrefix) {
+  XmpProperties::registerNs("http://example.org/dc/", "dc");
+  ASSERT_EQ("http://example.org/dc/", XmpProperties::ns("dc"));
+  ASSERT_EQ(nullptr, XmpProperties::propertyInfo(XmpKey("Xmp.dc.subject")));
+  XmpProperties::unregisterNs("http://example.org/dc/");
+  ASSERT_EQ("http://purl.org/dc/elements/1.1/", XmpProperties::ns("dc"));
+  ASSERT_NE(nullptr, XmpProperties::propertyInfo(XmpKey("Xmp.dc.subject")));
+}
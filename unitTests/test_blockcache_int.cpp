@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "blockcache_int.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+using namespace Exiv2;
+using namespace Exiv2::Internal;
+namespace fs = std::filesystem;
+
+namespace {
+class BlockCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    dir_ = (fs::temp_directory_path() / ("exiv2-blockcache-" + name)).string();
+    fs::remove_all(dir_);
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir_);
+  }
+
+  //! Return the number of versions in the cache directory
+  [[nodiscard]] size_t versions() const {
+    size_t count = 0;
+    for (auto&& entry : fs::directory_iterator(dir_))
+      count += entry.path().extension() == ".map";
+    return count;
+  }
+
+  std::string dir_;
+  const std::vector<byte> block_ = std::vector<byte>(1024, 0xab);
+};
+}  // namespace
+
+TEST_F(BlockCacheTest, storesAndReadsBlocks) {
+  BlockCache cache(dir_, 1 << 20, "http://host/a.jpg", "\"v1\"", 2500, 1024);
+  ASSERT_TRUE(cache.isOpen());
+  ASSERT_FALSE(cache.has(0));
+  ASSERT_TRUE(cache.get(0).empty());
+
+  cache.put(1, block_.data(), block_.size());
+  ASSERT_TRUE(cache.has(1));
+  ASSERT_FALSE(cache.has(0));
+  DataBuf buf = cache.get(1);
+  ASSERT_EQ(block_.size(), buf.size());
+  ASSERT_EQ(0, buf.cmpBytes(0, block_.data(), block_.size()));
+
+  // the last block is shorter, blocks of the wrong size and past the end are ignored
+  cache.put(2, block_.data(), 100);
+  ASSERT_FALSE(cache.has(2));
+  cache.put(2, block_.data(), 452);
+  ASSERT_EQ(452u, cache.get(2).size());
+  cache.put(3, block_.data(), 452);
+  ASSERT_FALSE(cache.has(3));
+}
+
+TEST_F(BlockCacheTest, sharesBlocksOfTheSameVersion) {
+  {
+    BlockCache cache(dir_, 1 << 20, "http://host/a.jpg", "\"v1\"", 4096, 1024);
+    cache.put(2, block_.data(), block_.size());
+  }
+  BlockCache same(dir_, 1 << 20, "http://host/a.jpg", "\"v1\"", 4096, 1024);
+  ASSERT_TRUE(same.has(2));
+  BlockCache changed(dir_, 1 << 20, "http://host/a.jpg", "\"v2\"", 4096, 1024);
+  ASSERT_FALSE(changed.has(2));
+  BlockCache other(dir_, 1 << 20, "http://host/b.jpg", "\"v1\"", 4096, 1024);
+  ASSERT_FALSE(other.has(2));
+  BlockCache blocks(dir_, 1 << 20, "http://host/a.jpg", "\"v1\"", 4096, 2048);
+  ASSERT_FALSE(blocks.has(1));
+}
+
+TEST_F(BlockCacheTest, needsAValidator) {
+  BlockCache cache(dir_, 1 << 20, "http://host/a.jpg", "", 4096, 1024);
+  ASSERT_FALSE(cache.isOpen());
+  cache.put(0, block_.data(), block_.size());
+  ASSERT_FALSE(cache.has(0));
+}
+
+TEST_F(BlockCacheTest, evictsLeastRecentlyUsedVersions) {
+  const std::string urls[] = {"http://host/0", "http://host/1", "http://host/2", "http://host/3"};
+  auto fill = [&](const std::string& url) {
+    BlockCache cache(dir_, 1 << 30, url, "v", 64 * 1024, 1024);
+    for (size_t i = 0; i < 64; ++i)
+      cache.put(i, block_.data(), block_.size());
+  };
+  for (auto&& url : urls)
+    fill(url);
+  ASSERT_EQ(4u, versions());
+
+  // age all versions, then use them again in the order 2, 3, 0 so that 1 is the least recently used
+  for (auto&& entry : fs::directory_iterator(dir_)) {
+    if (entry.path().extension() == ".map")
+      fs::last_write_time(entry.path(), fs::file_time_type::clock::now() - std::chrono::hours(1));
+  }
+  BlockCache(dir_, 1 << 30, urls[2], "v", 64 * 1024, 1024);
+  BlockCache(dir_, 1 << 30, urls[3], "v", 64 * 1024, 1024);
+
+  {
+    // version 0 is in use and never evicted, although 2 and 3 were used before it
+    BlockCache inUse(dir_, 1 << 30, urls[0], "v", 64 * 1024, 1024);
+    BlockCache cache(dir_, 150 * 1024, "http://host/4", "v", 64 * 1024, 1024);
+    for (size_t i = 0; i < 64; ++i)
+      cache.put(i, block_.data(), block_.size());
+  }
+  ASSERT_EQ(2u, versions());
+  ASSERT_TRUE(BlockCache(dir_, 1 << 30, urls[0], "v", 64 * 1024, 1024).has(63));
+  ASSERT_TRUE(BlockCache(dir_, 1 << 30, "http://host/4", "v", 64 * 1024, 1024).has(63));
+}
+
+TEST_F(BlockCacheTest, trimEmptiesTheMapOfARemovedVersion) {
+  BlockCache(dir_, 1 << 30, "http://host/a.jpg", "v", 64 * 1024, 1024).put(0, block_.data(), block_.size());
+  fs::path map;
+  for (auto&& entry : fs::directory_iterator(dir_)) {
+    if (entry.path().extension() == ".map")
+      map = entry.path();
+  }
+  // a process which opened the map but has not locked it yet
+  std::ifstream opened(map, std::ios::binary);
+  ASSERT_TRUE(opened.is_open());
+
+  BlockCache cache(dir_, 0, "http://host/b.jpg", "v", 64 * 1024, 1024);
+  cache.trim();
+  ASSERT_FALSE(fs::exists(map));
+  ASSERT_EQ(std::ifstream::traits_type::eof(), opened.get());
+
+  // blocks put later into the same version are read from its new files
+  BlockCache again(dir_, 1 << 30, "http://host/a.jpg", "v", 64 * 1024, 1024);
+  ASSERT_FALSE(again.has(0));
+  again.put(0, block_.data(), block_.size());
+  ASSERT_EQ(0, again.get(0).cmpBytes(0, block_.data(), block_.size()));
+}
+
+TEST_F(BlockCacheTest, invalidateRemovesAllVersionsOfAUrl) {
+  BlockCache(dir_, 1 << 20, "http://host/a.jpg", "v1", 4096, 1024).put(0, block_.data(), block_.size());
+  BlockCache(dir_, 1 << 20, "http://host/a.jpg", "v2", 4096, 1024).put(0, block_.data(), block_.size());
+  BlockCache(dir_, 1 << 20, "http://host/b.jpg", "v1", 4096, 1024).put(0, block_.data(), block_.size());
+  ASSERT_EQ(3u, versions());
+  BlockCache::invalidate(dir_, "http://host/a.jpg");
+  ASSERT_EQ(1u, versions());
+  ASSERT_TRUE(BlockCache(dir_, 1 << 20, "http://host/b.jpg", "v1", 4096, 1024).has(0));
+}
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <exiv2/basicio.hpp>
+#include <exiv2/bmffimage.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/xmp_exiv2.hpp>
+
+#include "config.h"
+
+#include <sstream>
+
+using namespace Exiv2;
+
+#ifdef EXV_ENABLE_BMFF
+namespace {
+void appendUint16(Blob& blob, uint16_t value) {
+  blob.push_back(static_cast<byte>(value >> 8));
+  blob.push_back(static_cast<byte>(value));
+}
+
+void appendUint32(Blob& blob, uint32_t value) {
+  appendUint16(blob, static_cast<uint16_t>(value >> 16));
+  appendUint16(blob, static_cast<uint16_t>(value));
+}
+
+//! Return a box of type \em type with \em payload, prefixed by the version/flags field if \em version is not negative
+Blob box(const char* type, const Blob& payload, int version = -1) {
+  Blob blob;
+  appendUint32(blob, static_cast<uint32_t>(8 + (version < 0 ? 0 : 4) + payload.size()));
+  blob.insert(blob.end(), type, type + 4);
+  if (version >= 0)
+    appendUint32(blob, static_cast<uint32_t>(version) << 24);
+  blob.insert(blob.end(), payload.begin(), payload.end());
+  return blob;
+}
+
+Blob operator+(Blob lhs, const Blob& rhs) {
+  lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+  return lhs;
+}
+
+Blob infe(uint16_t id, const std::string& name) {
+  Blob payload;
+  appendUint32(payload, 0x02000000);  // version/flags
+  appendUint16(payload, id);
+  appendUint16(payload, 0);  // protection
+  payload.insert(payload.end(), name.begin(), name.end());
+  payload.push_back(0);
+  return box("infe", payload);
+}
+
+//! A Canon preview box: version, dimensions and size of the image at the offsets parseCr3Preview() expects
+Blob preview(const char* type, int version, uint16_t width, uint16_t height, size_t size) {
+  Blob payload;
+  if (version == 1)
+    appendUint16(payload, 0);
+  appendUint16(payload, width);
+  appendUint16(payload, height);
+  if (version == 0)
+    appendUint32(payload, static_cast<uint32_t>(size));
+  else
+    appendUint16(payload, 0);
+  if (version == 1)
+    appendUint32(payload, static_cast<uint32_t>(size));
+  payload.resize(12 + size, 0xff);
+  return box(type, payload, version);
+}
+
+/*!
+  @brief Return a BMFF file with a meta box which locates an Exif and an XMP item
+         in the mdat box, and Canon thumbnail and preview boxes. All
+         boxes which payloadToRead() reads only partially are larger than the
+         part which is read.
+ */
+Blob syntheticBmff(const Blob& exif, const std::string& xmp) {
+  Blob ftyp;
+  appendUint32(ftyp, 0x68656963);  // "heic"
+  appendUint32(ftyp, 0);
+  const Blob iinfItems = infe(1, "hvc1") + infe(7, "Exif") + infe(9, "mime");
+  Blob iinfPayload;
+  appendUint16(iinfPayload, 3);
+  const Blob iinf = box("iinf", iinfPayload + iinfItems, 0);
+
+  // iloc: offset and length sizes of 4 bytes, 14 bytes per item
+  const uint32_t ilocLength = 16 + 2 * 14;
+  const size_t metaLength = 12 + iinf.size() + ilocLength;
+  const Blob thmb = preview("THMB", 0, 160, 120, 40);
+  const Blob prvw = preview("PRVW", 1, 1620, 1080, 64);
+  const size_t exifStart = 8 + ftyp.size() + metaLength + thmb.size() + prvw.size() + 8;
+  Blob ilocPayload{0x44, 0};
+  appendUint16(ilocPayload, 2);
+  for (auto [id, start, length] : {std::tuple<uint16_t, size_t, size_t>{7, exifStart, exif.size()},
+                                   {9, exifStart + exif.size(), xmp.size()}}) {
+    appendUint16(ilocPayload, id);
+    appendUint16(ilocPayload, 0);  // data reference index
+    appendUint16(ilocPayload, 1);  // extent count
+    appendUint32(ilocPayload, static_cast<uint32_t>(start));
+    appendUint32(ilocPayload, static_cast<uint32_t>(length));
+  }
+  const Blob iloc = box("iloc", ilocPayload, 0);
+
+  Blob mdat = exif;
+  mdat.insert(mdat.end(), xmp.begin(), xmp.end());
+  return box("ftyp", ftyp) + box("meta", iinf + iloc, 0) + thmb + prvw + box("mdat", mdat);
+}
+
+Blob tiff() {
+  ExifData exifData;
+  exifData["Exif.Image.Make"] = "Canon";
+  exifData["Exif.Image.Model"] = "EOS R5";
+  Blob blob;
+  ExifParser::encode(blob, bigEndian, exifData);
+  return blob;
+}
+
+const std::string xmpPacket =
+    "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\"><rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">"
+    "<rdf:Description rdf:about=\"\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\" dc:format=\"image/heic\"/>"
+    "</rdf:RDF></x:xmpmeta>";
+
+std::unique_ptr<BmffImage> openBmff(const Blob& file) {
+  enableBMFF(true);
+  return std::make_unique<BmffImage>(std::make_unique<MemIo>(file.data(), file.size()), false);
+}
+}  // namespace
+
+TEST(BmffImage, readMetadataFindsTheItemsOfNestedMetaBoxes) {
+  const Blob exif = tiff();
+  const Blob file = syntheticBmff(exif, xmpPacket);
+  auto image = openBmff(file);
+  image->readMetadata();
+
+  ASSERT_EQ("image/heic", image->mimeType());
+  ASSERT_EQ("Canon", image->exifData()["Exif.Image.Make"].toString());
+  ASSERT_EQ("EOS R5", image->exifData()["Exif.Image.Model"].toString());
+#ifdef EXV_HAVE_XMP_TOOLKIT
+  ASSERT_EQ("image/heic", image->xmpData()["Xmp.dc.format"].toString());
+#endif
+
+  const NativePreviewList& previews = image->nativePreviews();
+  ASSERT_EQ(2u, previews.size());
+  ASSERT_EQ(160u, previews[0].width_);
+  ASSERT_EQ(120u, previews[0].height_);
+  ASSERT_EQ(40u, previews[0].size_);
+  ASSERT_EQ("image/jpeg", previews[0].mimeType_);
+  ASSERT_EQ(1620u, previews[1].width_);
+  ASSERT_EQ(1080u, previews[1].height_);
+  ASSERT_EQ(64u, previews[1].size_);
+  ASSERT_EQ("application/octet-stream", previews[1].mimeType_);
+  // the images are at the end of their boxes, the preview box is followed by the header of the mdat box
+  const size_t mdatStart = file.size() - xmpPacket.size() - exif.size() - 8;
+  ASSERT_EQ(mdatStart - 64, previews[1].position_);
+  ASSERT_EQ(mdatStart - 64 - 24 - 40, previews[0].position_);
+}
+
+TEST(BmffImage, printStructureReportsTheExifAndXmpItems) {
+  const Blob exif = tiff();
+  const Blob file = syntheticBmff(exif, xmpPacket);
+  auto image = openBmff(file);
+  std::ostringstream out;
+  image->printStructure(out, kpsBasic, 0);
+
+  const std::string structure = out.str();
+  const size_t exifStart = file.size() - xmpPacket.size() - exif.size();
+  ASSERT_NE(std::string::npos, structure.find("ID =   7 Exif  *** Exif ***")) << structure;
+  ASSERT_NE(std::string::npos, structure.find("ID =   9 mime  *** XMP ***")) << structure;
+  ASSERT_NE(std::string::npos,
+            structure.find("Exiv2::BMFF Exif: ID = 7 from,length = " + std::to_string(exifStart) + "," +
+                           std::to_string(exif.size())))
+      << structure;
+  ASSERT_NE(std::string::npos, structure.find("Exiv2::BMFF XMP: ID = 9 from,length = " +
+                                              std::to_string(exifStart + exif.size()) + "," +
+                                              std::to_string(xmpPacket.size())))
+      << structure;
+  ASSERT_NE(std::string::npos, structure.find("width,height,size = 160,120,40")) << structure;
+  ASSERT_NE(std::string::npos, structure.find("width,height,size = 1620,1080,64")) << structure;
+}
+#endif
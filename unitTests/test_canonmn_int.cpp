@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "canonmn_int.hpp"
+#include "error.hpp"
+#include "exif.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <regex>
+
+using namespace Exiv2;
+using namespace Exiv2::Internal;
+
+namespace {
+// Reference for the lens lookup: parse the label of every entry of the lens type, as before the index
+std::string linearLensLookup(int64_t lensType, int exifFlMin, int exifFlMax, float exifAperMax) {
+  static const std::regex lens_regex(
+      ".*?"
+      "(?:([0-9]+)-)?([0-9]+)mm"
+      ".*?"
+      "(?:(?:f\\/)|T|F)(?:([0-9]+(?:\\.[0-9]+)?)-)?([0-9]+(?:\\.[0-9])?)"
+      "(?:.*?\\+.*?([0-9.]+)x)?");
+
+  std::string result;
+  for (size_t i = 0; i < canonCsLensTypeSize; ++i) {
+    const TagDetails& lens = canonCsLensType[i];
+    if (lens.val_ != lensType)
+      continue;
+    std::cmatch base_match;
+    if (!std::regex_search(lens.label_, base_match, lens_regex))
+      throw Error(ErrorCode::kerErrorMessage, std::string("Lens regex didn't match for: ") + lens.label_);
+    auto tc = base_match[5].length() > 0 ? std::stof(base_match[5].str()) : 1.f;
+    int flMax = static_cast<int>(std::stof(base_match[2].str()) * tc);
+    int flMin = base_match[1].length() > 0 ? static_cast<int>(std::stof(base_match[1].str()) * tc) : flMax;
+    auto aperMaxTele = std::stof(base_match[4].str()) * tc;
+    auto aperMaxShort = base_match[3].length() > 0 ? std::stof(base_match[3].str()) * tc : aperMaxTele;
+    const double tolerance = 0.1 * static_cast<double>(tc);
+    if (flMin != exifFlMin || flMax != exifFlMax ||
+        static_cast<double>(exifAperMax) < static_cast<double>(aperMaxShort) - tolerance ||
+        static_cast<double>(exifAperMax) > static_cast<double>(aperMaxTele) + tolerance) {
+      continue;
+    }
+    result += result.empty() ? lens.label_ : std::string(" *OR* ") + lens.label_;
+  }
+  return result.empty() ? "Unknown Lens (" + std::to_string(lensType) + ")" : result;
+}
+
+std::string printLens(int64_t lensType, int flMin, int flMax, int16_t aperture) {
+  ExifData metadata;
+  UShortValue lens;
+  lens.value_ = {static_cast<uint16_t>(flMax), static_cast<uint16_t>(flMin), 1};
+  metadata.add(ExifKey("Exif.CanonCs.Lens"), &lens);
+  metadata["Exif.CanonCs.MaxAperture"] = static_cast<uint16_t>(aperture);
+  UShortValue value;
+  value.value_.push_back(static_cast<uint16_t>(lensType));
+  std::ostringstream os;
+  CanonMakerNote::printCsLensType(os, value, &metadata);
+  return os.str();
+}
+
+// Inverse of fnumber(canonEv()) for positive values
+int16_t canonAperture(float fNumber) {
+  return static_cast<int16_t>(std::lround(64 * std::log2(fNumber)));
+}
+}  // namespace
+
+TEST(printCsLensType, findsTheSameLensesAsTheLinearSearch) {
+  size_t found = 0;
+  for (size_t i = 0; i < canonCsLensTypeSize; ++i) {
+    const TagDetails& entry = canonCsLensType[i];
+    if (entry.val_ == 0xffff)
+      continue;
+    const CanonLensRange lens = parseCanonLensLabel(entry.label_);
+    ASSERT_TRUE(lens.parsed_) << entry.label_;
+    for (float fNumber : {lens.aperMaxShort_, lens.aperMaxTele_, lens.aperMaxTele_ * 2}) {
+      const int16_t aperture = canonAperture(fNumber);
+      const float exifAperMax = fnumber(canonEv(aperture));
+      const std::string expected = linearLensLookup(entry.val_, lens.flMin_, lens.flMax_, exifAperMax);
+      ASSERT_EQ(expected, printLens(entry.val_, lens.flMin_, lens.flMax_, aperture)) << entry.label_;
+      found += expected.find(entry.label_) != std::string::npos;
+    }
+    ASSERT_EQ(linearLensLookup(entry.val_, lens.flMin_ + 1, lens.flMax_ + 1, lens.aperMaxTele_),
+              printLens(entry.val_, lens.flMin_ + 1, lens.flMax_ + 1, canonAperture(lens.aperMaxTele_)));
+  }
+  // the metadata of most lenses matches their own label
+  ASSERT_GT(found, canonCsLensTypeSize);
+}
+
+TEST(parseCanonLensLabel, extractsTheRangesFromTheLabel) {
+  CanonLensRange lens = parseCanonLensLabel("Canon EF 70-200mm f/2.8L IS USM + 1.4x");
+  ASSERT_TRUE(lens.parsed_);
+  ASSERT_EQ(98, lens.flMin_);
+  ASSERT_EQ(280, lens.flMax_);
+  ASSERT_FLOAT_EQ(3.92F, lens.aperMaxShort_);
+  ASSERT_FLOAT_EQ(3.92F, lens.aperMaxTele_);
+  ASSERT_FLOAT_EQ(1.4F, lens.tc_);
+
+  lens = parseCanonLensLabel("Sigma 18-50mm f/3.5-5.6 DC");
+  ASSERT_TRUE(lens.parsed_);
+  ASSERT_EQ(18, lens.flMin_);
+  ASSERT_EQ(50, lens.flMax_);
+  ASSERT_FLOAT_EQ(3.5F, lens.aperMaxShort_);
+  ASSERT_FLOAT_EQ(5.6F, lens.aperMaxTele_);
+}
+
+TEST(parseCanonLensLabel, doesNotParseInvalidLabels) {
+  // no focal length
+  ASSERT_FALSE(parseCanonLensLabel("Canon EF f/1.8").parsed_);
+  // the exceptions of std::stof() are passed on, as printCsLensType() did before the index
+  ASSERT_THROW(parseCanonLensLabel("Canon EF 50mm f/1.8 + .x"), std::invalid_argument);
+  ASSERT_THROW(parseCanonLensLabel(("Canon EF " + std::string(50, '9') + "mm f/1.8").c_str()), std::out_of_range);
+}
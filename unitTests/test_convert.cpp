@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <exiv2/convert.hpp>
+#include <exiv2/error.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/iptc.hpp>
+#include <exiv2/xmp_exiv2.hpp>
+
+#include "config.h"
+
+#include <random>
+
+#ifdef EXV_HAVE_ICONV
+#include <iconv.h>
+#endif
+
+using namespace Exiv2;
+
+namespace {
+std::string convert(std::string str, const char* from, const char* to, bool& ok) {
+  ok = convertStringCharset(str, from, to);
+  return str;
+}
+}  // namespace
+
+TEST(convertStringCharset, convertsLatin1ToUtf8) {
+  bool ok = false;
+  ASSERT_EQ("abc", convert("abc", "ISO-8859-1", "UTF-8", ok));
+  ASSERT_TRUE(ok);
+  ASSERT_EQ("Gr\xc3\xbc\xc3\x9f\x65 \xc3\xbf", convert("Gr\xfc\xdf\x65 \xff", "ISO-8859-1", "UTF-8", ok));
+  ASSERT_TRUE(ok);
+}
+
+TEST(convertStringCharset, convertsBetweenUcs2AndUtf8) {
+  bool ok = false;
+  const std::string utf8 = "A\xc3\xa9\xe2\x82\xac";  // A, e acute, euro sign
+  const std::string le("A\0\xe9\0\xac\x20", 6);
+  const std::string be("\0A\0\xe9\x20\xac", 6);
+  ASSERT_EQ(utf8, convert(le, "UCS-2LE", "UTF-8", ok));
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(utf8, convert(be, "UCS-2BE", "UTF-8", ok));
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(le, convert(utf8, "UTF-8", "UCS-2LE", ok));
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(be, convert(utf8, "UTF-8", "UCS-2BE", ok));
+  ASSERT_TRUE(ok);
+  ASSERT_EQ(be, convert(le, "UCS-2LE", "UCS-2BE", ok));
+  ASSERT_TRUE(ok);
+}
+
+#ifdef EXV_HAVE_ICONV
+namespace {
+// Reference conversion with a fresh iconv descriptor, as convertStringCharset() used to do it
+bool iconvConvert(std::string& str, const char* from, const char* to) {
+  iconv_t cd = iconv_open(to, from);
+  if (cd == reinterpret_cast<iconv_t>(-1))
+    return false;
+  std::string out;
+  auto inptr = const_cast<char*>(str.c_str());
+  size_t inbytesleft = str.length();
+  bool ok = true;
+  while (inbytesleft) {
+    char outbuf[256];
+    char* outptr = outbuf;
+    size_t outbytesleft = sizeof(outbuf);
+    size_t rc = iconv(cd, &inptr, &inbytesleft, &outptr, &outbytesleft);
+    if (rc == static_cast<size_t>(-1) && errno != E2BIG) {
+      ok = false;
+      break;
+    }
+    out.append(outbuf, sizeof(outbuf) - outbytesleft);
+  }
+  iconv_close(cd);
+  if (ok)
+    str = out;
+  return ok;
+}
+}  // namespace
+
+TEST(convertStringCharset, matchesIconv) {
+  LogMsg::Level level = LogMsg::level();
+  LogMsg::setLevel(LogMsg::mute);
+
+  const std::pair<const char*, const char*> conversions[] = {
+      {"ISO-8859-1", "UTF-8"}, {"ASCII", "UTF-8"},     {"UCS-2LE", "UTF-8"},   {"UCS-2BE", "UTF-8"},
+      {"UTF-8", "UCS-2LE"},    {"UTF-8", "UCS-2BE"},   {"UCS-2LE", "UCS-2BE"}, {"UCS-2BE", "UCS-2LE"},
+      {"UTF-8", "ISO-8859-1"}, {"UCS-2LE", "UTF-16LE"}};
+  // Bytes that make up valid and invalid UTF-8 and UCS-2 sequences, including surrogates
+  const char alphabet[] = "aZ\0\x7f\x80\xbf\xc0\xc2\xc3\xdf\xe0\xe2\xed\xef\xf0\xf4\xff\xd8\xdc\xa0\x9f";
+
+  std::mt19937 rng(4711);
+  std::uniform_int_distribution<size_t> len(0, 12);
+  std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 2);
+  for (int i = 0; i < 20000; ++i) {
+    std::string input;
+    for (size_t n = len(rng); n > 0; --n)
+      input += alphabet[pick(rng)];
+    for (auto&& [from, to] : conversions) {
+      std::string expected = input;
+      const bool expectedOk = iconvConvert(expected, from, to);
+      bool ok = false;
+      const std::string actual = convert(input, from, to, ok);
+      ASSERT_EQ(expectedOk, ok) << from << " -> " << to;
+      ASSERT_EQ(expected, actual) << from << " -> " << to;
+    }
+  }
+
+  LogMsg::setLevel(level);
+}
+#endif
+
+#ifdef EXV_HAVE_XMP_TOOLKIT
+namespace {
+// Exif data with tags for most kinds of conversion: values, dates, versions, arrays, comments, flash and GPS
+ExifData conversionFixture() {
+  ExifData exif;
+  exif["Exif.Image.Orientation"] = uint16_t(6);
+  exif["Exif.Image.XResolution"] = URational(72, 1);
+  exif["Exif.Image.DateTime"] = "2004:09:19 12:25:20";
+  exif["Exif.Image.Make"] = "Canon";
+  exif["Exif.Image.Model"] = "EOS 300D";
+  exif["Exif.Image.Artist"] = "Jane Doe";
+  exif["Exif.Photo.ExifVersion"].setValue("48 50 50 49");
+  exif["Exif.Photo.ComponentsConfiguration"].setValue("1 2 3 0");
+  exif["Exif.Photo.UserComment"] = "charset=Ascii A comment";
+  exif["Exif.Photo.DateTimeOriginal"] = "2004:09:19 12:25:20";
+  exif["Exif.Photo.ExposureTime"] = URational(1, 500);
+  exif["Exif.Photo.FNumber"] = URational(90, 10);
+  exif["Exif.Photo.ISOSpeedRatings"] = uint16_t(100);
+  exif["Exif.Photo.Flash"] = uint16_t(0x19);
+  exif["Exif.Photo.FocalLength"] = URational(50, 1);
+  // not in the conversion table
+  exif["Exif.Photo.LensModel"] = "EF 50mm";
+  exif["Exif.GPSInfo.GPSVersionID"].setValue("2 2 0 0");
+  exif["Exif.GPSInfo.GPSLatitudeRef"] = "N";
+  exif["Exif.GPSInfo.GPSLatitude"].setValue("51/1 10/1 4470/100");
+  exif["Exif.GPSInfo.GPSLongitudeRef"] = "W";
+  exif["Exif.GPSInfo.GPSLongitude"].setValue("1/1 49/1 3375/100");
+  return exif;
+}
+
+template <typename Data>
+std::vector<std::string> listMetadata(const Data& data) {
+  std::vector<std::string> list;
+  for (auto&& md : data)
+    list.push_back(md.key() + " " + md.typeName() + " " + md.toString());
+  return list;
+}
+}  // namespace
+
+TEST(copyExifToXmp, convertsTheTagsOfTheConversionTable) {
+  XmpData xmp;
+  copyExifToXmp(conversionFixture(), xmp);
+  const std::vector<std::string> expected = {
+      "Xmp.tiff.Orientation XmpText 6",
+      "Xmp.tiff.XResolution XmpText 72/1",
+      "Xmp.xmp.ModifyDate XmpText 2004-09-19T12:25:20",
+      "Xmp.tiff.Make XmpText Canon",
+      "Xmp.tiff.Model XmpText EOS 300D",
+      "Xmp.dc.creator XmpSeq Jane Doe",
+      "Xmp.exif.ExifVersion XmpText 0221",
+      "Xmp.exif.ComponentsConfiguration XmpSeq 1, 2, 3, 0",
+      "Xmp.exif.UserComment LangAlt lang=\"x-default\" A comment",
+      "Xmp.photoshop.DateCreated XmpText 2004-09-19T12:25:20",
+      "Xmp.exif.ExposureTime XmpText 1/500",
+      "Xmp.exif.FNumber XmpText 90/10",
+      "Xmp.exif.ISOSpeedRatings XmpSeq 100",
+      "Xmp.exif.Flash/exif:Fired XmpText True",
+      "Xmp.exif.Flash/exif:Return XmpText 0",
+      "Xmp.exif.Flash/exif:Mode XmpText 3",
+      "Xmp.exif.Flash/exif:Function XmpText False",
+      "Xmp.exif.Flash/exif:RedEyeMode XmpText False",
+      "Xmp.exif.FocalLength XmpText 50/1",
+      "Xmp.exif.GPSVersionID XmpText 2.2.0.0",
+      "Xmp.exif.GPSLatitude XmpText 51,10.7450000N",
+      "Xmp.exif.GPSLongitude XmpText 1,49.5625000W",
+  };
+  ASSERT_EQ(expected, listMetadata(xmp));
+}
+
+TEST(copyXmpToExif, convertsBackTheTagsOfTheConversionTable) {
+  const ExifData exif = conversionFixture();
+  XmpData xmp;
+  copyExifToXmp(exif, xmp);
+  ExifData back;
+  copyXmpToExif(xmp, back);
+  for (auto&& md : exif) {
+    auto pos = back.findKey(ExifKey(md.key()));
+    if (md.key() == "Exif.Photo.LensModel") {
+      ASSERT_EQ(back.end(), pos);
+    } else if (md.key() == "Exif.Photo.UserComment") {
+      ASSERT_EQ("charset=Unicode A comment", pos->toString());
+    } else if (md.key() == "Exif.GPSInfo.GPSLatitude") {
+      ASSERT_EQ("51/1 10/1 44700001/1000000", pos->toString());
+    } else if (md.key() == "Exif.GPSInfo.GPSLongitude") {
+      ASSERT_EQ("1/1 49/1 135/4", pos->toString());
+    } else {
+      ASSERT_NE(back.end(), pos) << md.key();
+      ASSERT_EQ(md.typeId(), pos->typeId()) << md.key();
+      ASSERT_EQ(md.toString(), pos->toString()) << md.key();
+    }
+  }
+  ASSERT_EQ(exif.count() - 1, back.count());
+}
+
+TEST(copyXmpToExif, erasesCommentsAndArraysWithoutXmpSource) {
+  // cnvXmpComment and cnvXmpArray prepare their target even if the XMP property doesn't exist
+  ExifData exif = conversionFixture();
+  copyXmpToExif(XmpData(), exif);
+  ASSERT_EQ(conversionFixture().count() - 2, exif.count());
+  ASSERT_EQ(exif.end(), exif.findKey(ExifKey("Exif.Photo.UserComment")));
+  ASSERT_EQ(exif.end(), exif.findKey(ExifKey("Exif.Photo.ComponentsConfiguration")));
+}
+
+TEST(copyXmpToExif, convertsStructFieldsOfTheFlash) {
+  XmpData xmp;
+  xmp["Xmp.exif.Flash/exif:Fired"] = "True";
+  xmp["Xmp.exif.Flash/exif:Return"] = "0";
+  xmp["Xmp.exif.Flash/exif:Mode"] = "1";
+  xmp["Xmp.exif.Flash/exif:Function"] = "False";
+  xmp["Xmp.exif.Flash/exif:RedEyeMode"] = "False";
+  ExifData exif;
+  copyXmpToExif(xmp, exif);
+  ASSERT_EQ(std::vector<std::string>{"Exif.Photo.Flash Short 9"}, listMetadata(exif));
+}
+
+TEST(copyIptcToXmp, convertsRepeatedDatasetsAndBack) {
+  IptcData iptc;
+  iptc["Iptc.Application2.Caption"] = "A caption";
+  iptc["Iptc.Application2.City"] = "Berlin";
+  StringValue sky("sky");
+  StringValue sea("sea");
+  iptc.add(IptcKey("Iptc.Application2.Keywords"), &sky);
+  iptc.add(IptcKey("Iptc.Application2.Keywords"), &sea);
+
+  XmpData xmp;
+  copyIptcToXmp(iptc, xmp);
+  const std::vector<std::string> expectedXmp = {
+      "Xmp.dc.subject XmpBag sky, sea",
+      "Xmp.photoshop.City XmpText Berlin",
+      "Xmp.dc.description LangAlt lang=\"x-default\" A caption",
+  };
+  ASSERT_EQ(expectedXmp, listMetadata(xmp));
+
+  IptcData back;
+  copyXmpToIptc(xmp, back);
+  const std::vector<std::string> expectedIptc = {
+      "Iptc.Application2.Keywords String sky",
+      "Iptc.Application2.Keywords String sea",
+      "Iptc.Envelope.CharacterSet String \x1b%G",
+      "Iptc.Application2.City String Berlin",
+      "Iptc.Application2.Caption String A caption",
+  };
+  ASSERT_EQ(expectedIptc, listMetadata(back));
+}
+#endif
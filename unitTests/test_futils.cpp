@@ -43,6 +43,8 @@ TEST(strError, doNotRecognizeUnknownError) {
 TEST(getEnv, getsDefaultValueWhenExpectedEnvVariableDoesNotExist) {
   ASSERT_STREQ("/exiv2.php", getEnv(envHTTPPOST).c_str());
   ASSERT_STREQ("40", getEnv(envTIMEOUT).c_str());
+  ASSERT_STREQ("", getEnv(envCACHEDIR).c_str());
+  ASSERT_STREQ("256", getEnv(envCACHESIZE).c_str());
 }
 
 TEST(getEnv, getsProperValuesWhenExpectedEnvVariableExists) {
@@ -61,7 +63,7 @@ TEST(getEnv, getsProperValuesWhenExpectedEnvVariableExists) {
 }
 
 TEST(getEnv, throwsWhenKeyDoesNotExist) {
-  ASSERT_THROW(getEnv(static_cast<EnVar>(3)), std::out_of_range);
+  ASSERT_THROW(getEnv(static_cast<EnVar>(4)), std::out_of_range);
 }
 
 TEST(urlencode, encodesGivenUrl) {
@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <exiv2/basicio.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/http.hpp>
+#include <exiv2/image.hpp>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+using namespace Exiv2;
+
+namespace {
+/// Stand-in HTTP/1.1 server on 127.0.0.1 which serves one resource, "/file"
+class StandInServer {
+ public:
+  struct Options {
+    bool ranges = true;      //!< honour Range headers
+    bool chunked = false;    //!< send bodies with chunked transfer encoding
+    bool announce = true;    //!< send "Connection: close" before closing a connection
+    size_t maxRequests = 0;  //!< requests answered per connection, 0 for no limit
+    std::string etag;        //!< ETag of the resource, none if empty
+  };
+
+  explicit StandInServer(std::string content, Options options) : content_(std::move(content)), options_(options) {
+    listener_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(listener_, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(listener_, 8) != 0 ||
+        getsockname(listener_, reinterpret_cast<sockaddr*>(&addr), &len) != 0)
+      throw std::runtime_error("unable to listen");
+    port_ = std::to_string(ntohs(addr.sin_port));
+    thread_ = std::thread([this] { run(); });
+  }
+
+  explicit StandInServer(std::string content) : StandInServer(std::move(content), Options()) {
+  }
+
+  ~StandInServer() {
+    stop_ = true;
+    thread_.join();
+    close(listener_);
+  }
+
+  StandInServer(const StandInServer&) = delete;
+  StandInServer& operator=(const StandInServer&) = delete;
+
+  [[nodiscard]] const std::string& port() const {
+    return port_;
+  }
+  [[nodiscard]] size_t connections() const {
+    return connections_;
+  }
+  [[nodiscard]] size_t requests() const {
+    return requests_;
+  }
+
+ private:
+  bool wait(int fd) const {
+    pollfd pfd = {fd, POLLIN, 0};
+    while (!stop_) {
+      if (poll(&pfd, 1, 20) > 0)
+        return true;
+    }
+    return false;
+  }
+
+  void run() {
+    while (wait(listener_)) {
+      int fd = accept(listener_, nullptr, nullptr);
+      if (fd < 0)
+        continue;
+      ++connections_;
+      serve(fd);
+      close(fd);
+    }
+  }
+
+  void serve(int fd) {
+    std::string in;
+    size_t answered = 0;
+    char buffer[4096];
+    while (wait(fd)) {
+      ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+      if (n <= 0)
+        return;
+      in.append(buffer, n);
+      size_t end = 0;
+      while ((end = in.find("\r\n\r\n")) != std::string::npos) {
+        const std::string request = in.substr(0, end);
+        in.erase(0, end + 4);
+        ++requests_;
+        const bool last = options_.maxRequests && ++answered == options_.maxRequests;
+        respond(fd, request, last && options_.announce);
+        if (last) {
+          // lingering close: closing with unread requests would reset the connection and lose the responses
+          shutdown(fd, SHUT_WR);
+          while (wait(fd) && recv(fd, buffer, sizeof(buffer), 0) > 0) {
+          }
+          return;
+        }
+      }
+    }
+  }
+
+  void respond(int fd, const std::string& request, bool closing) {
+    const bool head = request.compare(0, 5, "HEAD ") == 0;
+    const size_t path = request.find(' ') + 1;
+    const bool found = request.compare(path, 6, "/file ") == 0;
+
+    std::string status = found ? "200 OK" : "404 Not Found";
+    std::string headers;
+    std::string body = found ? content_ : "";
+    size_t range = request.find("\r\nRange: bytes=");
+    if (found && options_.ranges && range != std::string::npos) {
+      size_t first = std::stoul(request.substr(range + 15));
+      size_t last = std::stoul(request.substr(request.find('-', range + 15) + 1));
+      last = std::min(last, content_.size() - 1);
+      status = "206 Partial Content";
+      headers += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+                 std::to_string(content_.size()) + "\r\n";
+      body = content_.substr(first, last - first + 1);
+    }
+    if (found && !options_.etag.empty())
+      headers += "ETag: " + options_.etag + "\r\n";
+    if (closing)
+      headers += "Connection: close\r\n";
+
+    std::string out = "HTTP/1.1 " + status + "\r\n" + headers;
+    if (options_.chunked && !head) {
+      out += "Transfer-Encoding: chunked\r\n\r\n";
+      for (size_t i = 0; i < body.size(); i += 7) {
+        const std::string chunk = body.substr(i, 7);
+        char size[16];
+        snprintf(size, sizeof(size), "%zx;ext=1\r\n", chunk.size());
+        out += size + chunk + "\r\n";
+      }
+      out += "0\r\nX-Trailer: 1\r\n\r\n";
+    } else {
+      out += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+      if (!head)
+        out += body;
+    }
+    for (size_t sent = 0; sent < out.size();) {
+      ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+      if (n <= 0)
+        return;
+      sent += n;
+    }
+  }
+
+  std::string content_;
+  Options options_;
+  int listener_;
+  std::string port_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  std::atomic<size_t> connections_{0};
+  std::atomic<size_t> requests_{0};
+};
+
+std::string makeContent(size_t size) {
+  std::string content;
+  for (size_t i = 0; i < size; ++i)
+    content += static_cast<char>('a' + (i * 7 + i / 26) % 26);
+  return content;
+}
+
+std::string readTestFile(const std::string& name) {
+  DataBuf buf = readFile(std::string(TESTDATA_PATH) + "/" + name);
+  return {buf.c_str(), buf.size()};
+}
+
+void expectSameExif(const std::string& name, const std::string& url) {
+  auto local = ImageFactory::open(std::string(TESTDATA_PATH) + "/" + name);
+  local->readMetadata();
+  auto remote = ImageFactory::open(std::make_unique<HttpIo>(url));
+  remote->readMetadata();
+  ASSERT_FALSE(local->exifData().empty());
+  ASSERT_EQ(local->exifData().count(), remote->exifData().count());
+  auto pos = remote->exifData().begin();
+  for (auto&& md : local->exifData()) {
+    EXPECT_EQ(md.key(), pos->key());
+    EXPECT_EQ(md.toString(), pos->toString()) << md.key();
+    ++pos;
+  }
+}
+
+const std::vector<HttpClient::Range> ranges = {{0, 99}, {5000, 5099}, {9990, 9999}, {100, 100}, {4096, 8191}};
+
+void expectRanges(const std::string& content, const std::vector<std::string>& bodies) {
+  ASSERT_EQ(ranges.size(), bodies.size());
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    EXPECT_EQ(content.substr(ranges[i].first, ranges[i].second - ranges[i].first + 1), bodies[i]) << "range " << i;
+  }
+}
+}  // namespace
+
+TEST(HttpClient, pipelinesRangesOnOneConnection) {
+  const std::string content = makeContent(10000);
+  StandInServer server(content);
+  HttpClient client("127.0.0.1", server.port());
+  std::vector<std::string> bodies;
+  std::string errors;
+  ASSERT_EQ(206, client.get("/file", ranges, bodies, errors));
+  ASSERT_TRUE(errors.empty());
+  expectRanges(content, bodies);
+  ASSERT_EQ(1u, client.connections());
+  ASSERT_EQ(ranges.size(), server.requests());
+}
+
+TEST(HttpClient, keepsConnectionBetweenRequests) {
+  const std::string content = makeContent(10000);
+  StandInServer server(content);
+  HttpClient client("127.0.0.1", server.port());
+  Dictionary response;
+  std::string errors;
+  ASSERT_EQ(200, client.request("HEAD", "/file", response, errors));
+  ASSERT_EQ("HTTP/1.1 200 OK", response[""]);
+  ASSERT_EQ("10000", response["Content-Length"]);
+  ASSERT_TRUE(response["body"].empty());
+
+  ASSERT_EQ(200, client.request("GET", "/file", response, errors));
+  ASSERT_EQ(content, response["body"]);
+
+  std::vector<std::string> bodies;
+  ASSERT_EQ(206, client.get("/file", ranges, bodies, errors));
+  expectRanges(content, bodies);
+  ASSERT_EQ(1u, client.connections());
+}
+
+TEST(HttpClient, reconnectsWhenServerClosesConnection) {
+  const std::string content = makeContent(10000);
+  StandInServer::Options options;
+  options.maxRequests = 1;
+  StandInServer server(content, options);
+  HttpClient client("127.0.0.1", server.port());
+  std::vector<std::string> bodies;
+  std::string errors;
+  ASSERT_EQ(206, client.get("/file", ranges, bodies, errors));
+  ASSERT_TRUE(errors.empty());
+  expectRanges(content, bodies);
+  ASSERT_EQ(ranges.size(), client.connections());
+}
+
+TEST(HttpClient, retriesRequestsWhenServerDropsConnection) {
+  const std::string content = makeContent(10000);
+  StandInServer::Options options;
+  options.maxRequests = 2;
+  options.announce = false;
+  StandInServer server(content, options);
+  HttpClient client("127.0.0.1", server.port());
+  std::vector<std::string> bodies;
+  std::string errors;
+  ASSERT_EQ(206, client.get("/file", ranges, bodies, errors));
+  ASSERT_TRUE(errors.empty());
+  expectRanges(content, bodies);
+  ASSERT_EQ(3u, client.connections());
+}
+
+TEST(HttpClient, readsChunkedResponses) {
+  const std::string content = makeContent(1000);
+  StandInServer::Options options;
+  options.chunked = true;
+  StandInServer server(content, options);
+  HttpClient client("127.0.0.1", server.port());
+  Dictionary response;
+  std::string errors;
+  ASSERT_EQ(200, client.request("GET", "/file", response, errors));
+  ASSERT_EQ(content, response["body"]);
+
+  std::vector<std::string> bodies;
+  ASSERT_EQ(206, client.get("/file", {{10, 20}, {900, 999}}, bodies, errors));
+  ASSERT_EQ(2u, bodies.size());
+  ASSERT_EQ(content.substr(10, 11), bodies[0]);
+  ASSERT_EQ(content.substr(900), bodies[1]);
+  ASSERT_EQ(1u, client.connections());
+}
+
+TEST(HttpClient, returnsWholeResourceWhenRangesAreIgnored) {
+  const std::string content = makeContent(10000);
+  StandInServer::Options options;
+  options.ranges = false;
+  StandInServer server(content, options);
+  HttpClient client("127.0.0.1", server.port());
+  std::vector<std::string> bodies;
+  std::string errors;
+  ASSERT_EQ(200, client.get("/file", {{10, 20}, {900, 999}}, bodies, errors));
+  ASSERT_EQ(std::vector<std::string>(2, content), bodies);
+}
+
+TEST(HttpIo, readsJpegMetadataWithOneRangeRequest) {
+  // image data after the metadata is never fetched
+  StandInServer server(readTestFile("exiv2-canon-powershot-s40.jpg") + std::string(500000, '\0'));
+  expectSameExif("exiv2-canon-powershot-s40.jpg", "http://127.0.0.1:" + server.port() + "/file");
+  ASSERT_EQ(3u, server.requests());  // HEAD and the GETs for the head and the tail, sent together
+}
+
+TEST(HttpIo, fetchesAllMissingBlocksForMmap) {
+  StandInServer server(readTestFile("Reagan.tiff"));
+  expectSameExif("Reagan.tiff", "http://127.0.0.1:" + server.port() + "/file");
+  ASSERT_EQ(2u, server.requests());  // HEAD and GET, the read-ahead and the tail cover the whole file
+}
+
+TEST(HttpIo, growsReadAheadForSequentialReads) {
+  const std::string content = makeContent(2000000);
+  StandInServer server(content);
+  HttpIo io("http://127.0.0.1:" + server.port() + "/file");
+  ASSERT_EQ(0, io.open());
+  std::vector<byte> buf(50000);
+  std::string read;
+  while (size_t n = io.read(buf.data(), buf.size()))
+    read.append(reinterpret_cast<const char*>(buf.data()), n);
+  ASSERT_EQ(content, read);
+  // HEAD and GET requests for 64 KB with the last 64 KB, 128 KB, 256 KB, 512 KB and the remaining 1 MB
+  ASSERT_EQ(7u, server.requests());
+}
+
+TEST(HttpIo, fetchesTheTailWithTheFirstRead) {
+  const std::string content = makeContent(1000000);
+  StandInServer server(content);
+  HttpIo io("http://127.0.0.1:" + server.port() + "/file");
+  ASSERT_EQ(0, io.open());
+  byte buf[100];
+  for (int64_t offset : {0, 999900, 940000, 10000}) {
+    ASSERT_EQ(0, io.seek(offset, BasicIo::beg));
+    ASSERT_EQ(sizeof(buf), io.read(buf, sizeof(buf)));
+    ASSERT_EQ(0, content.compare(offset, sizeof(buf), reinterpret_cast<const char*>(buf), sizeof(buf)));
+  }
+  ASSERT_EQ(3u, server.requests());  // HEAD and the GETs for the head and the tail, sent together
+  ASSERT_EQ(0, io.seek(500000, BasicIo::beg));
+  ASSERT_EQ(sizeof(buf), io.read(buf, sizeof(buf)));
+  ASSERT_EQ(4u, server.requests());
+}
+
+TEST(HttpIo, keepsWholeFileWhenRangesAreIgnored) {
+  const std::string content = makeContent(300000);
+  StandInServer::Options options;
+  options.ranges = false;
+  StandInServer server(content, options);
+  HttpIo io("http://127.0.0.1:" + server.port() + "/file");
+  ASSERT_EQ(0, io.open());
+  byte buf[10];
+  for (int64_t offset : {0, 250000, 100000, 299990}) {
+    ASSERT_EQ(0, io.seek(offset, BasicIo::beg));
+    ASSERT_EQ(sizeof(buf), io.read(buf, sizeof(buf)));
+    ASSERT_EQ(0, content.compare(offset, sizeof(buf), reinterpret_cast<const char*>(buf), sizeof(buf)));
+  }
+  ASSERT_EQ(3u, server.requests());  // HEAD and the GETs for the head and the tail
+}
+
+TEST(HttpIo, readsBlocksFromTheDiskCache) {
+  const std::string dir = (std::filesystem::temp_directory_path() / "exiv2-httpio-cache").string();
+  std::filesystem::remove_all(dir);
+  setenv("EXIV2_CACHE_DIR", dir.c_str(), 1);
+  StandInServer::Options options;
+  options.etag = "\"v1\"";
+  StandInServer server(readTestFile("exiv2-canon-powershot-s40.jpg") + std::string(500000, '\0'), options);
+  const std::string url = "http://127.0.0.1:" + server.port() + "/file";
+  expectSameExif("exiv2-canon-powershot-s40.jpg", url);
+  ASSERT_EQ(3u, server.requests());
+  expectSameExif("exiv2-canon-powershot-s40.jpg", url);
+  ASSERT_EQ(4u, server.requests());  // only HEAD, the blocks come from the cache
+  unsetenv("EXIV2_CACHE_DIR");
+  std::filesystem::remove_all(dir);
+}
+
+TEST(HttpClient, reportsMissingPagesAndServers) {
+  std::string port;
+  {
+    StandInServer server("content");
+    port = server.port();
+    HttpClient client("127.0.0.1", port);
+    Dictionary response;
+    std::string errors;
+    ASSERT_EQ(404, client.request("GET", "/missing", response, errors));
+    ASSERT_EQ("HTTP/1.1 404 Not Found", response[""]);
+  }
+  HttpClient client("127.0.0.1", port, 1000);
+  Dictionary response;
+  std::string errors;
+  ASSERT_EQ(-1, client.request("GET", "/file", response, errors));
+  ASSERT_FALSE(errors.empty());
+}
+#endif
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "makernote_int.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace Exiv2::Internal;
+
+namespace {
+//! Run a test in a temporary directory, where getExiv2ConfigPath() finds its configuration file
+class Exiv2ConfigTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    previous_ = fs::current_path();
+    directory_ = fs::temp_directory_path() / "exiv2_test_makernote_int";
+    fs::create_directories(directory_);
+    fs::current_path(directory_);
+  }
+
+  void TearDown() override {
+    fs::current_path(previous_);
+    fs::remove_all(directory_);
+  }
+
+  static void writeConfig(const std::string& value) {
+    std::ofstream(getExiv2ConfigPath()) << "[exiv2ConfigTest]\nvalue=" << value << "\n";
+  }
+
+  static void waitForCheck() {
+    // exiv2Config() checks the file at most once a second
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  }
+
+  fs::path previous_;
+  fs::path directory_;
+};
+}  // namespace
+
+TEST_F(Exiv2ConfigTest, readsTheFileAgainOnlyIfItsModificationTimeChanges) {
+  writeConfig("first");
+  waitForCheck();
+  ASSERT_EQ("first", readExiv2Config("exiv2ConfigTest", "value", "none"));
+
+  // a different content with the same modification time is not read
+  const auto mtime = fs::last_write_time(getExiv2ConfigPath());
+  writeConfig("second");
+  fs::last_write_time(getExiv2ConfigPath(), mtime);
+  ASSERT_EQ("first", readExiv2Config("exiv2ConfigTest", "value", "none"));
+  waitForCheck();
+  ASSERT_EQ("first", readExiv2Config("exiv2ConfigTest", "value", "none"));
+
+  fs::last_write_time(getExiv2ConfigPath(), mtime + std::chrono::seconds(2));
+  waitForCheck();
+  ASSERT_EQ("second", readExiv2Config("exiv2ConfigTest", "value", "none"));
+  ASSERT_EQ("none", readExiv2Config("exiv2ConfigTest", "missing", "none"));
+}
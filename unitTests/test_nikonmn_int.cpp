@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "exif.hpp"
+#include "nikonmn_int.hpp"
+
+#include <array>
+#include <cstring>
+
+using namespace Exiv2;
+using namespace Exiv2::Internal;
+
+#ifdef EXV_HAVE_LENSDATA
+namespace {
+//! The bytes of a lens which printLensId() compares: LensIDNumber, the NikonLd3 tags and LensType
+using LensId = std::array<byte, 8>;
+
+// Reference for the lens lookup with metadata: scan the whole database, as before the index
+std::string linearLensLookup(const Value& value, const LensId& raw) {
+  for (int i = 0; fmountLenses()[i].lensname; ++i) {
+    const FMntLens& pf = fmountLenses()[i];
+    if (raw[0] == pf.lid && (raw[1] == pf.stps || strcmp(pf.manuf, "Sigma") == 0) && raw[2] == pf.focs &&
+        raw[3] == pf.focl && raw[4] == pf.aps && raw[5] == pf.apl && raw[6] == pf.lfw && raw[7] == pf.ltype) {
+      return std::string(pf.manuf) + " " + pf.lensname;
+    }
+  }
+  return value.toString();
+}
+
+// Reference for the lens lookup without metadata: the first entry with the LensIDNumber before the first zero one
+std::string linearLensLookup(const Value& value) {
+  const auto vid = static_cast<unsigned char>(value.toInt64(0));
+  const FMntLens* pf = fmountLenses();
+  while (pf->lid && pf->lensname && pf->lid != vid) {
+    ++pf;
+  }
+  return pf->lid && pf->lensname ? std::string(pf->manuf) + " " + pf->lensname : value.toString();
+}
+
+std::string printLensId(const Value& value, const LensId& raw) {
+  static constexpr const char* tags[] = {
+      "LensIDNumber",          "LensFStops", "MinFocalLength", "MaxFocalLength", "MaxApertureAtMinFocal",
+      "MaxApertureAtMaxFocal", "MCUVersion",
+  };
+  ExifData metadata;
+  for (size_t i = 0; i < std::size(tags); ++i) {
+    auto byteValue = Value::create(unsignedByte);
+    byteValue->read(std::to_string(raw[i]));
+    metadata.add(ExifKey(std::string("Exif.NikonLd3.") + tags[i]), byteValue.get());
+  }
+  auto lensType = Value::create(unsignedByte);
+  lensType->read(std::to_string(raw[7]));
+  metadata.add(ExifKey("Exif.Nikon3.LensType"), lensType.get());
+  std::ostringstream os;
+  Nikon3MakerNote::printLensId(os, value, &metadata, "NikonLd3");
+  return os.str();
+}
+}  // namespace
+
+TEST(printLensId, findsTheSameLensAsTheLinearSearch) {
+  auto value = Value::create(unsignedByte);
+  value->read("0");
+  for (int i = 0; fmountLenses()[i].lensname; ++i) {
+    const FMntLens& pf = fmountLenses()[i];
+    LensId raw{pf.lid, pf.stps, pf.focs, pf.focl, pf.aps, pf.apl, pf.lfw, pf.ltype};
+    ASSERT_EQ(linearLensLookup(*value, raw), printLensId(*value, raw)) << pf.lensname;
+    // a different LensFStops, which only Sigma lenses ignore
+    raw[1] ^= 0x01;
+    ASSERT_EQ(linearLensLookup(*value, raw), printLensId(*value, raw)) << pf.lensname;
+    raw[1] ^= 0x01;
+    // a different LensType
+    raw[7] ^= 0x80;
+    ASSERT_EQ(linearLensLookup(*value, raw), printLensId(*value, raw)) << pf.lensname;
+  }
+}
+
+TEST(printLensId, findsTheSameLensIdAsTheLinearSearchWithoutMetadata) {
+  for (int id = 0; id < 256; ++id) {
+    auto value = Value::create(unsignedByte);
+    value->read(std::to_string(id));
+    std::ostringstream os;
+    Nikon3MakerNote::printLensId(os, *value, nullptr, "NikonLd3");
+    ASSERT_EQ(linearLensLookup(*value), os.str()) << id;
+  }
+}
+#endif
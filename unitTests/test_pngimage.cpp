@@ -4,6 +4,7 @@
 #include "pngchunk_int.hpp"  // This is not part of the public API
 
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 #include <algorithm>
 #include <array>
@@ -44,6 +45,39 @@ TEST(PngChunk, keyTxtChunkThrowsIfSizeIsNotEnough) {
   ASSERT_THROW(Internal::PngChunk::keyTXTChunk(emptyChunk, false), Exiv2::Error);
 }
 
+namespace {
+std::vector<byte> deflate(const std::string& text) {
+  uLongf size = compressBound(static_cast<uLong>(text.size()));
+  std::vector<byte> compressed(size);
+  compress(compressed.data(), &size, reinterpret_cast<const Bytef*>(text.data()), static_cast<uLong>(text.size()));
+  compressed.resize(size);
+  return compressed;
+}
+}  // namespace
+
+TEST(PngChunk, zlibInflateDecodesHighlyCompressedData) {
+  std::string text(1024 * 1024, 'a');
+  text += "end";
+  const auto compressed = deflate(text);
+  DataBuf result;
+  ASSERT_TRUE(Internal::PngChunk::zlibInflate(compressed.data(), compressed.size(), result, text.size()));
+  ASSERT_EQ(text, std::string(result.c_str(), result.size()));
+}
+
+TEST(PngChunk, zlibInflateFailsAboveMaxSize) {
+  const std::string text(100000, 'b');
+  const auto compressed = deflate(text);
+  DataBuf result;
+  ASSERT_FALSE(Internal::PngChunk::zlibInflate(compressed.data(), compressed.size(), result, text.size() - 1));
+}
+
+TEST(PngChunk, zlibInflateFailsOnTruncatedStream) {
+  const auto compressed = deflate("Some text which is long enough, long enough, long enough");
+  DataBuf result;
+  ASSERT_FALSE(Internal::PngChunk::zlibInflate(compressed.data(), compressed.size() - 4, result, 1024));
+  ASSERT_FALSE(Internal::PngChunk::zlibInflate(compressed.data(), 0, result, 1024));
+}
+
 TEST(PngImage, canBeCreatedFromScratch) {
   auto memIo = std::make_unique<MemIo>();
   const bool create{true};
@@ -133,6 +167,85 @@ TEST(PngImage, canWriteMetadataFromCreatedPngImage) {
   ASSERT_NO_THROW(png.writeMetadata());
 }
 
+namespace {
+std::string pngChunk(const std::string& type, const std::string& data) {
+  std::string chunk(4, '\0');
+  ul2Data(reinterpret_cast<byte*>(chunk.data()), static_cast<uint32_t>(data.size()), bigEndian);
+  chunk += type + data;
+  std::string crc(4, '\0');
+  ul2Data(reinterpret_cast<byte*>(crc.data()),
+          static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(chunk.data() + 4), type.size() + data.size())),
+          bigEndian);
+  return chunk + crc;
+}
+}  // namespace
+
+TEST(PngImage, writeMetadataKeepsImageDataAndChunksAfterIt) {
+  // Many small IDAT chunks, with a text chunk after them
+  std::string idat;
+  for (int i = 0; i < 500; ++i)
+    idat += pngChunk("IDAT", std::string(100 + i % 7, static_cast<char>(i)));
+  const std::string text = pngChunk("tEXt", std::string("Title\0A title", 13));
+  const std::string signature("\x89PNG\r\n\x1a\n");
+  const std::string ihdr = pngChunk("IHDR", std::string("\0\0\0\x01\0\0\0\x01\x08\x02\0\0\0", 13));
+  const std::string file = signature + ihdr + idat + text + pngChunk("IEND", "");
+
+  auto image = ImageFactory::open(reinterpret_cast<const byte*>(file.data()), file.size());
+  image->readMetadata();
+  image->setComment("A comment");
+  image->writeMetadata();
+
+  auto& io = image->io();
+  ASSERT_EQ(0, io.open());
+  DataBuf written = io.read(io.size());
+  io.close();
+  const std::string result(written.c_str(), written.size());
+  ASSERT_EQ(signature + ihdr, result.substr(0, 33));
+  ASSERT_NE(std::string::npos, result.find(idat + text));
+
+  image->readMetadata();
+  ASSERT_EQ("A comment", image->comment());
+}
+
+namespace {
+//! MemIo which counts the bytes read, a stand-in for a remote file
+class CountingMemIo : public MemIo {
+ public:
+  CountingMemIo(const byte* data, size_t size) : MemIo(data, size) {
+  }
+  DataBuf read(size_t rcount) override {
+    DataBuf buf = MemIo::read(rcount);
+    bytesRead_ += buf.size();
+    return buf;
+  }
+  size_t read(byte* buf, size_t rcount) override {
+    const size_t n = MemIo::read(buf, rcount);
+    bytesRead_ += n;
+    return n;
+  }
+  size_t bytesRead_{0};
+};
+}  // namespace
+
+TEST(PngImage, readMetadataSkipsLargeImageData) {
+  const std::string signature("\x89PNG\r\n\x1a\n");
+  const std::string ihdr = pngChunk("IHDR", std::string("\0\0\0\x01\0\0\0\x01\x08\x02\0\0\0", 13));
+  std::string idat;
+  for (int i = 0; i < 40; ++i)
+    idat += pngChunk("IDAT", std::string(64 * 1024 + i, static_cast<char>(i)));
+  const std::string text = pngChunk("tEXt", std::string("Description\0A comment", 21));
+  const std::string file = signature + ihdr + idat + text + pngChunk("IEND", "");
+
+  auto io = std::make_unique<CountingMemIo>(reinterpret_cast<const byte*>(file.data()), file.size());
+  const auto& counter = *io;
+  PngImage png(std::move(io), false);
+  png.readMetadata();
+  ASSERT_EQ("A comment", png.comment());
+  // one block at the start, the headers after the large chunks and the block with the text
+  ASSERT_LT(counter.bytesRead_, 3 * 64 * 1024 + 40 * 8);
+  ASSERT_LT(counter.bytesRead_, file.size() / 10);
+}
+
 TEST(PngImage, cannotWriteMetadataToIoWhichCannotBeOpened) {
   auto memIo = std::make_unique<FileIo>("NonExistingPath.png");
   const bool create{false};
@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/error.hpp>
+#include <exiv2/exif.hpp>
+#include <exiv2/image.hpp>
+#include <exiv2/iptc.hpp>
+#include <exiv2/properties.hpp>
+#include <exiv2/snapshot.hpp>
+#include <exiv2/xmp_exiv2.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace Exiv2;
+
+namespace {
+//! Compare the keys, types and values of two containers
+template <typename Data>
+void expectEqual(const Data& expected, const Data& actual) {
+  ASSERT_EQ(expected.count(), actual.count());
+  auto a = actual.begin();
+  for (auto&& e : expected) {
+    ASSERT_EQ(e.key(), a->key());
+    ASSERT_EQ(e.typeId(), a->typeId());
+    ASSERT_EQ(e.count(), a->count());
+    ASSERT_EQ(e.toString(), a->toString());
+    ++a;
+  }
+}
+}  // namespace
+
+TEST(SnapshotParser, roundTripsTheMetadataOfAnImage) {
+  auto image = ImageFactory::open(std::string(TESTDATA_PATH) + "/Reagan.jpg");
+  image->readMetadata();
+  image->setComment("a comment");
+  image->setIccProfile(DataBuf(reinterpret_cast<const byte*>("\0\0\0\x0cprofile!"), 12), false);
+  image->exifData()["Exif.Photo.UserComment"] = "charset=Ascii A user comment";
+  ASSERT_FALSE(image->exifData().empty());
+  ASSERT_FALSE(image->iptcData().empty());
+  ASSERT_FALSE(image->xmpData().empty());
+
+  Blob blob;
+  SnapshotParser::encode(blob, *image);
+  ExifData exifData;
+  IptcData iptcData;
+  XmpData xmpData;
+  DataBuf iccProfile;
+  std::string comment;
+  SnapshotParser::decode(exifData, iptcData, xmpData, iccProfile, comment, blob.data(), blob.size());
+
+  expectEqual(image->exifData(), exifData);
+  expectEqual(image->iptcData(), iptcData);
+  expectEqual(image->xmpData(), xmpData);
+  ASSERT_EQ(0, iccProfile.cmpBytes(0, image->iccProfile().c_data(), 12));
+  ASSERT_EQ("a comment", comment);
+
+  auto pos = exifData.begin();
+  for (auto&& exif : image->exifData()) {
+    ASSERT_EQ(exif.idx(), pos->idx());
+    ASSERT_EQ(exif.sizeDataArea(), pos->sizeDataArea());
+    ++pos;
+  }
+}
+
+TEST(SnapshotParser, keepsXmpTypesAndNamespaces) {
+  XmpProperties::registerNs("http://example.com/snapshot/", "snap");
+  XmpData xmpData;
+  xmpData["Xmp.snap.text"] = "text";
+  xmpData["Xmp.dc.subject"] = "one";
+  xmpData["Xmp.dc.subject"] = "two";
+  xmpData["Xmp.dc.title"] = "lang=de-DE Titel";
+  xmpData["Xmp.dc.title"] = "lang=x-default Title";
+  XmpTextValue structure;
+  structure.setXmpStruct();
+  xmpData.add(XmpKey("Xmp.snap.struct"), &structure);
+  xmpData["Xmp.snap.struct/snap:field"] = "value";
+
+  Blob blob;
+  SnapshotParser::encode(blob, ExifData(), IptcData(), xmpData, DataBuf(), "");
+  XmpProperties::unregisterNs("http://example.com/snapshot/");
+
+  ExifData exifData;
+  IptcData iptcData;
+  XmpData decoded;
+  DataBuf iccProfile;
+  std::string comment;
+  // namespaces are registered only if the whole snapshot is valid
+  ASSERT_THROW(SnapshotParser::decode(exifData, iptcData, decoded, iccProfile, comment, blob.data(), blob.size() - 1),
+               Error);
+  ASSERT_EQ("", XmpProperties::prefix("http://example.com/snapshot/"));
+  // and never take a prefix away from another namespace
+  XmpProperties::registerNs("http://example.com/other/", "snap");
+  ASSERT_THROW(SnapshotParser::decode(exifData, iptcData, decoded, iccProfile, comment, blob.data(), blob.size()),
+               Error);
+  ASSERT_EQ("http://example.com/other/", XmpProperties::ns("snap"));
+  XmpProperties::unregisterNs("http://example.com/other/");
+
+  SnapshotParser::decode(exifData, iptcData, decoded, iccProfile, comment, blob.data(), blob.size());
+  expectEqual(xmpData, decoded);
+  ASSERT_EQ("http://example.com/snapshot/", XmpProperties::ns("snap"));
+  const auto& value = dynamic_cast<const XmpValue&>(decoded["Xmp.snap.struct"].value());
+  ASSERT_EQ(XmpValue::xsStruct, value.xmpStruct());
+  ASSERT_EQ("Titel", dynamic_cast<const LangAltValue&>(decoded["Xmp.dc.title"].value()).toString("de-DE"));
+  XmpProperties::unregisterNs("http://example.com/snapshot/");
+}
+
+TEST(SnapshotParser, rejectsCorruptSnapshots) {
+  ExifData exifData;
+  exifData["Exif.Image.Make"] = "Canon";
+  Blob blob;
+  SnapshotParser::encode(blob, exifData, IptcData(), XmpData(), DataBuf(), "comment");
+
+  IptcData iptcData;
+  XmpData xmpData;
+  DataBuf iccProfile;
+  std::string comment = "unchanged";
+  for (size_t size = 0; size < blob.size(); ++size) {
+    ASSERT_THROW(SnapshotParser::decode(exifData, iptcData, xmpData, iccProfile, comment, blob.data(), size), Error);
+  }
+  ASSERT_EQ(1u, exifData.count());
+  ASSERT_EQ("unchanged", comment);
+
+  Blob other = blob;
+  other[8] = SnapshotParser::version_ + 1;
+  ASSERT_THROW(SnapshotParser::decode(exifData, iptcData, xmpData, iccProfile, comment, other.data(), other.size()),
+               Error);
+  other = blob;
+  other.push_back(0);
+  ASSERT_THROW(SnapshotParser::decode(exifData, iptcData, xmpData, iccProfile, comment, other.data(), other.size()),
+               Error);
+}
+
+TEST(SnapshotParser, decodesToAnImage) {
+  ExifData exifData;
+  exifData["Exif.Image.Make"] = "Canon";
+  XmpData xmpData;
+  xmpData["Xmp.dc.format"] = "image/jpeg";
+  Blob blob;
+  SnapshotParser::encode(blob, exifData, IptcData(), xmpData, DataBuf(), "comment");
+
+  auto image = ImageFactory::create(ImageType::jpeg);
+  SnapshotParser::decode(*image, blob.data(), blob.size());
+  ASSERT_EQ("Canon", image->exifData()["Exif.Image.Make"].toString());
+  ASSERT_EQ("image/jpeg", image->xmpData()["Xmp.dc.format"].toString());
+  ASSERT_EQ("comment", image->comment());
+  ASSERT_FALSE(image->iccProfileDefined());
+}
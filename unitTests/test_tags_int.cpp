@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "tags_int.hpp"
+#include "value.hpp"
+
+using namespace Exiv2;
+using namespace Exiv2::Internal;
+
+namespace {
+// Unsorted, with duplicate values, and large enough to be looked up through the index
+constexpr TagDetails testDetails[] = {
+    {20, "twenty"}, {3, "three"}, {17, "seventeen"}, {3, "three again"}, {-1, "minus one"}, {100, "hundred"},
+    {5, "five"},    {6, "six"},   {7, "seven"},      {8, "eight"},       {9, "nine"},       {10, "ten"},
+    {11, "eleven"}, {12, "12"},   {13, "13"},        {14, "14"},         {15, "15"},        {17, "17 again"},
+};
+
+constexpr TagVocabulary testVocabulary[] = {
+    {"PR-NON", "None"}, {"NON", "Suffix"},  {"PR-AAA", "A"},    {"PR-UPR", "Unlimited"}, {"PR-LPR", "Limited"},
+    {"PR-BBB", "B"},    {"PR-CCC", "C"},    {"PR-DDD", "D"},    {"PR-EEE", "E"},         {"PR-FFF", "F"},
+    {"PR-GGG", "G"},    {"PR-HHH", "H"},    {"PR-III", "I"},    {"PR-JJJ", "J"},         {"PR-KKK", "K"},
+    {"PR-NON", "Dup"},  {"X-PR-LPR", "XL"},
+};
+
+// Reference for the vocabulary lookup: first entry whose voc_ is a suffix of key
+const TagVocabulary* linearVocabulary(const std::string& key) {
+  for (auto&& tv : testVocabulary) {
+    const std::string voc(tv.voc_);
+    if (key.size() >= voc.size() && key.compare(key.size() - voc.size(), voc.size(), voc) == 0)
+      return &tv;
+  }
+  return nullptr;
+}
+}  // namespace
+
+TEST(findTagDetails, findsTheSameEntryAsTheLinearSearch) {
+  static_assert(std::size(testDetails) > tagLookupLinearMax);
+  for (int64_t value = -5; value < 120; ++value) {
+    ASSERT_EQ(find(testDetails, value), (EXV_FIND_TAG_DETAILS(testDetails)(value))) << value;
+  }
+  ASSERT_STREQ("three", (EXV_FIND_TAG_DETAILS(testDetails)(3))->label_);
+  ASSERT_STREQ("seventeen", (EXV_FIND_TAG_DETAILS(testDetails)(17))->label_);
+  ASSERT_EQ(nullptr, (EXV_FIND_TAG_DETAILS(testDetails)(4)));
+}
+
+TEST(findTagVocabulary, findsTheSameEntryAsTheLinearSearch) {
+  static_assert(std::size(testVocabulary) > tagLookupLinearMax);
+  for (const std::string key : {"PR-NON", "NON", "http://ns.useplus.org/ldf/vocab/PR-NON", "xNON", "PR-LPR",
+                                "X-PR-LPR", "http://ns.useplus.org/ldf/vocab/X-PR-LPR", "PR-ZZZ", "", "ON"}) {
+    ASSERT_EQ(linearVocabulary(key), (findTagVocabulary<std::size(testVocabulary), testVocabulary>(key)))
+        << key;
+  }
+  ASSERT_STREQ("None", (findTagVocabulary<std::size(testVocabulary), testVocabulary>("PR-NON")->label_));
+}
+
+TEST(printTagVocabulary, usesTheTextOfXmpValues) {
+  XmpTextValue value("http://ns.useplus.org/ldf/vocab/PR-UPR");
+  std::ostringstream os;
+  EXV_PRINT_VOCABULARY(testVocabulary)(os, value, nullptr);
+  ASSERT_EQ("Unlimited", os.str());
+
+  XmpTextValue unknown("PR-ZZZ");
+  os.str("");
+  EXV_PRINT_VOCABULARY(testVocabulary)(os, unknown, nullptr);
+  ASSERT_EQ("(PR-ZZZ)", os.str());
+}